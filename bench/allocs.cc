@@ -0,0 +1,64 @@
+/*
+ * Replacement for the global operator new that counts allocations in
+ * dballe::benchmark::allocation_count.
+ *
+ * Link it into benchmark programs to have allocation counts in their results.
+ */
+#include <dballe/core/benchmark.h>
+#include <new>
+#include <cstdlib>
+
+void* operator new(std::size_t size)
+{
+    ++dballe::benchmark::allocation_count;
+    if (size == 0)
+        size = 1;
+    while (true)
+    {
+        if (void* res = malloc(size))
+            return res;
+        std::new_handler handler = std::get_new_handler();
+        if (!handler)
+            throw std::bad_alloc();
+        handler();
+    }
+}
+
+void* operator new[](std::size_t size)
+{
+    return operator new(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+    try {
+        return operator new(size);
+    } catch (...) {
+        return nullptr;
+    }
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept
+{
+    return operator new(size, std::nothrow);
+}
+
+void operator delete(void* ptr) noexcept
+{
+    free(ptr);
+}
+
+void operator delete[](void* ptr) noexcept
+{
+    free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept
+{
+    free(ptr);
+}
+
+void operator delete[](void* ptr, std::size_t) noexcept
+{
+    free(ptr);
+}
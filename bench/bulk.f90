@@ -0,0 +1,132 @@
+      program bulk
+
+! *****************************************************************
+! * Bulk insert and query loops using the DB-All.e Fortran bindings
+! *****************************************************************
+!
+! The database URL is taken from DBA_DB, and defaults to a SQLite file in
+! the current directory.
+!
+! For each phase, prints a line with its name, the number of values
+! processed and the elapsed time in seconds.
+
+      use dballef
+
+      integer, parameter :: nstations = 50, ndays = 10, nhours = 24
+      integer :: dbahandle, handle, ierr, i, j, k, count, total
+      integer (kind=8) :: t_start, t_end, rate
+      character (len=255) :: url
+      character (len=10) :: param
+      real :: rval
+
+      call getenv("DBA_DB", url)
+      if (url == "") then
+        url = "sqlite:bench-bulk.sqlite"
+      end if
+      if (index(url, "?") == 0) then
+        url = trim(url) // "?wipe=1"
+      else
+        url = trim(url) // "&wipe=1"
+      end if
+
+      ierr = idba_presentati(dbahandle, url)
+      call check(ierr, "presentati")
+
+!     Insert loop: one value at a time, committed at the end
+      ierr = idba_preparati(dbahandle, handle, "write", "write", "write")
+      call check(ierr, "preparati write")
+      ierr = idba_scopa(handle, "")
+      call check(ierr, "scopa")
+
+      total = 0
+      call system_clock(t_start, rate)
+      do i = 1, nstations
+        do j = 1, ndays
+          do k = 0, nhours - 1
+            ierr = idba_unsetall(handle)
+            ierr = idba_setd(handle, "lat", 40D0 + i * 0.1D0)
+            ierr = idba_setd(handle, "lon", 10D0 + i * 0.1D0)
+            ierr = idba_setc(handle, "rep_memo", "synop")
+            ierr = idba_setdate(handle, 2016, 1, j, k, 0, 0)
+            ierr = idba_setlevel(handle, 103, 2000, DBA_MVI, DBA_MVI)
+            ierr = idba_settimerange(handle, 254, 0, 0)
+            ierr = idba_setr(handle, "B12101", 273.15 + k)
+            ierr = idba_setr(handle, "B12103", 270.15 + k)
+            ierr = idba_prendilo(handle)
+            call check(ierr, "prendilo")
+            total = total + 2
+          end do
+        end do
+      end do
+      ierr = idba_fatto(handle)
+      call check(ierr, "fatto write")
+      call system_clock(t_end)
+      call report("fortran_insert", total, t_start, t_end, rate)
+
+!     Query loop: read back all values
+      ierr = idba_preparati(dbahandle, handle, "read", "read", "read")
+      call check(ierr, "preparati read")
+
+      total = 0
+      call system_clock(t_start)
+      ierr = idba_voglioquesto(handle, count)
+      call check(ierr, "voglioquesto")
+      do i = 1, count
+        ierr = idba_dammelo(handle, param)
+        call check(ierr, "dammelo")
+        ierr = idba_enqr(handle, param, rval)
+        total = total + 1
+      end do
+      ierr = idba_fatto(handle)
+      call check(ierr, "fatto read")
+      call system_clock(t_end)
+      call report("fortran_query", total, t_start, t_end, rate)
+
+!     Filtered query loop: one query per station
+      ierr = idba_preparati(dbahandle, handle, "read", "read", "read")
+      call check(ierr, "preparati read filtered")
+
+      total = 0
+      call system_clock(t_start)
+      do i = 1, nstations
+        ierr = idba_unsetall(handle)
+        ierr = idba_setd(handle, "lat", 40D0 + i * 0.1D0)
+        ierr = idba_setd(handle, "lon", 10D0 + i * 0.1D0)
+        ierr = idba_setc(handle, "var", "B12101")
+        ierr = idba_voglioquesto(handle, count)
+        call check(ierr, "voglioquesto filtered")
+        do j = 1, count
+          ierr = idba_dammelo(handle, param)
+          call check(ierr, "dammelo filtered")
+          total = total + 1
+        end do
+      end do
+      ierr = idba_fatto(handle)
+      call check(ierr, "fatto read filtered")
+      call system_clock(t_end)
+      call report("fortran_query_station", total, t_start, t_end, rate)
+
+      ierr = idba_arrivederci(dbahandle)
+      call check(ierr, "arrivederci")
+
+      call exit (0)
+
+      contains
+
+      subroutine check(ierr, msg)
+      integer, intent(in) :: ierr
+      character (len=*), intent(in) :: msg
+        if (ierr /= 0) then
+          print *, msg, ": error ", ierr
+          call exit (1)
+        end if
+      end subroutine check
+
+      subroutine report(name, items, t_start, t_end, rate)
+      character (len=*), intent(in) :: name
+      integer, intent(in) :: items
+      integer (kind=8), intent(in) :: t_start, t_end, rate
+        write (*, '(A, " ", I0, " ", F0.6)') name, items, real(t_end - t_start, 8) / real(rate, 8)
+      end subroutine report
+
+      end program
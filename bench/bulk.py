@@ -0,0 +1,126 @@
+#!/usr/bin/env python3
+"""
+Bulk insert and query loops using the DB-All.e Python bindings.
+
+The database URL is taken from DBA_DB, and defaults to a SQLite file in the
+current directory. Results are written as JSON in the same format as the C++
+benchmark programs.
+"""
+import argparse
+import datetime
+import json
+import os
+import resource
+import sys
+import time
+
+import dballe
+
+
+NSTATIONS = 50
+NDAYS = 10
+NHOURS = 24
+
+
+class Phase:
+    def __init__(self, name):
+        self.name = name
+        self.items = 0
+
+    def __enter__(self):
+        self.res_at_start = resource.getrusage(resource.RUSAGE_SELF)
+        self.time_at_start = time.perf_counter()
+        return self
+
+    def __exit__(self, exc_type, exc_value, traceback):
+        self.wall_time = time.perf_counter() - self.time_at_start
+        self.res_at_end = resource.getrusage(resource.RUSAGE_SELF)
+
+    def to_json(self):
+        return {
+            "name": self.name,
+            "type": "timeit",
+            "failed": False,
+            "runs": 1,
+            "wall_time": self.wall_time,
+            "user_time": self.res_at_end.ru_utime - self.res_at_start.ru_utime,
+            "system_time": self.res_at_end.ru_stime - self.res_at_start.ru_stime,
+            "max_rss": self.res_at_end.ru_maxrss,
+            "items": self.items,
+            "items_per_second": self.items / self.wall_time if self.wall_time > 0 else 0.0,
+        }
+
+
+def station_coords(idx):
+    return 40.0 + idx * 0.1, 10.0 + idx * 0.1
+
+
+def run(db):
+    phases = []
+
+    with Phase("python_insert") as phase:
+        with db.transaction() as tr:
+            for station in range(1, NSTATIONS + 1):
+                lat, lon = station_coords(station)
+                for day in range(1, NDAYS + 1):
+                    for hour in range(NHOURS):
+                        tr.insert_data({
+                            "lat": lat, "lon": lon, "rep_memo": "synop",
+                            "datetime": datetime.datetime(2016, 1, day, hour),
+                            "level": (103, 2000, None, None),
+                            "trange": (254, 0, 0),
+                            "B12101": 273.15 + hour,
+                            "B12103": 270.15 + hour,
+                        }, False, True)
+                        phase.items += 2
+    phases.append(phase)
+
+    with Phase("python_query") as phase:
+        with db.transaction() as tr:
+            for row in tr.query_data():
+                row["variable"]
+                phase.items += 1
+    phases.append(phase)
+
+    with Phase("python_query_station") as phase:
+        with db.transaction() as tr:
+            for station in range(1, NSTATIONS + 1):
+                lat, lon = station_coords(station)
+                for row in tr.query_data({"lat": lat, "lon": lon, "var": "B12101"}):
+                    row["variable"]
+                    phase.items += 1
+    phases.append(phase)
+
+    with Phase("python_query_messages") as phase:
+        with db.transaction() as tr:
+            for row in tr.query_messages():
+                row.message
+                phase.items += 1
+    phases.append(phase)
+
+    return phases
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Run bulk loops through the DB-All.e Python bindings.")
+    parser.add_argument("--json", metavar="file", help="write JSON results to this file instead of stdout")
+    args = parser.parse_args()
+
+    url = os.environ.get("DBA_DB") or "sqlite:bench-bulk.sqlite"
+    db = dballe.DB.connect(url)
+    db.reset()
+
+    phases = run(db)
+
+    res = {"suite": "python", "tasks": [p.to_json() for p in phases]}
+    if args.json:
+        with open(args.json, "wt") as fd:
+            json.dump(res, fd)
+            print(file=fd)
+    else:
+        json.dump(res, sys.stdout)
+        print()
+
+
+if __name__ == "__main__":
+    main()
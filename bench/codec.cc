@@ -0,0 +1,185 @@
+#include <dballe/file.h>
+#include <dballe/importer.h>
+#include <dballe/exporter.h>
+#include <dballe/core/benchmark.h>
+#include <dballe/msg/msg.h>
+#include <wreport/bulletin.h>
+#include <vector>
+
+struct BenchmarkDecode : public dballe::benchmark::Task
+{
+    std::vector<dballe::BinaryMessage> raw;
+    std::unique_ptr<dballe::Importer> importer;
+    std::string m_name;
+    const char* m_pathname;
+    dballe::Encoding encoding;
+    unsigned copies;
+
+    BenchmarkDecode(const std::string& name, const char* pathname, dballe::Encoding encoding=dballe::Encoding::BUFR, unsigned copies=100)
+        : m_name("decode_" + name), m_pathname(pathname), encoding(encoding), copies(copies)
+    {
+    }
+
+    const char* name() const override { return m_name.c_str(); }
+
+    void setup() override
+    {
+        importer = dballe::Importer::create(encoding, "accurate");
+        auto in = dballe::File::create(encoding, m_pathname, "rb");
+        std::vector<dballe::BinaryMessage> file;
+        in->foreach([&](const dballe::BinaryMessage& rmsg) {
+            file.push_back(rmsg);
+            return true;
+        });
+
+        // Repeat the file contents to have enough data to measure
+        for (unsigned i = 0; i < copies; ++i)
+            raw.insert(raw.end(), file.begin(), file.end());
+    }
+
+    void run_once() override
+    {
+        for (const auto& rmsg: raw)
+            importer->foreach_decoded(rmsg, [&](std::unique_ptr<dballe::Message>) { ++items; return true; });
+    }
+
+    void teardown() override
+    {
+        raw.clear();
+        importer.reset();
+    }
+};
+
+/**
+ * Interpret bulletins that have already been decoded, to measure only the
+ * mapping of BUFR/CREX variables to message contents
+ */
+struct BenchmarkInterpret : public dballe::benchmark::Task
+{
+    std::vector<std::unique_ptr<wreport::Bulletin>> bulletins;
+    std::unique_ptr<dballe::Importer> importer;
+    std::string m_name;
+    const char* m_pathname;
+    dballe::Encoding encoding;
+    unsigned copies;
+
+    BenchmarkInterpret(const std::string& name, const char* pathname, dballe::Encoding encoding=dballe::Encoding::BUFR, unsigned copies=100)
+        : m_name("interpret_" + name), m_pathname(pathname), encoding(encoding), copies(copies)
+    {
+    }
+
+    const char* name() const override { return m_name.c_str(); }
+
+    void setup() override
+    {
+        importer = dballe::Importer::create(encoding, "accurate");
+        auto in = dballe::File::create(encoding, m_pathname, "rb");
+        std::vector<dballe::BinaryMessage> file;
+        in->foreach([&](const dballe::BinaryMessage& rmsg) {
+            file.push_back(rmsg);
+            return true;
+        });
+
+        // Repeat the file contents to have enough data to measure
+        for (unsigned i = 0; i < copies; ++i)
+            for (const auto& rmsg: file)
+            {
+                if (encoding == dballe::Encoding::BUFR)
+                    bulletins.emplace_back(wreport::BufrBulletin::decode(rmsg.data, rmsg.pathname.c_str(), rmsg.offset));
+                else
+                    bulletins.emplace_back(wreport::CrexBulletin::decode(rmsg.data, rmsg.pathname.c_str(), rmsg.offset));
+            }
+    }
+
+    void run_once() override
+    {
+        for (const auto& bulletin: bulletins)
+            items += importer->from_bulletin(*bulletin).size();
+    }
+
+    void teardown() override
+    {
+        bulletins.clear();
+        importer.reset();
+    }
+};
+
+struct BenchmarkEncode : public dballe::benchmark::Task
+{
+    dballe::benchmark::Messages messages;
+    std::unique_ptr<dballe::Exporter> exporter;
+    std::string m_name;
+    const char* m_pathname;
+    dballe::Encoding encoding;
+    std::string template_name;
+    unsigned copies;
+
+    BenchmarkEncode(const std::string& name, const char* pathname, dballe::Encoding encoding=dballe::Encoding::BUFR, const char* template_name="", unsigned copies=100)
+        : m_name("encode_" + name), m_pathname(pathname), encoding(encoding), template_name(template_name), copies(copies)
+    {
+    }
+
+    const char* name() const override { return m_name.c_str(); }
+
+    void setup() override
+    {
+        auto opts = dballe::ExporterOptions::create();
+        opts->template_name = template_name;
+        exporter = dballe::Exporter::create(encoding, *opts);
+        messages.load(m_pathname, encoding);
+
+        // Repeat the file contents to have enough data to measure
+        size_t size = messages.size();
+        for (unsigned i = 1; i < copies; ++i)
+            messages.duplicate(size, dballe::Datetime());
+    }
+
+    void run_once() override
+    {
+        for (const auto& msgs: messages)
+        {
+            exporter->to_binary(msgs);
+            ++items;
+        }
+    }
+
+    void teardown() override
+    {
+        messages.clear();
+        exporter.reset();
+    }
+};
+
+int main(int argc, const char* argv[])
+{
+    using namespace dballe::benchmark;
+    dballe::benchmark::Task* tasks[] = {
+        new BenchmarkDecode("synop", "extra/bufr/synop-rad1.bufr"),
+        new BenchmarkDecode("temp", "extra/bufr/temp-huge.bufr", dballe::Encoding::BUFR, 5),
+        new BenchmarkDecode("acars", "extra/bufr/gts-acars2.bufr"),
+        new BenchmarkDecode("crex", "extra/crex/test-temp0.crex", dballe::Encoding::CREX),
+        new BenchmarkDecode("json", "extra/json/issue134.json", dballe::Encoding::JSON),
+        new BenchmarkInterpret("synop", "extra/bufr/synop-rad1.bufr"),
+        new BenchmarkInterpret("ship", "extra/bufr/obs1-13.36.bufr", dballe::Encoding::BUFR, 1000),
+        new BenchmarkInterpret("temp", "extra/bufr/temp-huge.bufr", dballe::Encoding::BUFR, 5),
+        new BenchmarkInterpret("acars", "extra/bufr/gts-acars2.bufr"),
+        new BenchmarkEncode("synop", "extra/bufr/synop-rad1.bufr", dballe::Encoding::BUFR, "synop-wmo"),
+        new BenchmarkEncode("temp", "extra/bufr/temp-huge.bufr", dballe::Encoding::BUFR, "temp-wmo", 5),
+        new BenchmarkEncode("acars", "extra/bufr/gts-acars2.bufr", dballe::Encoding::BUFR, "acars-wmo"),
+        new BenchmarkEncode("crex", "extra/crex/test-temp0.crex", dballe::Encoding::CREX),
+        new BenchmarkEncode("json", "extra/json/issue134.json", dballe::Encoding::JSON),
+    };
+
+    Options options(argc, argv);
+    Benchmark benchmark;
+    dballe::benchmark::Whitelist whitelist(argc, argv);
+
+    for (auto task: tasks)
+        if (whitelist.has(task->name()))
+            benchmark.throughput(*task, 2.0);
+
+    benchmark.print_timings();
+    if (!options.json_output.empty())
+        benchmark.write_json(options.json_output, "codec");
+    return 0;
+}
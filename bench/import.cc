@@ -40,7 +40,10 @@ struct BenchmarkImport : public dballe::benchmark::Task
     {
         auto tr = db->transaction();
         for (const auto& msgs: messages)
+        {
             tr->import_messages(msgs);
+            ++items;
+        }
         tr->commit();
     }
 
@@ -59,6 +62,7 @@ int main(int argc, const char* argv[])
         new BenchmarkImport("acars", "extra/bufr/gts-acars2.bufr", 24, 15),
     };
 
+    Options options(argc, argv);
     Benchmark benchmark;
     dballe::benchmark::Whitelist whitelist(argc, argv);
 
@@ -67,5 +71,7 @@ int main(int argc, const char* argv[])
             benchmark.timeit(*task);
 
     benchmark.print_timings();
+    if (!options.json_output.empty())
+        benchmark.write_json(options.json_output, "import");
     return 0;
 }
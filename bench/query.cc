@@ -1,27 +1,30 @@
 #include <dballe/db/db.h>
+#include <dballe/db/explorer.h>
 #include <dballe/file.h>
+#include <dballe/exporter.h>
 #include <dballe/core/benchmark.h>
 #include <dballe/core/query.h>
 #include <dballe/msg/msg.h>
 #include <vector>
 
-struct BenchmarkQuery : public dballe::benchmark::Task
+/// Base for tasks that query a database filled with copies of a sample file
+struct BenchmarkDBTask : public dballe::benchmark::Task
 {
     std::shared_ptr<dballe::db::DB> db;
-    const char* m_name;
+    std::string m_name;
     const char* m_pathname;
     unsigned months;
     unsigned hours;
     unsigned minutes;
 
-    BenchmarkQuery(const char* name, const char* pathname, unsigned months=12, unsigned hours=24, unsigned minutes=1)
+    BenchmarkDBTask(const std::string& name, const char* pathname, unsigned months=12, unsigned hours=24, unsigned minutes=1)
         : m_name(name), m_pathname(pathname), months(months), hours(hours), minutes(minutes)
     {
         auto options = dballe::DBConnectOptions::test_create();
         db = dballe::db::DB::downcast(dballe::DB::connect(*options));
     }
 
-    const char* name() const override { return m_name; }
+    const char* name() const override { return m_name.c_str(); }
 
     void setup() override
     {
@@ -43,19 +46,150 @@ struct BenchmarkQuery : public dballe::benchmark::Task
         tr->commit();
     }
 
+    void teardown() override
+    {
+        db->remove_all();
+    }
+
+    std::shared_ptr<dballe::db::Transaction> transaction()
+    {
+        return std::dynamic_pointer_cast<dballe::db::Transaction>(db->transaction());
+    }
+};
+
+/// Iterate the results of query_data
+struct BenchmarkQuery : public BenchmarkDBTask
+{
+    dballe::core::Query query;
+
+    BenchmarkQuery(const std::string& name, const char* pathname, const char* query, unsigned months=12, unsigned hours=24, unsigned minutes=1)
+        : BenchmarkDBTask(name, pathname, months, hours, minutes)
+    {
+        this->query.set_from_test_string(query);
+    }
+
     void run_once() override
     {
-        auto tr = std::dynamic_pointer_cast<dballe::db::Transaction>(db->transaction());
-        dballe::core::Query query;
+        auto tr = transaction();
         auto cur = tr->query_data(query);
         while (cur->next())
-            ;
+            ++items;
         tr->commit();
     }
+};
+
+/// Iterate the results of query_messages, optionally encoding them
+struct BenchmarkQueryMessages : public BenchmarkDBTask
+{
+    std::unique_ptr<dballe::Exporter> exporter;
+    bool encode;
+
+    BenchmarkQueryMessages(const std::string& name, const char* pathname, bool encode, unsigned months=12, unsigned hours=24, unsigned minutes=1)
+        : BenchmarkDBTask(name, pathname, months, hours, minutes), encode(encode)
+    {
+        if (encode)
+            exporter = dballe::Exporter::create(dballe::Encoding::BUFR);
+    }
+
+    void run_once() override
+    {
+        auto tr = transaction();
+        dballe::core::Query query;
+        auto cur = tr->query_messages(query);
+        std::vector<std::shared_ptr<dballe::Message>> msgs(1);
+        while (cur->next())
+        {
+            if (encode)
+            {
+                msgs[0] = cur->detach_message();
+                exporter->to_binary(msgs);
+            }
+            ++items;
+        }
+        tr->commit();
+    }
+};
+
+/// Iterate the results of query_summary
+struct BenchmarkSummary : public BenchmarkDBTask
+{
+    dballe::core::Query query;
+
+    BenchmarkSummary(const std::string& name, const char* pathname, const char* query, unsigned months=12, unsigned hours=24, unsigned minutes=1)
+        : BenchmarkDBTask(name, pathname, months, hours, minutes)
+    {
+        this->query.set_from_test_string(query);
+    }
+
+    void run_once() override
+    {
+        auto tr = transaction();
+        auto cur = tr->query_summary(query);
+        while (cur->next())
+            ++items;
+        tr->commit();
+    }
+};
+
+/// Rebuild an Explorer from the database
+struct BenchmarkExplorerRebuild : public BenchmarkDBTask
+{
+    using BenchmarkDBTask::BenchmarkDBTask;
+
+    void run_once() override
+    {
+        auto tr = transaction();
+        dballe::db::Explorer explorer;
+        {
+            auto update = explorer.rebuild();
+            update.add_db(*tr);
+        }
+        tr->commit();
+        explorer.global_summary().stations([&](const dballe::Station&) { ++items; return true; });
+    }
+};
+
+/// Change filters on an Explorer
+struct BenchmarkExplorerFilter : public BenchmarkDBTask
+{
+    std::vector<dballe::core::Query> filters;
+    std::unique_ptr<dballe::db::Explorer> explorer;
+
+    BenchmarkExplorerFilter(const std::string& name, const char* pathname, const std::vector<const char*>& filters, unsigned months=12, unsigned hours=24, unsigned minutes=1)
+        : BenchmarkDBTask(name, pathname, months, hours, minutes)
+    {
+        for (const auto& f: filters)
+        {
+            this->filters.emplace_back();
+            this->filters.back().set_from_test_string(f);
+        }
+    }
+
+    void setup() override
+    {
+        BenchmarkDBTask::setup();
+        explorer.reset(new dballe::db::Explorer);
+        auto tr = transaction();
+        {
+            auto update = explorer->rebuild();
+            update.add_db(*tr);
+        }
+        tr->commit();
+    }
+
+    void run_once() override
+    {
+        for (const auto& f: filters)
+        {
+            explorer->set_filter(f);
+            explorer->active_summary().stations([&](const dballe::Station&) { ++items; return true; });
+        }
+    }
 
     void teardown() override
     {
-        db->remove_all();
+        explorer.reset();
+        BenchmarkDBTask::teardown();
     }
 };
 
@@ -63,11 +197,28 @@ int main(int argc, const char* argv[])
 {
     using namespace dballe::benchmark;
     dballe::benchmark::Task* tasks[] = {
-        new BenchmarkQuery("synop", "extra/bufr/synop-rad1.bufr", 1, 24),
-        new BenchmarkQuery("temp", "extra/bufr/temp-huge.bufr", 1, 1),
-        new BenchmarkQuery("acars", "extra/bufr/gts-acars2.bufr", 12, 24, 10),
+        new BenchmarkQuery("synop", "extra/bufr/synop-rad1.bufr", "", 1, 24),
+        new BenchmarkQuery("temp", "extra/bufr/temp-huge.bufr", "", 1, 1),
+        new BenchmarkQuery("acars", "extra/bufr/gts-acars2.bufr", "", 12, 24, 10),
+        new BenchmarkQuery("synop_var", "extra/bufr/synop-rad1.bufr", "var=B12101", 1, 24),
+        new BenchmarkQuery("synop_datetime", "extra/bufr/synop-rad1.bufr", "yearmin=2016, monthmin=1, daymin=1, hourmin=6, yearmax=2016, monthmax=1, daymax=1, hourmax=12", 1, 24),
+        new BenchmarkQuery("synop_var_datetime", "extra/bufr/synop-rad1.bufr", "var=B12101, yearmin=2016, monthmin=1, daymin=1, hourmin=6, yearmax=2016, monthmax=1, daymax=1, hourmax=12", 1, 24),
+        new BenchmarkQuery("synop_area", "extra/bufr/synop-rad1.bufr", "latmin=40.0, latmax=46.0, lonmin=5.0, lonmax=15.0", 1, 24),
+        new BenchmarkQuery("synop_level", "extra/bufr/synop-rad1.bufr", "leveltype1=103, l1=2000", 1, 24),
+        new BenchmarkQuery("synop_best", "extra/bufr/synop-rad1.bufr", "query=best", 1, 24),
+        new BenchmarkQuery("acars_best", "extra/bufr/gts-acars2.bufr", "query=best", 1, 24, 10),
+        new BenchmarkQueryMessages("synop_messages", "extra/bufr/synop-rad1.bufr", false, 1, 24),
+        new BenchmarkQueryMessages("synop_export", "extra/bufr/synop-rad1.bufr", true, 1, 24),
+        new BenchmarkQueryMessages("temp_export", "extra/bufr/temp-huge.bufr", true, 1, 1),
+        new BenchmarkSummary("synop_summary", "extra/bufr/synop-rad1.bufr", "", 1, 24),
+        new BenchmarkSummary("synop_summary_var", "extra/bufr/synop-rad1.bufr", "var=B12101", 1, 24),
+        new BenchmarkSummary("synop_summary_var_datetime", "extra/bufr/synop-rad1.bufr", "var=B12101, yearmin=2016, monthmin=1, daymin=1, hourmin=6, yearmax=2016, monthmax=1, daymax=1, hourmax=12", 1, 24),
+        new BenchmarkExplorerRebuild("synop_explorer_rebuild", "extra/bufr/synop-rad1.bufr", 1, 24),
+        new BenchmarkExplorerFilter("synop_explorer_filter", "extra/bufr/synop-rad1.bufr", {
+                "rep_memo=synop", "var=B12101", "leveltype1=103, l1=2000", "latmin=40.0, latmax=46.0, lonmin=5.0, lonmax=15.0", ""}, 1, 24),
     };
 
+    Options options(argc, argv);
     Benchmark benchmark;
     dballe::benchmark::Whitelist whitelist(argc, argv);
 
@@ -76,6 +227,7 @@ int main(int argc, const char* argv[])
             benchmark.timeit(*task, 20);
 
     benchmark.print_timings();
+    if (!options.json_output.empty())
+        benchmark.write_json(options.json_output, "query");
     return 0;
 }
-
@@ -5,6 +5,8 @@
 #include "dballe/core/arrayfile.h"
 #include "dballe/msg/msg.h"
 #include "config.h"
+#include <wreport/bulletin.h>
+#include <wreport/utils/sys.h>
 
 using namespace dballe;
 using namespace dballe::cmdline;
@@ -90,6 +92,210 @@ this->add_method("issue62", [](Fixture& f) {
     wassert(actual(msg->get_datetime()) == Datetime(2016, 3, 14, 23, 0, 4));
 });
 
+this->add_method("export_jobs", [](Fixture& f) {
+    Dbadb dbadb(*f.db);
+
+    cmdline::ReaderOptions opts;
+    cmdline::Reader reader(opts);
+    wassert(actual(dbadb.do_import(dballe::tests::datafile("bufr/synop-rad1.bufr"), reader, DBImportOptions::defaults)) == 0);
+    wassert(actual(dbadb.do_import(dballe::tests::datafile("bufr/gts-acars2.bufr"), reader, DBImportOptions::defaults)) == 0);
+
+    core::Query query;
+    core::ArrayFile serial(Encoding::BUFR);
+    wassert(actual(dbadb.do_export(query, serial, "", nullptr)) == 0);
+    wassert(actual(serial.msgs.size()) > 10u);
+
+    // Parallel encoding gives the same results in the same order
+    core::ArrayFile parallel(Encoding::BUFR);
+    wassert(actual(dbadb.do_export(query, parallel, "", nullptr, 4)) == 0);
+    wassert(actual(parallel.msgs.size()) == serial.msgs.size());
+    for (unsigned i = 0; i < serial.msgs.size(); ++i)
+        wassert(actual(parallel.msgs[i].data) == serial.msgs[i].data);
+});
+
+this->add_method("export_subsets", [](Fixture& f) {
+    Dbadb dbadb(*f.db);
+
+    cmdline::ReaderOptions opts;
+    cmdline::Reader reader(opts);
+    wassert(actual(dbadb.do_import(dballe::tests::datafile("bufr/synop-rad1.bufr"), reader, DBImportOptions::defaults)) == 0);
+    wassert(actual(dbadb.do_import(dballe::tests::datafile("bufr/gts-acars2.bufr"), reader, DBImportOptions::defaults)) == 0);
+
+    core::Query query;
+    core::ArrayFile single(Encoding::BUFR);
+    wassert(actual(dbadb.do_export(query, single, "", nullptr)) == 0);
+
+    // Consecutive messages of the same type are grouped in one bulletin
+    dbadb.subsets = 50;
+    core::ArrayFile grouped(Encoding::BUFR);
+    wassert(actual(dbadb.do_export(query, grouped, "", nullptr)) == 0);
+    wassert(actual(grouped.msgs.size()) < single.msgs.size());
+
+    // Grouping works the same with parallel encoding
+    core::ArrayFile parallel(Encoding::BUFR);
+    wassert(actual(dbadb.do_export(query, parallel, "", nullptr, 4)) == 0);
+    wassert(actual(parallel.msgs.size()) == grouped.msgs.size());
+    for (unsigned i = 0; i < grouped.msgs.size(); ++i)
+        wassert(actual(parallel.msgs[i].data) == grouped.msgs[i].data);
+
+    // The bulletins decode to the same messages, in the same order
+    auto importer = Importer::create(Encoding::BUFR);
+    impl::Messages expected;
+    for (const auto& bm: single.msgs)
+        for (const auto& msg: importer->from_binary(bm))
+            expected.emplace_back(msg);
+    impl::Messages decoded;
+    bool compressed = false;
+    for (const auto& bm: grouped.msgs)
+    {
+        auto bulletin = BufrBulletin::decode(bm.data);
+        if (bulletin->compression)
+            compressed = true;
+        for (const auto& msg: importer->from_binary(bm))
+            decoded.emplace_back(msg);
+    }
+    wassert_true(compressed);
+    wassert(actual(impl::msg::messages_diff(expected, decoded)) == 0);
+});
+
+this->add_method("export_subsets_templates", [](Fixture& f) {
+    // Messages of the same type for which the autodetected template changes
+    // from one message to the next
+    impl::Messages msgs;
+    auto add_common = [&](MessageType type, const char* rep_memo, int station) {
+        auto msg = make_shared<impl::Message>();
+        msg->type = type;
+        msg->set_rep_memo(rep_memo);
+        msg->set_latitude(45.0);
+        msg->set_longitude(10.0 + station);
+        msg->set_datetime(Datetime(2015, 4, 25, 12, 0, 0));
+        msg->set_block(16);
+        msg->set_station(station);
+        msgs.emplace_back(msg);
+        return msg;
+    };
+    for (int i = 1; i <= 4; ++i)
+    {
+        // A station name selects synop-wmo instead of synop-ecmwf-land
+        auto synop = add_common(MessageType::SYNOP, "synop", i);
+        if (i % 2)
+            synop->set_st_name("Test station");
+        synop->set_temp_2m(280.0 + i);
+
+        // Sonde tracking selects temp-wmo instead of temp-ecmwf-land
+        auto temp = add_common(MessageType::TEMP, "temp", 10 + i);
+        if (i % 2)
+            temp->set_sonde_tracking(8);
+        for (int l = 0; l < 5; ++l)
+            temp->setd(Level(100, 100000 - l * 10000), Trange::instant(), WR_VAR(0, 12, 101), 280.0 - l * 5, -1);
+    }
+    wassert(f.db->import_messages(msgs));
+
+    Dbadb dbadb(*f.db);
+    core::Query query;
+    core::ArrayFile single(Encoding::BUFR);
+    wassert(actual(dbadb.do_export(query, single, "", nullptr)) == 0);
+    wassert(actual(single.msgs.size()) == 8u);
+
+    // Messages needing different templates never share a bulletin, so
+    // grouping loses nothing
+    dbadb.subsets = 10;
+    core::ArrayFile grouped(Encoding::BUFR);
+    wassert(actual(dbadb.do_export(query, grouped, "", nullptr)) == 0);
+    wassert(actual(grouped.msgs.size()) >= 4u);
+
+    auto importer = Importer::create(Encoding::BUFR);
+    impl::Messages expected;
+    for (const auto& bm: single.msgs)
+        for (const auto& msg: importer->from_binary(bm))
+            expected.emplace_back(msg);
+    impl::Messages decoded;
+    for (const auto& bm: grouped.msgs)
+        for (const auto& msg: importer->from_binary(bm))
+            decoded.emplace_back(msg);
+    wassert(actual(impl::msg::messages_diff(expected, decoded)) == 0);
+});
+
+this->add_method("import_jobs", [](Fixture& f) {
+    std::list<std::string> fnames {
+        dballe::tests::datafile("bufr/synop-rad1.bufr"),
+        dballe::tests::datafile("bufr/gts-acars2.bufr"),
+        dballe::tests::datafile("bufr/obs0-1.22.bufr"),
+    };
+    Dbadb dbadb(*f.db);
+    cmdline::ReaderOptions opts;
+    core::Query query;
+
+    cmdline::Reader serial_reader(opts);
+    wassert(actual(dbadb.do_import(fnames, serial_reader, DBImportOptions::defaults)) == 0);
+    core::ArrayFile serial(Encoding::BUFR);
+    wassert(actual(dbadb.do_export(query, serial, "", nullptr)) == 0);
+
+    // Parallel decoding imports the same data in the same order
+    f.db->remove_all();
+    cmdline::Reader parallel_reader(opts);
+    parallel_reader.jobs = 4;
+    dbadb.commit_every = 1;
+    wassert(actual(dbadb.do_import(fnames, parallel_reader, DBImportOptions::defaults)) == 0);
+    wassert(actual(parallel_reader.count_successes) == serial_reader.count_successes);
+    wassert(actual(parallel_reader.count_failures) == 0u);
+    core::ArrayFile parallel(Encoding::BUFR);
+    wassert(actual(dbadb.do_export(query, parallel, "", nullptr)) == 0);
+    wassert(actual(parallel.msgs.size()) == serial.msgs.size());
+    for (unsigned i = 0; i < serial.msgs.size(); ++i)
+        wassert(actual(parallel.msgs[i].data) == serial.msgs[i].data);
+
+    // The messages of a single file are also decoded in parallel
+    std::list<std::string> single { dballe::tests::datafile("bufr/obs0-1.22.bufr") };
+    f.db->remove_all();
+    cmdline::Reader single_serial_reader(opts);
+    wassert(actual(dbadb.do_import(single, single_serial_reader, DBImportOptions::defaults)) == 0);
+    f.db->remove_all();
+    cmdline::Reader single_parallel_reader(opts);
+    single_parallel_reader.jobs = 4;
+    wassert(actual(dbadb.do_import(single, single_parallel_reader, DBImportOptions::defaults)) == 0);
+    wassert(actual(single_parallel_reader.count_successes) == single_serial_reader.count_successes);
+
+    // A file that cannot be opened stops the import, as it does when reading
+    // files sequentially
+    f.db->remove_all();
+    fnames.push_back("does-not-exist.bufr");
+    cmdline::Reader failing_serial_reader(opts);
+    wassert_throws(wreport::error_system, dbadb.do_import(fnames, failing_serial_reader, DBImportOptions::defaults));
+    cmdline::Reader failing_reader(opts);
+    failing_reader.jobs = 4;
+    wassert_throws(wreport::error_system, dbadb.do_import(fnames, failing_reader, DBImportOptions::defaults));
+});
+
+this->add_method("import_checkpoint", [](Fixture& f) {
+    std::string file1 = dballe::tests::datafile("bufr/synop-rad1.bufr");
+    std::string file2 = dballe::tests::datafile("bufr/gts-acars2.bufr");
+    std::string checkpoint = "test-import-checkpoint";
+    sys::unlink_ifexists(checkpoint);
+    cmdline::ReaderOptions opts;
+
+    Dbadb dbadb(*f.db);
+    dbadb.commit_every = 1;
+    dbadb.checkpoint = checkpoint;
+
+    // Interrupt the import with a file that cannot be read
+    cmdline::Reader reader1(opts);
+    wassert_throws(std::exception, dbadb.do_import(std::list<std::string>{ file1, "does-not-exist.bufr" }, reader1, DBImportOptions::defaults));
+    wassert(actual(reader1.count_successes) > 0u);
+    wassert_true(sys::exists(checkpoint));
+
+    // Resuming skips what has already been committed, and removes the
+    // checkpoint at the end
+    cmdline::Reader reader2(opts);
+    wassert(actual(dbadb.do_import(std::list<std::string>{ file1, file2 }, reader2, DBImportOptions::defaults)) == 0);
+    wassert_false(sys::exists(checkpoint));
+
+    cmdline::Reader reader3(opts);
+    dbadb.checkpoint.clear();
+    wassert(actual(dbadb.do_import(file2, reader3, DBImportOptions::defaults)) == 0);
+    wassert(actual(reader2.count_successes) == reader3.count_successes);
+});
+
 }
 
 }
@@ -1,9 +1,16 @@
 #include "dbadb.h"
 #include "dballe/message.h"
 #include "dballe/msg/msg.h"
+#include "dballe/msg/wr_codec.h"
 #include "dballe/values.h"
 #include "dballe/db/db.h"
-
+#include "dballe/db/v7/db.h"
+#include "dballe/db/v7/driver.h"
+#include "dballe/core/workers.h"
+#include <wreport/utils/sys.h>
+#include <algorithm>
+#include <chrono>
+#include <sstream>
 #include <cstdlib>
 
 using namespace wreport;
@@ -16,26 +23,74 @@ namespace cmdline {
 
 namespace {
 
+void write_checkpoint(const std::string& checkpoint, const std::string& pathname, unsigned index, off_t offset)
+{
+    std::stringstream out;
+    out << pathname << endl << index << endl << offset << endl;
+    sys::write_file_atomically(checkpoint, out.str());
+}
+
 struct Importer : public Action
 {
     dballe::DB& db;
     const DBImportOptions& opts;
     std::shared_ptr<dballe::Transaction> transaction;
+    /// Number of messages after which the transaction is committed (0: never)
+    unsigned commit_every = 0;
+    /// Number of seconds after which the transaction is committed (0: never)
+    unsigned commit_seconds = 0;
+    /// Checkpoint file to write after each commit (empty: none)
+    std::string checkpoint;
+    /// Number of messages imported in the current transaction
+    unsigned pending = 0;
+    /// Time when the current transaction was started
+    std::chrono::steady_clock::time_point started;
+    /// Position of the last message sent to the importer
+    std::string last_pathname;
+    unsigned last_index = 0;
+    off_t last_offset = 0;
+    /**
+     * True if messages are written by a write-behind thread: import errors
+     * then refer to messages queued earlier, and abort the import
+     */
+    bool write_behind = false;
 
-    Importer(dballe::DB& db, const DBImportOptions& opts) : db(db), opts(opts) {}
+    Importer(dballe::DB& db, const DBImportOptions& opts) : db(db), opts(opts)
+    {
+        if (auto v7db = dynamic_cast<dballe::db::v7::DB*>(&db))
+            write_behind = v7db->write_behind != 0;
+    }
 
     virtual bool operator()(const cmdline::Item& item);
     void commit()
     {
         if (transaction.get())
+        {
             transaction->commit();
+            transaction.reset();
+            if (!checkpoint.empty())
+                write_checkpoint(checkpoint, last_pathname, last_index, last_offset);
+        }
+        pending = 0;
     }
 };
 
 bool Importer::operator()(const Item& item)
 {
     if (!transaction.get())
+    {
         transaction = db.transaction();
+        started = std::chrono::steady_clock::now();
+    }
+
+    if (!checkpoint.empty())
+    {
+        if (!item.rmsg)
+            throw error_consistency("checkpoints can only be used when importing BUFR, CREX or JSON files");
+        last_pathname = item.rmsg->pathname;
+        last_index = item.idx;
+        last_offset = item.rmsg->offset;
+    }
 
     if (item.msgs == NULL)
     {
@@ -45,8 +100,17 @@ bool Importer::operator()(const Item& item)
     try {
         transaction->import_messages(*item.msgs, opts);
     } catch (std::exception& e) {
+        // A write-behind error is not about this item, which has not been
+        // queued, and the transaction can only be rolled back
+        if (write_behind)
+            error_consistency::throwf("cannot write previously queued messages: %s", e.what());
         item.processing_failed(e);
     }
+    ++pending;
+    if (commit_every && pending >= commit_every)
+        commit();
+    else if (commit_seconds && std::chrono::steady_clock::now() - started >= std::chrono::seconds(commit_seconds))
+        commit();
     return true;
 }
 
@@ -102,8 +166,40 @@ int Dbadb::do_export_dump(const Query& query, FILE* out)
 int Dbadb::do_import(const list<string>& fnames, Reader& reader, const DBImportOptions& opts)
 {
     Importer importer(db, opts);
-    reader.read(fnames, importer);
+    importer.commit_every = commit_every;
+    importer.commit_seconds = commit_seconds;
+    importer.checkpoint = checkpoint;
+
+    list<string> to_read(fnames);
+    if (!checkpoint.empty() && sys::exists(checkpoint))
+    {
+        // Resume after the last message committed by an interrupted import
+        std::stringstream in(sys::read_file(checkpoint));
+        std::string pathname;
+        unsigned index;
+        if (!getline(in, pathname) || !(in >> index))
+            error_consistency::throwf("cannot parse checkpoint file %s", checkpoint.c_str());
+        auto i = find(to_read.begin(), to_read.end(), pathname);
+        if (i == to_read.end())
+            error_consistency::throwf("checkpoint file %s refers to %s, which is not among the files to import", checkpoint.c_str(), pathname.c_str());
+        to_read.erase(to_read.begin(), i);
+        reader.resume_index = index + 1;
+        if (reader.verbose)
+            fprintf(stderr, "Resuming import from %s:#%u\n", pathname.c_str(), reader.resume_index);
+    }
+
+    reader.read(to_read, importer);
     importer.commit();
+    // Create the indices that the bulk profile skipped while importing
+    if (auto v7db = dynamic_cast<dballe::db::v7::DB*>(&db))
+    {
+        auto tr = db.transaction();
+        v7db->driver().build_deferred_indices();
+        tr->commit();
+    }
+    // The import completed: the next one starts from the beginning
+    if (!checkpoint.empty())
+        sys::unlink_ifexists(checkpoint);
     if (reader.verbose)
         fprintf(stderr, "%u messages successfully imported, %u messages skipped\n", reader.count_successes, reader.count_failures);
 
@@ -126,19 +222,23 @@ int Dbadb::do_import(const std::string& fname, Reader& reader, const DBImportOpt
     return do_import(fnames, reader, opts);
 }
 
-int Dbadb::do_export(const Query& query, File& file, const char* output_template, const char* forced_repmemo)
+int Dbadb::do_export(const Query& query, File& file, const char* output_template, const char* forced_repmemo, unsigned jobs)
 {
     impl::ExporterOptions opts;
     if (output_template && output_template[0] != 0)
         opts.template_name = output_template;
+    opts.compression = subsets > 1;
 
     if (forced_repmemo)
         forced_repmemo = forced_repmemo;
     auto exporter = Exporter::create(file.encoding(), opts);
 
     auto cursor = db.query_messages(query);
-    while (cursor->next())
-    {
+
+    // Read one message from the cursor, returning nullptr at the end
+    auto read_one = [&]() -> std::shared_ptr<Message> {
+        if (!cursor->next())
+            return std::shared_ptr<Message>();
         auto msg = cursor->detach_message();
         /* Override the message type if the user asks for it */
         if (forced_repmemo != NULL)
@@ -147,10 +247,88 @@ int Dbadb::do_export(const Query& query, File& file, const char* output_template
             m.type = impl::Message::type_from_repmemo(forced_repmemo);
             m.set_rep_memo(forced_repmemo);
         }
-        std::vector<std::shared_ptr<Message>> msgs;
-        msgs.emplace_back(move(msg));
-        file.write(exporter->to_binary(msgs));
+        return msg;
+    };
+
+    // Message read from the cursor that did not fit in the previous bulletin
+    std::shared_ptr<Message> pending;
+
+    // Identify the template used to encode a bulletin starting with msg.
+    // Autodetected templates look at the contents of the first message, so
+    // messages of the same type can still need different templates
+    auto wr_exporter = dynamic_cast<const impl::msg::WRExporter*>(exporter.get());
+    auto template_of = [&](const std::shared_ptr<Message>& msg) -> std::string {
+        if (wr_exporter)
+            return wr_exporter->template_name(msg);
+        return format_message_type(impl::Message::downcast(*msg).type);
+    };
+
+    // Read the messages for the next bulletin, returning false at the end.
+    // Consecutive messages exported with the same template are grouped up to
+    // the number of subsets requested
+    auto next = [&](std::vector<std::shared_ptr<Message>>& msgs) {
+        msgs.clear();
+        if (!pending)
+            pending = read_one();
+        if (!pending)
+            return false;
+        std::string tpl;
+        if (subsets > 1)
+            tpl = template_of(pending);
+        msgs.emplace_back(move(pending));
+        while (msgs.size() < subsets)
+        {
+            pending = read_one();
+            if (!pending)
+                break;
+            if (template_of(pending) != tpl)
+                break;
+            msgs.emplace_back(move(pending));
+        }
+        return true;
+    };
+
+    std::vector<std::shared_ptr<Message>> msgs;
+    if (jobs <= 1)
+    {
+        while (next(msgs))
+            file.write(exporter->to_binary(msgs));
+        return 0;
+    }
+
+    // The cursor is read in this thread, messages are encoded by a pool of
+    // threads, and a separate thread writes the encoded data, in the same
+    // order as the messages were read
+    std::vector<std::unique_ptr<Exporter>> exporters;
+    for (unsigned i = 0; i < jobs; ++i)
+        exporters.emplace_back(Exporter::create(file.encoding(), opts));
+    core::OrderedWorkers<std::vector<std::shared_ptr<Message>>, std::string> encoders(jobs, 0,
+            [&](unsigned worker, std::vector<std::shared_ptr<Message>>& msgs) {
+                return exporters[worker]->to_binary(msgs);
+            });
+    core::OrderedWorkers<std::string, bool> writer(1, 0, [&](unsigned, std::string& data) {
+        file.write(data);
+        return true;
+    });
+
+    // Move the oldest encoded message to the writer
+    auto write_one = [&] {
+        std::string data = encoders.pop();
+        if (writer.full())
+            writer.pop();
+        writer.submit(move(data));
+    };
+
+    while (next(msgs))
+    {
+        if (encoders.full())
+            write_one();
+        encoders.submit(move(msgs));
     }
+    while (!encoders.empty())
+        write_one();
+    while (!writer.empty())
+        writer.pop();
     return 0;
 }
 
@@ -17,6 +17,37 @@ protected:
     DB& db;
 
 public:
+    /**
+     * Commit the import transaction every this many messages, instead of only
+     * at the end of do_import. 0 means commit only at the end.
+     */
+    unsigned commit_every = 0;
+
+    /**
+     * Commit the import transaction when it has been open for this many
+     * seconds. 0 means commit only at the end.
+     */
+    unsigned commit_seconds = 0;
+
+    /**
+     * If not empty, after each commit do_import writes to this file the
+     * position of the last message committed.
+     *
+     * If the file exists when do_import starts, the import resumes from the
+     * message after that position. The file is removed when the import
+     * completes.
+     */
+    std::string checkpoint;
+
+    /**
+     * When exporting, encode up to this many consecutive messages that use
+     * the same template as subsets of a single bulletin.
+     *
+     * If more than 1, BUFR bulletins are compressed when all their subsets
+     * contain the same sequence of variables.
+     */
+    unsigned subsets = 1;
+
     Dbadb(DB& db) : db(db) {}
 
     /// Query data in the database and output results as arbitrary human readable text
@@ -34,8 +65,14 @@ public:
     /// Import one file
     int do_import(const std::string& fname, Reader& reader, const DBImportOptions& opts);
 
-    /// Export messages writing them to the givne file
-    int do_export(const Query& query, File& file, const char* output_template=NULL, const char* forced_repmemo=NULL);
+    /**
+     * Export messages writing them to the given file.
+     *
+     * If \a jobs is more than 1, messages are encoded in parallel by that
+     * many threads, while a separate thread writes them to \a file in the
+     * order they are read from the database.
+     */
+    int do_export(const Query& query, File& file, const char* output_template=NULL, const char* forced_repmemo=NULL, unsigned jobs=1);
 };
 
 
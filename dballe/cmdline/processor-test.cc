@@ -1,5 +1,7 @@
 #include "dballe/core/tests.h"
 #include "processor.h"
+#include "dballe/file.h"
+#include "dballe/core/query.h"
 #include <limits>
 
 using namespace dballe;
@@ -61,6 +63,49 @@ add_method("parse_index", [] {
     wassert(actual(filter.match_index(10)).istrue());
 });
 
+add_method("match_header", [] {
+    auto read_first = [](const char* fname) {
+        auto file = File::create(Encoding::BUFR, dballe::tests::datafile(fname), "r");
+        return file->read();
+    };
+    // Category 0, reference time 2009-02-24 12:00:00
+    BinaryMessage synop = read_first("bufr/synop-gtscosmo.bufr");
+    // Category 2, subcategory 255
+    BinaryMessage temp = read_first("bufr/temp-gts1.bufr");
+
+    Filter filter;
+    wassert(actual(filter.match_header(synop)).istrue());
+    wassert(actual(filter.match_header(temp)).istrue());
+
+    filter.category = 0;
+    wassert(actual(filter.match_header(synop)).istrue());
+    wassert(actual(filter.match_header(temp)).isfalse());
+
+    filter.category = 2;
+    filter.subcategory = 255;
+    wassert(actual(filter.match_header(synop)).isfalse());
+    wassert(actual(filter.match_header(temp)).istrue());
+    filter.subcategory = 1;
+    wassert(actual(filter.match_header(temp)).isfalse());
+
+    // The reference time is only used if requested
+    filter.category = filter.subcategory = -1;
+    core::Query query;
+    query.dtrange = DatetimeRange(Datetime(2009, 2, 25), Datetime(2009, 2, 26));
+    filter.matcher_from_record(query);
+    wassert(actual(filter.match_header(synop)).istrue());
+    filter.header_datetime = true;
+    wassert(actual(filter.match_header(synop)).isfalse());
+    query.dtrange = DatetimeRange(Datetime(2009, 2, 24), Datetime(2009, 2, 25));
+    filter.matcher_from_record(query);
+    wassert(actual(filter.match_header(synop)).istrue());
+
+    // Messages whose header cannot be decoded are left to the full decoding
+    BinaryMessage broken(Encoding::BUFR);
+    broken.data = "BUFR7777";
+    wassert(actual(filter.match_header(broken)).istrue());
+});
+
 add_method("parse_json", [] {
     struct TestAction : public Action {
         std::vector<std::unique_ptr<dballe::Message>> messages;
@@ -5,9 +5,12 @@
 #include "dballe/message.h"
 #include "dballe/msg/context.h"
 #include "dballe/msg/msg.h"
+#include "dballe/msg/wr_codec.h"
 #include "dballe/core/csv.h"
 #include "dballe/core/match-wreport.h"
 #include "dballe/cmdline/cmdline.h"
+#include "dballe/core/workers.h"
+#include "dballe/var.h"
 #include <cstring>
 #include <cstdlib>
 #include <fstream>
@@ -15,6 +18,7 @@
 #include <sstream>
 #include <stack>
 #include <limits>
+#include <mutex>
 
 using namespace wreport;
 using namespace std;
@@ -57,6 +61,12 @@ void Item::set_msgs(std::vector<std::shared_ptr<dballe::Message>>* new_msgs)
 }
 
 void Item::decode(Importer& imp, bool print_errors)
+{
+    decode_bulletin(print_errors);
+    decode_msgs(imp, print_errors);
+}
+
+void Item::decode_bulletin(bool print_errors)
 {
     if (!rmsg) return;
 
@@ -96,6 +106,11 @@ void Item::decode(Importer& imp, bool print_errors)
         case Encoding::JSON:
             break;
     }
+}
+
+void Item::decode_msgs(Importer& imp, bool print_errors)
+{
+    if (!rmsg) return;
 
     // Second step: decode to msgs
     switch (rmsg->encoding)
@@ -166,7 +181,8 @@ Filter::Filter(const ReaderOptions& opts)
       subcategory(opts.subcategory),
       checkdigit(opts.checkdigit),
       unparsable(opts.unparsable),
-      parsable(opts.parsable)
+      parsable(opts.parsable),
+      header_datetime(opts.header_datetime)
 {
     if (opts.index_filter) imatcher.parse(opts.index_filter);
 }
@@ -188,6 +204,7 @@ void Filter::matcher_reset()
         delete matcher;
         matcher = 0;
     }
+    dtrange = DatetimeRange();
 }
 
 void Filter::matcher_from_record(const Query& query)
@@ -198,6 +215,7 @@ void Filter::matcher_from_record(const Query& query)
         matcher = 0;
     }
     matcher = Matcher::create(query).release();
+    dtrange = query.get_datetimerange();
 }
 
 bool Filter::match_index(int idx) const
@@ -205,6 +223,53 @@ bool Filter::match_index(int idx) const
     return imatcher.match(idx);
 }
 
+bool Filter::match_header(const BinaryMessage& rmsg) const
+{
+    bool check_datetime = header_datetime && !dtrange.is_missing();
+    if (category == -1 && subcategory == -1 && !check_datetime)
+        return true;
+
+    std::unique_ptr<Bulletin> header;
+    try {
+        switch (rmsg.encoding)
+        {
+            case Encoding::BUFR:
+                header = BufrBulletin::decode_header(rmsg.data, rmsg.pathname.c_str(), rmsg.offset);
+                break;
+            case Encoding::CREX:
+                header = CrexBulletin::decode_header(rmsg.data, rmsg.pathname.c_str(), rmsg.offset);
+                break;
+            default:
+                return true;
+        }
+    } catch (error&) {
+        // Leave it to the full decoding to report the error
+        return true;
+    }
+
+    if (category != -1)
+        if (category != header->data_category)
+            return false;
+
+    if (subcategory != -1)
+        if (subcategory != header->data_subcategory)
+            return false;
+
+    if (check_datetime)
+    {
+        try {
+            Datetime dt(header->rep_year, header->rep_month, header->rep_day,
+                        header->rep_hour, header->rep_minute, header->rep_second);
+            if (!dtrange.contains(dt))
+                return false;
+        } catch (error&) {
+            // An invalid reference time is not a reason to skip the message
+        }
+    }
+
+    return true;
+}
+
 bool Filter::match_common(const BinaryMessage&, const std::vector<std::shared_ptr<dballe::Message>>* msgs) const
 {
     if (msgs == NULL && parsable)
@@ -343,17 +408,11 @@ void Reader::read_csv(const std::list<std::string>& fnames, Action& action)
             csvin.reset(new CSVReader(cin));
         }
 
-        while (true)
-        {
-            // Read input message
-            unique_ptr<impl::Message> msg(new impl::Message);
-            if (!msg->from_csv(*csvin))
-                break;
-
+        impl::msg::messages_from_csv(*csvin, [&](unique_ptr<impl::Message>&& msg) {
             // Match against index matcher
             ++item.idx;
             if (!filter.match_index(item.idx))
-                continue;
+                return true;
 
             // We want it: move it to the item
             unique_ptr<impl::Messages> msgs(new impl::Messages);
@@ -361,59 +420,101 @@ void Reader::read_csv(const std::list<std::string>& fnames, Action& action)
             item.set_msgs(msgs.release());
 
             if (!filter.match_item(item))
-                continue;
+                return true;
 
             action(item);
-        }
+            return true;
+        });
     } while (name != fnames.end());
 }
 
+std::unique_ptr<File> Reader::open_file(const std::string& fname)
+{
+    if (input_type == "auto")
+        return File::create(fname, "r");
+    else
+        return File::create(string_to_encoding(input_type.c_str()), fname, "r");
+}
+
+void Reader::process_item(Item& item, Action& action, Encoding encoding, std::unique_ptr<File>& fail_file, std::exception_ptr error)
+{
+    bool processed = false;
+
+    try {
+        if (error)
+            std::rethrow_exception(error);
+        processed = action(item);
+    } catch (ProcessingException& pe) {
+        // If ProcessingException has been raised, we can safely skip
+        // to the next input
+        processed = false;
+        if (verbose)
+            fprintf(stderr, "%s\n", pe.what());
+    } catch (std::exception& e) {
+        if (verbose)
+            fprintf(stderr, "%s:#%d: %s\n", item.rmsg ? item.rmsg->pathname.c_str() : "(unknown)", item.idx, e.what());
+        throw;
+    }
+
+    // Output items that have not been processed successfully
+    if (!processed && fail_file_name)
+    {
+        if (!fail_file.get())
+            fail_file = File::create(encoding, fail_file_name, "ab");
+        fail_file->write(item.rmsg->data);
+    }
+    if (processed)
+        ++count_successes;
+    else
+        ++count_failures;
+}
+
 void Reader::read_file(const std::list<std::string>& fnames, Action& action)
 {
+    if (jobs > 1 && !fnames.empty())
+        return read_files_parallel(fnames, action);
+
     bool print_errors = !filter.unparsable;
     std::unique_ptr<File> fail_file;
+    unsigned skip_until = resume_index;
 
     list<string>::const_iterator name = fnames.begin();
     do
     {
         unique_ptr<File> file;
 
-        if (input_type == "auto")
+        if (name != fnames.end())
         {
-            if (name != fnames.end())
-            {
-                file = File::create(*name, "r");
-                ++name;
-            } else {
-                file = File::create(stdin, false, "standard input");
-            }
+            file = open_file(*name);
+            ++name;
+        } else if (input_type == "auto") {
+            file = File::create(stdin, false, "standard input");
         } else {
-            Encoding intype = string_to_encoding(input_type.c_str());
-            if (name != fnames.end())
-            {
-                file = File::create(intype, *name, "r");
-                ++name;
-            } else {
-                file = File::create(intype, stdin, false, "standard input");
-            }
+            file = File::create(string_to_encoding(input_type.c_str()), stdin, false, "standard input");
         }
 
-
         std::unique_ptr<Importer> imp = Importer::create(file->encoding(), import_opts);
         while (BinaryMessage bm = file->read())
         {
+            if (bm.index < skip_until)
+                continue;
+
             Item item;
             item.rmsg = new BinaryMessage(bm);
             item.idx = bm.index;
-            bool processed = false;
+            std::exception_ptr error;
 
-            try {
-    //          if (op_verbose)
-    //              fprintf(stderr, "Reading message #%d...\n", item.index);
+    //      if (op_verbose)
+    //          fprintf(stderr, "Reading message #%d...\n", item.index);
 
-                if (!filter.match_index(item.idx))
-                    continue;
+            if (!filter.match_index(item.idx))
+                continue;
 
+            // Skip decoding messages whose header does not match
+            if (!filter.match_header(*item.rmsg))
+                continue;
+
+            try {
                 try {
                     item.decode(*imp, print_errors);
                 } catch (std::exception& e) {
@@ -428,33 +529,141 @@ void Reader::read_file(const std::list<std::string>& fnames, Action& action)
 
                 if (!filter.match_item(item))
                     continue;
-
-                processed = action(item);
             } catch (ProcessingException& pe) {
-                // If ProcessingException has been raised, we can safely skip
-                // to the next input
-                processed = false;
-                if (verbose)
-                    fprintf(stderr, "%s\n", pe.what());
-            } catch (std::exception& e) {
-                if (verbose)
-                    fprintf(stderr, "%s:#%d: %s\n", file->pathname().c_str(), item.idx, e.what());
-                throw;
+                error = std::current_exception();
             }
 
-            // Output items that have not been processed successfully
-            if (!processed && fail_file_name)
+            process_item(item, action, file->encoding(), fail_file, error);
+        }
+
+        // resume_index only applies to the first file
+        skip_until = 0;
+    } while (name != fnames.end());
+}
+
+namespace {
+
+/// Maximum number of messages decoded by a worker in one go
+static const size_t decode_batch_size = 64;
+
+/// Consecutive items of one input file, decoded by a worker
+struct DecodedBatch
+{
+    struct Entry
+    {
+        std::unique_ptr<Item> item;
+        /// ProcessingException raised decoding the item, if any
+        std::exception_ptr error;
+        /// True if the item does not match the filter
+        bool skip = false;
+
+        Entry(std::unique_ptr<Item> item) : item(std::move(item)) {}
+    };
+
+    Encoding encoding = Encoding::BUFR;
+    std::vector<Entry> entries;
+};
+
+}
+
+void Reader::read_files_parallel(const std::list<std::string>& fnames, Action& action)
+{
+    bool print_errors = !filter.unparsable;
+    std::unique_ptr<File> fail_file;
+
+    // Make sure that the DB-All.e variable table is loaded before the
+    // workers start using it
+    varinfo(WR_VAR(0, 1, 1));
+
+    // Files are read here, and batches of their messages are decoded by the
+    // workers. Items are sent to the action here, in the same order as they
+    // were read. At most 2 batches per worker are pending, which bounds
+    // memory usage regardless of the size of the input files.
+    std::vector<std::unique_ptr<Importer>> importers(jobs);
+    core::OrderedWorkers<std::unique_ptr<DecodedBatch>, std::unique_ptr<DecodedBatch>> workers(jobs, jobs * 2,
+        [&](unsigned worker, std::unique_ptr<DecodedBatch>& batch) {
+            auto& imp = importers[worker];
+            if (!imp || imp->encoding() != batch->encoding)
+                imp = Importer::create(batch->encoding, import_opts);
+            for (auto& entry: batch->entries)
+            {
+                Item& item = *entry.item;
+                try {
+                    try {
+                        {
+                            // wreport's table caches are not thread safe:
+                            // only the decoding of the bulletins looks up and
+                            // loads tables, and it is serialized
+                            std::lock_guard<std::mutex> lock(impl::msg::wreport_tables_mutex());
+                            item.decode_bulletin(print_errors);
+                        }
+                        item.decode_msgs(*imp, print_errors);
+                    } catch (std::exception& e) {
+                        item.processing_failed(e);
+                    }
+                    entry.skip = !filter.match_item(item);
+                } catch (ProcessingException& pe) {
+                    entry.error = std::current_exception();
+                }
+            }
+            return std::move(batch);
+        });
+
+    auto process_batch = [&](DecodedBatch& decoded) {
+        for (auto& entry: decoded.entries)
+        {
+            if (entry.skip)
+                continue;
+            process_item(*entry.item, action, decoded.encoding, fail_file, entry.error);
+        }
+    };
+
+    auto submit = [&](std::unique_ptr<DecodedBatch>& batch) {
+        if (!batch || batch->entries.empty())
+            return;
+        if (workers.full())
+            process_batch(*workers.pop());
+        workers.submit(std::move(batch));
+        batch.reset();
+    };
+
+    unsigned skip_until = resume_index;
+    try {
+        for (const auto& fname: fnames)
+        {
+            std::unique_ptr<File> file = open_file(fname);
+            std::unique_ptr<DecodedBatch> batch;
+            while (BinaryMessage bm = file->read())
             {
-                if (!fail_file.get())
-                    fail_file = File::create(file->encoding(), fail_file_name, "ab");
-                fail_file->write(item.rmsg->data);
+                if (bm.index < skip_until || !filter.match_index(bm.index) || !filter.match_header(bm))
+                    continue;
+
+                if (!batch)
+                {
+                    batch.reset(new DecodedBatch);
+                    batch->encoding = file->encoding();
+                    batch->entries.reserve(decode_batch_size);
+                }
+                std::unique_ptr<Item> item(new Item);
+                item->rmsg = new BinaryMessage(bm);
+                item->idx = bm.index;
+                batch->entries.emplace_back(std::move(item));
+                if (batch->entries.size() == decode_batch_size)
+                    submit(batch);
             }
-            if (processed)
-                ++count_successes;
-            else
-                ++count_failures;
+            submit(batch);
+            // resume_index only applies to the first file
+            skip_until = 0;
         }
-    } while (name != fnames.end());
+    } catch (std::exception&) {
+        // A file that cannot be opened or read stops the import, like when
+        // reading files sequentially, after processing what was read before
+        while (!workers.empty())
+            process_batch(*workers.pop());
+        throw;
+    }
+    while (!workers.empty())
+        process_batch(*workers.pop());
 }
 
 void Reader::read(const std::list<std::string>& fnames, Action& action)
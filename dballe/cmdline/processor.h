@@ -5,6 +5,8 @@
 #include <dballe/exporter.h>
 #include <dballe/msg/msg.h>
 #include <stdexcept>
+#include <exception>
+#include <memory>
 #include <list>
 #include <string>
 
@@ -108,6 +110,16 @@ struct Item
     /// Decode all that can be decoded
     void decode(Importer& imp, bool print_errors=false);
 
+    /**
+     * Decode the raw BUFR or CREX message into bulletin.
+     *
+     * This is the only decoding step that uses the wreport tables.
+     */
+    void decode_bulletin(bool print_errors=false);
+
+    /// Interpret bulletin, or the raw message for JSON, into msgs
+    void decode_msgs(Importer& imp, bool print_errors=false);
+
     /// Set the value of msgs, possibly replacing the previous one
     void set_msgs(std::vector<std::shared_ptr<Message>>* new_msgs);
 
@@ -137,6 +149,7 @@ struct ReaderOptions
     int checkdigit = -1;
     int unparsable = 0;
     int parsable = 0;
+    int header_datetime = 0;
     const char* index_filter = nullptr;
     const char* input_type = "auto";
     const char* fail_file_name = nullptr;
@@ -150,8 +163,18 @@ struct Filter
     int checkdigit = -1;
     int unparsable = 0;
     int parsable = 0;
+    /**
+     * Also match the datetime range of the matcher against the reference
+     * time in the header of BUFR and CREX messages.
+     *
+     * This only gives correct results when the reference time is the time of
+     * the observations.
+     */
+    bool header_datetime = false;
     IndexMatcher imatcher;
     Matcher* matcher = nullptr;
+    /// Datetime range of the matcher, used by match_header()
+    DatetimeRange dtrange;
 
     Filter();
     Filter(const ReaderOptions& opts);
@@ -166,6 +189,17 @@ struct Filter
     void matcher_from_record(const Query& query);
 
     bool match_index(int idx) const;
+
+    /**
+     * Check what can be checked by decoding only the header of BUFR and CREX
+     * messages.
+     *
+     * This allows to skip decoding messages that would not match anyway.
+     *
+     * @returns false if the message does not match, true if it needs to be
+     * decoded and checked with match_item()
+     */
+    bool match_header(const BinaryMessage& rmsg) const;
     bool match_common(const BinaryMessage& rmsg, const std::vector<std::shared_ptr<dballe::Message>>* msgs) const;
     bool match_msgs(const std::vector<std::shared_ptr<dballe::Message>>& msgs) const;
     bool match_bufrex(const BinaryMessage& rmsg, const wreport::Bulletin* rm, const std::vector<std::shared_ptr<dballe::Message>>* msgs) const;
@@ -184,11 +218,37 @@ protected:
     void read_csv(const std::list<std::string>& fnames, Action& action);
     void read_json(const std::list<std::string>& fnames, Action& action);
     void read_file(const std::list<std::string>& fnames, Action& action);
+    void read_files_parallel(const std::list<std::string>& fnames, Action& action);
+
+    /// Open an input file according to input_type
+    std::unique_ptr<File> open_file(const std::string& fname);
+
+    /**
+     * Send an item to the action, handling ProcessingException, and account
+     * for the result.
+     *
+     * If \a error is set, it is raised in place of calling the action.
+     */
+    void process_item(Item& item, Action& action, Encoding encoding, std::unique_ptr<File>& fail_file, std::exception_ptr error=nullptr);
 
 public:
     impl::ImporterOptions import_opts;
     Filter filter;
     bool verbose = false;
+    /**
+     * Number of files to read and decode at the same time.
+     *
+     * If more than 1 and input files are given, the files are read by the
+     * calling thread and their messages are decoded in batches by a pool of
+     * threads, while the action is called on the decoded items from the
+     * calling thread, in the same order as if they were decoded sequentially.
+     */
+    unsigned jobs = 1;
+    /**
+     * Skip the messages of the first input file with an index lower than
+     * this, to resume an interrupted import
+     */
+    unsigned resume_index = 0;
     unsigned count_successes = 0;
     unsigned count_failures = 0;
 
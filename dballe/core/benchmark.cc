@@ -5,8 +5,12 @@
 #include <cmath>
 #include <system_error>
 #include <algorithm>
+#include <fstream>
+#include <cstring>
 #include "dballe/msg/msg.h"
 #include "dballe/importer.h"
+#include "dballe/core/json.h"
+#include <wreport/error.h>
 
 using namespace std;
 
@@ -19,6 +23,8 @@ double ticks_per_sec = sysconf(_SC_CLK_TCK);
 namespace dballe {
 namespace benchmark {
 
+std::atomic<size_t> allocation_count(0);
+
 /*
 void Task::collect(std::function<void()> f)
 {
@@ -71,6 +77,36 @@ std::string format_clockdiff(const struct timespec& begin, const struct timespec
 }
 
 
+static double timespec_diff(const struct timespec& begin, const struct timespec& until)
+{
+    return (until.tv_sec - begin.tv_sec) + (until.tv_nsec - begin.tv_nsec) / 1000000000.0;
+}
+
+static double timeval_diff(const struct timeval& begin, const struct timeval& until)
+{
+    return (until.tv_sec - begin.tv_sec) + (until.tv_usec - begin.tv_usec) / 1000000.0;
+}
+
+void Measurement::start()
+{
+    allocs_at_start = allocation_count.load();
+    bench_getrusage(RUSAGE_SELF, &res_at_start);
+    bench_clock_gettime(CLOCK_MONOTONIC_RAW, &time_at_start);
+}
+
+void Measurement::stop(const Task& task)
+{
+    bench_clock_gettime(CLOCK_MONOTONIC_RAW, &time_at_end);
+    bench_getrusage(RUSAGE_SELF, &res_at_end);
+    allocs_at_end = allocation_count.load();
+    items = task.items;
+}
+
+double Measurement::wall_time() const { return timespec_diff(time_at_start, time_at_end); }
+double Measurement::user_time() const { return timeval_diff(res_at_start.ru_utime, res_at_end.ru_utime); }
+double Measurement::system_time() const { return timeval_diff(res_at_start.ru_stime, res_at_end.ru_stime); }
+
+
 void Timeit::run(Progress& progress, Task& task)
 {
     task_name = task.name();
@@ -78,13 +114,13 @@ void Timeit::run(Progress& progress, Task& task)
     try {
         task.setup();
 
-        bench_getrusage(RUSAGE_SELF, &res_at_start);
-        bench_clock_gettime(CLOCK_MONOTONIC_RAW, &time_at_start);
+        task.items = 0;
+        start();
         for (unsigned i = 0; i < repetitions; ++i)
             task.run_once();
-        bench_clock_gettime(CLOCK_MONOTONIC_RAW, &time_at_end);
-        bench_getrusage(RUSAGE_SELF, &res_at_end);
+        stop(task);
     } catch (std::exception& e) {
+        failed = true;
         progress.test_failed(task, e);
     }
     task.teardown();
@@ -97,24 +133,26 @@ void Throughput::run(Progress& progress, Task& task)
     progress.start_throughput(*this);
     try {
         task.setup();
-        struct timespec time_at_start;
-        bench_clock_gettime(CLOCK_MONOTONIC_RAW, &time_at_start);
-        struct timespec time_at_end;
-        time_at_end.tv_nsec = time_at_start.tv_nsec + ((long)floor(run_time * 1000000000.0) % 1000000000);
-        time_at_end.tv_sec  = time_at_start.tv_sec + time_at_end.tv_nsec / 1000000000 + (long)floor(run_time);
-        time_at_end.tv_nsec = time_at_end.tv_nsec % 1000000000;
+        task.items = 0;
+        start();
+        struct timespec deadline;
+        deadline.tv_nsec = time_at_start.tv_nsec + ((long)floor(run_time * 1000000000.0) % 1000000000);
+        deadline.tv_sec  = time_at_start.tv_sec + deadline.tv_nsec / 1000000000 + (long)floor(run_time);
+        deadline.tv_nsec = deadline.tv_nsec % 1000000000;
 
         struct timespec time_cur;
         for ( ; true; ++times_run)
         {
             bench_clock_gettime(CLOCK_MONOTONIC_RAW, &time_cur);
-            if (time_cur.tv_sec > time_at_end.tv_sec) break;
-            if (time_cur.tv_sec == time_at_end.tv_sec && time_cur.tv_nsec > time_at_end.tv_nsec) break;
+            if (time_cur.tv_sec > deadline.tv_sec) break;
+            if (time_cur.tv_sec == deadline.tv_sec && time_cur.tv_nsec > deadline.tv_nsec) break;
             task.run_once();
         }
+        stop(task);
 
-        run_time = time_cur.tv_sec - time_at_start.tv_sec + (time_cur.tv_nsec - time_at_start.tv_nsec) / 1000000000.0;
+        run_time = wall_time();
     } catch (std::exception& e) {
+        failed = true;
         progress.test_failed(task, e);
     }
     task.teardown();
@@ -170,6 +208,59 @@ void Benchmark::print_timings()
     */
 }
 
+namespace {
+
+void json_measurement(core::JSONWriter& writer, const Measurement& m, const std::string& name, const char* type, unsigned runs)
+{
+    writer.start_mapping();
+    writer.add("name", name);
+    writer.add("type", type);
+    writer.add("failed", m.failed);
+    writer.add("runs", (int)runs);
+    if (!m.failed)
+    {
+        double wall_time = m.wall_time();
+        writer.add("wall_time", wall_time);
+        writer.add("user_time", m.user_time());
+        writer.add("system_time", m.system_time());
+        writer.add("max_rss", (int)m.max_rss());
+        writer.add("items", m.items);
+        writer.add("items_per_second", wall_time > 0 ? m.items / wall_time : 0.0);
+        writer.add("allocations", m.allocations());
+        writer.add("allocations_per_run", runs ? (double)m.allocations() / runs : 0.0);
+    }
+    writer.end_mapping();
+}
+
+}
+
+void Benchmark::print_json(std::ostream& out, const std::string& suite)
+{
+    core::JSONWriter writer(out);
+    writer.start_mapping();
+    writer.add("suite", suite);
+    writer.add_cstring("tasks");
+    writer.start_list();
+    for (auto& t: timeit_tasks)
+        json_measurement(writer, t, t.task_name, "timeit", t.repetitions);
+    for (auto& t: throughput_tasks)
+        json_measurement(writer, t, t.task_name, "throughput", t.times_run);
+    writer.end_list();
+    writer.end_mapping();
+    out << endl;
+}
+
+void Benchmark::write_json(const std::string& pathname, const std::string& suite)
+{
+    std::ofstream out(pathname);
+    if (!out)
+        wreport::error_system::throwf("cannot open %s", pathname.c_str());
+    print_json(out, suite);
+    out.close();
+    if (!out)
+        wreport::error_system::throwf("cannot write to %s", pathname.c_str());
+}
+
 BasicProgress::BasicProgress(FILE* out, FILE* err)
     : out(out), err(err) {}
 
@@ -191,7 +282,10 @@ void BasicProgress::start_throughput(const Throughput& t)
 
 void BasicProgress::end_throughput(const Throughput& t)
 {
-    fprintf(out, "%u times in %.2fs: %.2f/s.\n", t.times_run, t.run_time, (double)t.times_run/t.run_time);
+    if (t.items)
+        fprintf(out, "%u times in %.2fs: %.2f/s, %.2f items/s.\n", t.times_run, t.run_time, (double)t.times_run/t.run_time, (double)t.items/t.run_time);
+    else
+        fprintf(out, "%u times in %.2fs: %.2f/s.\n", t.times_run, t.run_time, (double)t.times_run/t.run_time);
 }
 
 void BasicProgress::test_failed(const Task& t, std::exception& e)
@@ -201,7 +295,7 @@ void BasicProgress::test_failed(const Task& t, std::exception& e)
 
 void Messages::load(const std::string& pathname, dballe::Encoding encoding, const char* codec_options)
 {
-    auto importer = Importer::create(Encoding::BUFR, codec_options);
+    auto importer = Importer::create(encoding, codec_options);
     auto in = File::create(encoding, pathname, "rb");
     in->foreach([&](const BinaryMessage& rmsg) {
         emplace_back(importer->from_binary(rmsg));
@@ -216,10 +310,28 @@ void Messages::duplicate(size_t size, const Datetime& datetime)
 }
 
 
+Options::Options(int argc, const char* argv[])
+{
+    for (int i = 1; i < argc; ++i)
+    {
+        if (strncmp(argv[i], "--", 2) != 0)
+            continue;
+        if (strncmp(argv[i], "--json=", 7) == 0)
+            json_output = argv[i] + 7;
+        else
+            wreport::error_consistency::throwf("unknown benchmark option %s", argv[i]);
+    }
+}
+
 Whitelist::Whitelist(int argc, const char* argv[])
 {
     for (int i = 1; i < argc; ++i)
+    {
+        // Skip options, handled by Options
+        if (strncmp(argv[i], "--", 2) == 0)
+            continue;
         emplace_back(argv[i]);
+    }
 }
 
 bool Whitelist::has(const std::string& val)
@@ -7,9 +7,11 @@
 
 #include <string>
 #include <vector>
+#include <iosfwd>
 #include <functional>
 #include <memory>
 #include <cstdio>
+#include <atomic>
 #include <time.h>
 #include <sys/time.h>
 #include <sys/resource.h>
@@ -21,6 +23,15 @@ namespace benchmark {
 
 struct Benchmark;
 
+/**
+ * Number of memory allocations performed so far.
+ *
+ * It is only incremented if the benchmark program is linked with an
+ * operator new replacement that counts allocations, like bench/allocs.cc;
+ * otherwise it always stays 0.
+ */
+extern std::atomic<size_t> allocation_count;
+
 /// One task to be measured.
 struct Task
 {
@@ -33,6 +44,14 @@ struct Task
 
     virtual const char* name() const = 0;
 
+    /**
+     * Number of items (messages, rows, values...) processed by run_once().
+     *
+     * run_once() implementations can increment it to have the benchmark
+     * report a processing rate. It is reset before each measurement.
+     */
+    size_t items = 0;
+
     /// Set up the environment for running run_once()
     virtual void setup() {}
 
@@ -50,20 +69,52 @@ struct Task
 
 struct Progress;
 
-struct Timeit
+/// Resources used while running a task
+struct Measurement
 {
-    std::string task_name;
-    /// How many times to repeat the task for measuring how long it takes
-    unsigned repetitions = 1;
     struct timespec time_at_start;
     struct timespec time_at_end;
     struct rusage res_at_start;
     struct rusage res_at_end;
+    size_t allocs_at_start = 0;
+    size_t allocs_at_end = 0;
+    /// Number of items processed by the task
+    size_t items = 0;
+    /// True if the task raised an exception
+    bool failed = false;
+
+    /// Start measuring
+    void start();
+
+    /// Stop measuring
+    void stop(const Task& task);
+
+    /// Elapsed wall clock time in seconds
+    double wall_time() const;
+
+    /// User CPU time in seconds
+    double user_time() const;
+
+    /// System CPU time in seconds
+    double system_time() const;
+
+    /// Peak resident set size of the process, in kilobytes
+    long max_rss() const { return res_at_end.ru_maxrss; }
+
+    /// Number of memory allocations performed
+    size_t allocations() const { return allocs_at_end - allocs_at_start; }
+};
+
+struct Timeit : public Measurement
+{
+    std::string task_name;
+    /// How many times to repeat the task for measuring how long it takes
+    unsigned repetitions = 1;
 
     void run(Progress& progress, Task& task);
 };
 
-struct Throughput
+struct Throughput : public Measurement
 {
     std::string task_name;
     /// How many seconds to run the task to see how many times per second it runs
@@ -136,6 +187,22 @@ struct Benchmark
 
     /// Print timings to stdout
     void print_timings();
+
+    /**
+     * Write all measurements as JSON to \a out.
+     *
+     * @param suite
+     *   Name of the benchmark suite, used to tell apart the results of
+     *   different benchmark programs when merging or comparing them
+     */
+    void print_json(std::ostream& out, const std::string& suite);
+
+    /**
+     * Write all measurements as JSON to the file \a pathname.
+     *
+     * See print_json()
+     */
+    void write_json(const std::string& pathname, const std::string& suite);
 };
 
 
@@ -151,6 +218,26 @@ struct Messages : public std::vector<std::vector<std::shared_ptr<dballe::Message
     void duplicate(size_t size, const Datetime& datetime);
 };
 
+/**
+ * Command line options common to all benchmark programs.
+ *
+ * Options start with "--"; everything else is a task name, used to build a
+ * Whitelist.
+ */
+struct Options
+{
+    /// If not empty, write JSON results to this file (--json=pathname)
+    std::string json_output;
+
+    Options(int argc, const char* argv[]);
+};
+
+/**
+ * Names of the tasks to run, taken from the command line arguments that are
+ * not options.
+ *
+ * If empty, all tasks are run.
+ */
 struct Whitelist : protected std::vector<std::string>
 {
     Whitelist(int argc, const char* argv[]);
@@ -180,6 +180,24 @@ class Tests : public TestCase
             }
         });
 
+        // Test reading lines across the boundaries of the read buffer
+        add_method("reader_long", []() {
+            stringstream in;
+            for (unsigned i = 0; i < 10000; ++i)
+                in << i << ",\"a,\"\"b\"\"\"," << string(i % 50, 'x') << "\r\n";
+            CSVReader reader(in);
+            for (unsigned i = 0; i < 10000; ++i)
+            {
+                wassert(actual(reader.next()).istrue());
+                wassert(actual(reader.cols.size()) == 3u);
+                wassert(actual(reader.cols[0]) == to_string(i));
+                wassert(actual(reader.cols[1]) == "a,\"b\"");
+                wassert(actual(reader.cols[2]) == string(i % 50, 'x'));
+            }
+            wassert(actual(reader.next()).isfalse());
+            wassert(actual(reader.cols.size()) == 0u);
+        });
+
         // Test write/read cycles
         add_method("writer", []() {
             MemoryCSVWriter out;
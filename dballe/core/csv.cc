@@ -67,7 +67,10 @@ CSVReader::CSVReader(const std::string& pathname)
 {
     open(pathname);
 }
-CSVReader::~CSVReader() {}
+CSVReader::~CSVReader()
+{
+    close();
+}
 
 void CSVReader::open(const std::string& pathname)
 {
@@ -84,6 +87,7 @@ void CSVReader::close()
         delete in;
     in = 0;
     close_on_exit = true;
+    buf_pos = buf_end = 0;
 }
 
 std::string CSVReader::unescape(const std::string& csvstr)
@@ -140,23 +144,39 @@ bool CSVReader::move_to_data(unsigned number_col)
     return true;
 }
 
-int CSVReader::next_char()
+bool CSVReader::fill_buffer()
 {
-    int res = in->get();
-    if (res == EOF && !in->eof())
-        throw error_system("reading a character from CSV input");
-    return res;
+    if (buf.empty())
+        buf.resize(65536);
+    buf_pos = buf_end = 0;
+    if (in->eof())
+        return false;
+    in->read(buf.data(), buf.size());
+    if (in->bad())
+        throw error_system("reading CSV input");
+    buf_end = in->gcount();
+    return buf_end > 0;
 }
 
 bool CSVReader::next()
 {
     if (!in) return false;
 
-    cols.clear();
+    // Parse the columns into the strings of the previous line, to reuse their
+    // memory. ncols is the number of columns parsed so far, and col is the
+    // column currently being parsed
+    size_t ncols = 0;
+    string* col;
+    auto next_col = [&] {
+        if (ncols == cols.size())
+            cols.emplace_back();
+        col = &cols[ncols];
+        col->clear();
+    };
+    next_col();
 
     // Tokenize the input line
     enum State { BEG, COL, QCOL, EQCOL, HALFEOL } state = BEG;
-    string col;
     int c;
     while ((c = next_char()) != EOF)
     {
@@ -171,18 +191,18 @@ bool CSVReader::next()
                         break;
                     case ',':
                         state = BEG;
-                        cols.push_back(col);
-                        col.clear();
+                        ++ncols;
+                        next_col();
                         break;
                     case '\r':
                         state = HALFEOL;
                         break;
                     case '\n':
-                        cols.push_back(col);
+                        cols.resize(++ncols);
                         return true;
                     default:
                         state = COL;
-                        col += c;
+                        *col += c;
                         break;
                 }
                 break;
@@ -192,17 +212,17 @@ bool CSVReader::next()
                 {
                     case ',':
                         state = BEG;
-                        cols.push_back(col);
-                        col.clear();
+                        ++ncols;
+                        next_col();
                         break;
                     case '\r':
                         state = HALFEOL;
                         break;
                     case '\n':
-                        cols.push_back(col);
+                        cols.resize(++ncols);
                         return true;
                     default:
-                        col += c;
+                        *col += c;
                         break;
                 }
                 break;
@@ -214,7 +234,7 @@ bool CSVReader::next()
                         state = EQCOL;
                         break;
                     default:
-                        col += c;
+                        *col += c;
                         break;
                 }
                 break;
@@ -225,19 +245,19 @@ bool CSVReader::next()
                     // The quote marked the end of the value
                     case ',':
                         state = BEG;
-                        cols.push_back(col);
-                        col.clear();
+                        ++ncols;
+                        next_col();
                         break;
                     case '\r':
                         state = HALFEOL;
                         break;
                     case '\n':
-                        cols.push_back(col);
+                        cols.resize(++ncols);
                         return true;
                     // The quote was an escape
                     default:
                         state = QCOL;
-                        col += c;
+                        *col += c;
                         break;
                 }
                 break;
@@ -246,12 +266,12 @@ bool CSVReader::next()
                 switch (c)
                 {
                     case '\n':
-                        cols.push_back(col);
+                        cols.resize(++ncols);
                         return true;
                     default:
                         state = COL;
-                        col += '\r';
-                        col += c;
+                        *col += '\r';
+                        *col += c;
                         break;
                 }
                 break;
@@ -259,10 +279,14 @@ bool CSVReader::next()
     }
 
     if (state == BEG)
+    {
+        cols.resize(ncols);
         return false;
+    }
 
-    if (!col.empty())
-        cols.push_back(col);
+    if (!col->empty())
+        ++ncols;
+    cols.resize(ncols);
 
     return true;
 }
@@ -48,12 +48,38 @@ namespace dballe
  */
 bool csv_read_next(FILE* in, std::vector<std::string>& cols);
 
+/**
+ * Read CSV data one line at a time.
+ *
+ * The input is read in blocks, and the columns of each line are parsed into
+ * the strings used for the previous line, so that reading a file does not
+ * allocate memory at each line.
+ *
+ * The current line can be used as a one-line lookahead, to stop reading at
+ * the boundary between messages without consuming the first line of the next
+ * one.
+ */
 class CSVReader
 {
 protected:
     std::istream* in;
 
-    int next_char();
+    /// Read buffer
+    std::vector<char> buf;
+    /// Position of the next character to return in buf
+    size_t buf_pos = 0;
+    /// Position of the end of the valid data in buf
+    size_t buf_end = 0;
+
+    /// Read the next block of input into buf, returning false on EOF
+    bool fill_buffer();
+
+    int next_char()
+    {
+        if (buf_pos == buf_end && !fill_buffer())
+            return EOF;
+        return (unsigned char)buf[buf_pos++];
+    }
 
 public:
     /**
@@ -121,12 +147,6 @@ public:
     static std::string unescape(const std::string& csvstr);
 };
 
-// TODO: CSV readers allowing to peek on the next line without consuming it, to
-// allow the Msg parser to stop at msg boundary after peeking at a line
-// also, stripping newlines at end of lines
-// also, reading from istream
-// also, de-escaping strings (if they start with quote)
-
 /**
  * Output a string value, quoted if needed according to CSV rules
  */
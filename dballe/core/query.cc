@@ -472,6 +472,13 @@ unsigned Query::parse_modifiers(const char* s)
                 else
                     got = 0;
                 break;
+            case 8:
+                /* "datetime": sort data by datetime first */
+                if (strncmp(s, "datetime", 8) == 0)
+                    modifiers |= DBA_DB_MODIFIER_SORT_BY_DATETIME;
+                else
+                    got = 0;
+                break;
             default:
                 got = 0;
                 break;
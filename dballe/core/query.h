@@ -21,6 +21,8 @@
 #define DBA_DB_MODIFIER_SUMMARY_DETAILS (1 << 8)
 /// Also get attributes alongside data
 #define DBA_DB_MODIFIER_WITH_ATTRIBUTES (1 << 9)
+/// Sort data by datetime before station
+#define DBA_DB_MODIFIER_SORT_BY_DATETIME (1 << 10)
 
 namespace dballe {
 namespace core {
@@ -1,10 +1,13 @@
 #include "tests.h"
 #include "values.h"
+#include "var.h"
+#include "dballe/values.h"
 #include <cstring>
 
 using namespace std;
 using namespace dballe::tests;
 using namespace dballe;
+using namespace wreport;
 
 namespace {
 
@@ -21,6 +24,57 @@ void Tests::register_tests()
 add_method("empty", []() {
 });
 
+add_method("encoder_reuse", []() {
+    Var var(varinfo(WR_VAR(0, 12, 101)), 280.0);
+    var.seta(newvar(WR_VAR(0, 33, 7), 50));
+    var.seta(newvar(WR_VAR(0, 1, 194), "test"));
+
+    core::value::Encoder enc;
+    std::vector<uint8_t> first = enc.encode_attributes(var);
+    wassert(actual(first.size()) == 2u + 4u + 2u + 5u);
+    const uint8_t* data = enc.buf.data();
+
+    // Encoding again replaces the contents and reuses the buffer
+    wassert(actual(enc.encode_attributes(var) == first).istrue());
+    wassert(actual(enc.buf.data() == data).istrue());
+
+    Values values;
+    values.set(newvar(WR_VAR(0, 33, 7), 50));
+    values.set(newvar(WR_VAR(0, 1, 194), "test"));
+    wassert(actual(enc.encode_values(values) == values.encode()).istrue());
+});
+
+add_method("decoder_views", []() {
+    Var var(varinfo(WR_VAR(0, 12, 101)), 280.0);
+    var.seta(newvar(WR_VAR(0, 33, 7), 50));
+    var.seta(newvar(WR_VAR(0, 1, 194), "test"));
+    core::value::Encoder enc;
+    enc.append_attributes(var);
+
+    std::vector<Varcode> codes;
+    wassert(actual(core::value::Decoder::foreach_view(enc.buf, [&](const core::value::VarView& v) {
+        codes.push_back(v.code());
+        if (v.code() == WR_VAR(0, 33, 7))
+        {
+            wassert(actual(v.cval == nullptr).istrue());
+            wassert(actual(v.ival) == 50);
+        } else {
+            wassert(actual(v.cval) == "test");
+            wassert(actual(v.to_var()->enqc()) == "test");
+        }
+        return true;
+    })).istrue());
+    wassert(actual(codes.size()) == 2u);
+
+    // Iteration can be stopped early
+    codes.clear();
+    wassert(actual(core::value::Decoder::foreach_view(enc.buf, [&](const core::value::VarView& v) {
+        codes.push_back(v.code());
+        return false;
+    })).isfalse());
+    wassert(actual(codes.size()) == 1u);
+});
+
 }
 
 }
@@ -1,5 +1,7 @@
 #include "values.h"
 #include "dballe/core/var.h"
+#include "dballe/values.h"
+#include <cstring>
 #include <arpa/inet.h>
 #include <ostream>
 
@@ -29,9 +31,8 @@ void Encoder::append_uint32(uint32_t val)
 
 void Encoder::append_cstring(const char* val)
 {
-    for ( ; *val; ++val)
-        buf.push_back(*val);
-    buf.push_back(0);
+    // Encode the string including its terminating zero
+    buf.insert(buf.end(), (const uint8_t*)val, (const uint8_t*)val + strlen(val) + 1);
 }
 
 void Encoder::append(const wreport::Var& var)
@@ -59,6 +60,29 @@ void Encoder::append_attributes(const wreport::Var& var)
         append(*a);
 }
 
+const std::vector<uint8_t>& Encoder::encode_attributes(const wreport::Var& var)
+{
+    buf.clear();
+    append_attributes(var);
+    return buf;
+}
+
+const std::vector<uint8_t>& Encoder::encode_values(const Values& values)
+{
+    buf.clear();
+    for (const auto& val: values)
+        append(*val);
+    return buf;
+}
+
+std::unique_ptr<wreport::Var> VarView::to_var() const
+{
+    if (cval)
+        return unique_ptr<wreport::Var>(new wreport::Var(info, cval));
+    else
+        return unique_ptr<wreport::Var>(new wreport::Var(info, ival));
+}
+
 Decoder::Decoder(const std::vector<uint8_t>& buf) : buf(buf.data()), size(buf.size()) {}
 
 uint16_t Decoder::decode_uint16()
@@ -97,18 +121,26 @@ const char* Decoder::decode_cstring()
 
 unique_ptr<wreport::Var> Decoder::decode_var()
 {
-    wreport::Varinfo info = varinfo(decode_uint16());
-    switch (info->type)
+    return decode_view().to_var();
+}
+
+VarView Decoder::decode_view()
+{
+    VarView res(varinfo(decode_uint16()));
+    switch (res.info->type)
     {
         case Vartype::Binary:
         case Vartype::String:
-            return unique_ptr<wreport::Var>(new wreport::Var(info, decode_cstring()));
+            res.cval = decode_cstring();
+            break;
         case Vartype::Integer:
         case Vartype::Decimal:
-            return unique_ptr<wreport::Var>(new wreport::Var(info, (int)decode_uint32()));
+            res.ival = (int)decode_uint32();
+            break;
         default:
-            error_consistency::throwf("unsupported variable type %d", (int)info->type);
+            error_consistency::throwf("unsupported variable type %d", (int)res.info->type);
     }
+    return res;
 }
 
 void Decoder::decode_attrs(const std::vector<uint8_t>& buf, wreport::Var& var)
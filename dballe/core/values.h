@@ -9,16 +9,62 @@ namespace dballe {
 namespace core {
 namespace value {
 
+/**
+ * Encode variables in the binary format used to store attributes.
+ *
+ * An Encoder can be reused for many encodings: clearing it keeps the
+ * allocated buffer, so that after the first few rows encoding does not need
+ * to allocate memory.
+ */
 struct Encoder
 {
     std::vector<uint8_t> buf;
 
     Encoder();
+    /// Empty the buffer, keeping its allocated memory
+    void clear() { buf.clear(); }
     void append_uint16(uint16_t val);
     void append_uint32(uint32_t val);
     void append_cstring(const char* val);
     void append(const wreport::Var& var);
     void append_attributes(const wreport::Var& var);
+
+    /**
+     * Replace the buffer contents with the encoded attributes of var.
+     *
+     * The result is valid until the next change to the encoder.
+     */
+    const std::vector<uint8_t>& encode_attributes(const wreport::Var& var);
+
+    /**
+     * Replace the buffer contents with the encoded values.
+     *
+     * The result is valid until the next change to the encoder.
+     */
+    const std::vector<uint8_t>& encode_values(const Values& values);
+};
+
+/**
+ * Encoded variable, pointing to the value in the buffer it has been decoded
+ * from.
+ *
+ * It gives access to the code and value of the variable without creating a
+ * wreport::Var, and is valid as long as the buffer it has been decoded from.
+ */
+struct VarView
+{
+    wreport::Varinfo info;
+    /// Value of String and Binary variables, nullptr for the others
+    const char* cval = nullptr;
+    /// Value of Integer and Decimal variables
+    int ival = 0;
+
+    VarView(wreport::Varinfo info) : info(info) {}
+
+    wreport::Varcode code() const { return info->code; }
+
+    /// Create a wreport::Var with this value
+    std::unique_ptr<wreport::Var> to_var() const;
 };
 
 struct Decoder
@@ -32,6 +78,25 @@ struct Decoder
     const char* decode_cstring();
     std::unique_ptr<wreport::Var> decode_var();
 
+    /// Decode the next variable without creating a wreport::Var
+    VarView decode_view();
+
+    /**
+     * Call dest with a view of each variable encoded in buf.
+     *
+     * Iteration stops at the first variable for which dest returns false.
+     * Returns false if iteration was stopped, true otherwise.
+     */
+    template<typename Dest>
+    static bool foreach_view(const std::vector<uint8_t>& buf, Dest dest)
+    {
+        Decoder dec(buf);
+        while (dec.size)
+            if (!dest(dec.decode_view()))
+                return false;
+        return true;
+    }
+
     /**
      * Decode the attributes of var from a buffer
      */
@@ -1,6 +1,7 @@
 #include "tests.h"
 #include "var.h"
 #include "varmatch.h"
+#include "values.h"
 
 using namespace wreport;
 using namespace dballe;
@@ -123,6 +124,20 @@ add_method("string", []() {
     wassert(actual((*Varmatch::parse("daniele<=B01011<=emanuele"))(var)).isfalse());
 });
 
+add_method("encoded", []() {
+    Var var(varinfo(WR_VAR(0, 12, 101)), 280.0);
+    var.seta(newvar(WR_VAR(0, 33, 7), 50));
+    var.seta(newvar(WR_VAR(0, 33, 40), 70));
+    core::value::Encoder enc;
+    enc.append_attributes(var);
+
+    wassert(actual(Varmatch::parse("B33007>40")->match_encoded(enc.buf)).istrue());
+    wassert(actual(Varmatch::parse("B33007>60")->match_encoded(enc.buf)).isfalse());
+    wassert(actual(Varmatch::parse("B33040=70")->match_encoded(enc.buf)).istrue());
+    wassert(actual(Varmatch::parse("B33036>0")->match_encoded(enc.buf)).isfalse());
+    wassert(actual(Varmatch::parse("B33007>0")->match_encoded(std::vector<uint8_t>())).isfalse());
+});
+
 add_method("errors", []() {
     wassert_throws(wreport::error_consistency, Varmatch::parse("B01011"));
     wassert_throws(wreport::error_consistency, Varmatch::parse("enrico"));
@@ -20,6 +20,7 @@
  */
 #include "varmatch.h"
 #include "dballe/var.h"
+#include "dballe/core/values.h"
 #include <functional>
 #include <cstdlib>
 #include <iostream>
@@ -37,6 +38,14 @@ bool Varmatch::operator()(const wreport::Var& var) const
     return var.code() == code;
 }
 
+bool Varmatch::match_encoded(const std::vector<uint8_t>& buf) const
+{
+    return !core::value::Decoder::foreach_view(buf, [&](const core::value::VarView& var) {
+        // Stop at the first match
+        return var.code() != code || !(*this)(*var.to_var());
+    });
+}
+
 namespace varmatch {
 
 template<typename T, typename OP>
@@ -2,6 +2,8 @@
 #define DBA_CORE_VARMATCH_H
 
 #include <memory>
+#include <vector>
+#include <cstdint>
 #include <wreport/var.h>
 
 namespace dballe {
@@ -18,6 +20,15 @@ struct Varmatch
 
     virtual bool operator()(const wreport::Var&) const;
 
+    /**
+     * Check if any of the variables in a buffer encoded with
+     * core::value::Encoder matches.
+     *
+     * Only the variables with a matching varcode are decoded to
+     * wreport::Var.
+     */
+    bool match_encoded(const std::vector<uint8_t>& buf) const;
+
     /**
      * Parse variable matcher from a string in the form
      * Bxxyyy{<|<=|=|>=|>}value or value<=Bxxyyy<=value
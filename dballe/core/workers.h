@@ -0,0 +1,198 @@
+#ifndef DBALLE_CORE_WORKERS_H
+#define DBALLE_CORE_WORKERS_H
+
+/** @file
+ * Pool of worker threads that return their results in submission order.
+ */
+
+#include <deque>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+
+namespace dballe {
+namespace core {
+
+/**
+ * Process inputs on a pool of worker threads, returning results in the same
+ * order as the inputs were submitted.
+ *
+ * Inputs are submitted and results are collected by the same thread:
+ * \code
+ * for (auto& in: inputs)
+ * {
+ *     if (workers.full())
+ *         consume(workers.pop());
+ *     workers.submit(std::move(in));
+ * }
+ * while (!workers.empty())
+ *     consume(workers.pop());
+ * \endcode
+ *
+ * The process function is called with the index of the worker thread, so
+ * that each worker can use its own non thread-safe state, and with a
+ * reference to the input, that it is free to modify.
+ *
+ * Exceptions raised while processing an input are rethrown by the pop() call
+ * that would have returned its result.
+ *
+ * Destroying the pool stops the workers after they finish the inputs they
+ * are currently processing; pending inputs that have not been started are
+ * discarded.
+ */
+template<typename Input, typename Output>
+class OrderedWorkers
+{
+public:
+    typedef std::function<Output(unsigned worker, Input& input)> process_func;
+
+protected:
+    struct Slot
+    {
+        Input input;
+        Output output;
+        std::exception_ptr error;
+        bool done = false;
+
+        Slot(Input&& input) : input(std::move(input)) {}
+    };
+
+    process_func process;
+    /// Maximum number of pending items before full() returns true
+    size_t max_pending;
+    std::mutex mutex;
+    /// Notified when a new input is available or when stopping
+    std::condition_variable cond_input;
+    /// Notified when an output is ready
+    std::condition_variable cond_output;
+    /// Items in submission order: the front is the next to be returned by pop()
+    std::deque<Slot> slots;
+    /// Number of items in slots that have already been given to a worker
+    size_t started = 0;
+    bool stopping = false;
+    std::vector<std::thread> threads;
+
+    void worker_main(unsigned worker)
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (true)
+        {
+            cond_input.wait(lock, [&] { return stopping || started < slots.size(); });
+            if (stopping)
+                return;
+
+            // References to deque elements stay valid when other elements are
+            // added at the end, and this one is not removed until it is done
+            Slot& slot = slots[started++];
+            lock.unlock();
+            try {
+                slot.output = process(worker, slot.input);
+            } catch (...) {
+                slot.error = std::current_exception();
+            }
+            lock.lock();
+            slot.done = true;
+            cond_output.notify_all();
+        }
+    }
+
+public:
+    /**
+     * Start \a workers threads.
+     *
+     * @param workers
+     *   Number of worker threads to start. At least one is always started.
+     * @param max_pending
+     *   Number of submitted items not yet returned by pop() after which full()
+     *   returns true. If 0, it defaults to 4 times the number of workers.
+     * @param process
+     *   Function called by the worker threads to turn an input into an output.
+     */
+    OrderedWorkers(unsigned workers, size_t max_pending, process_func process)
+        : process(process), max_pending(max_pending)
+    {
+        if (workers == 0)
+            workers = 1;
+        if (this->max_pending == 0)
+            this->max_pending = workers * 4;
+        threads.reserve(workers);
+        for (unsigned i = 0; i < workers; ++i)
+            threads.emplace_back([this, i] { worker_main(i); });
+    }
+    OrderedWorkers(const OrderedWorkers&) = delete;
+    OrderedWorkers(OrderedWorkers&&) = delete;
+    ~OrderedWorkers()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        cond_input.notify_all();
+        for (auto& t: threads)
+            t.join();
+    }
+    OrderedWorkers& operator=(const OrderedWorkers&) = delete;
+    OrderedWorkers& operator=(OrderedWorkers&&) = delete;
+
+    /// Number of worker threads
+    unsigned size() const { return threads.size(); }
+
+    /// Check if there are no pending items
+    bool empty()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        return slots.empty();
+    }
+
+    /// Check if the number of pending items reached the maximum
+    bool full()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        return slots.size() >= max_pending;
+    }
+
+    /// Queue a copy of an input for processing
+    void submit(const Input& input)
+    {
+        submit(Input(input));
+    }
+
+    /// Queue an input for processing
+    void submit(Input&& input)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            slots.emplace_back(std::move(input));
+        }
+        cond_input.notify_one();
+    }
+
+    /**
+     * Wait for the oldest pending item to be processed, and return its
+     * output.
+     *
+     * If processing raised an exception, it is rethrown here.
+     *
+     * It is an error to call this when empty() is true.
+     */
+    Output pop()
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        cond_output.wait(lock, [&] { return slots.front().done; });
+        Slot slot(std::move(slots.front()));
+        slots.pop_front();
+        --started;
+        lock.unlock();
+        if (slot.error)
+            std::rethrow_exception(slot.error);
+        return std::move(slot.output);
+    }
+};
+
+}
+}
+
+#endif
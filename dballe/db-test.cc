@@ -1,5 +1,10 @@
 #include "dballe/core/tests.h"
 #include "db.h"
+#include "dballe/core/data.h"
+#include "dballe/core/query.h"
+#include "dballe/db/v7/db.h"
+#include "dballe/db/v7/driver.h"
+#include "dballe/sql/sqlite.h"
 #include <cstring>
 
 using namespace dballe;
@@ -97,6 +102,154 @@ add_method("parse_wipe", []{
     wassert_false(opts->wipe);
 });
 
+add_method("parse_preload_levtr", []{
+    auto opts = DBConnectOptions::create("sqlite://test.sqlite");
+    wassert_false(opts->preload_levtr);
+
+    opts = DBConnectOptions::create("sqlite://test.sqlite?preload_levtr=yes");
+    wassert(actual(opts->url) == "sqlite://test.sqlite");
+    wassert_true(opts->preload_levtr);
+
+    opts = DBConnectOptions::create("sqlite://test.sqlite?wipe=1&preload_levtr");
+    wassert(actual(opts->url) == "sqlite://test.sqlite");
+    wassert_true(opts->wipe);
+    wassert_true(opts->preload_levtr);
+
+    opts = DBConnectOptions::create("sqlite://test.sqlite?preload_levtr=0");
+    wassert(actual(opts->url) == "sqlite://test.sqlite");
+    wassert_false(opts->preload_levtr);
+
+    wassert_throws(wreport::error_consistency, DBConnectOptions::create("sqlite://test.sqlite?preload_levtr=maybe"));
+});
+
+add_method("parse_integer_datetimes", []{
+    auto opts = DBConnectOptions::create("sqlite://test.sqlite");
+    wassert_false(opts->integer_datetimes);
+
+    opts = DBConnectOptions::create("sqlite://test.sqlite?wipe&integer_datetimes=yes");
+    wassert(actual(opts->url) == "sqlite://test.sqlite");
+    wassert_true(opts->wipe);
+    wassert_true(opts->integer_datetimes);
+
+    opts = DBConnectOptions::create("sqlite://test.sqlite?integer_datetimes=false");
+    wassert(actual(opts->url) == "sqlite://test.sqlite");
+    wassert_false(opts->integer_datetimes);
+});
+
+add_method("parse_partition_data", []{
+    auto opts = DBConnectOptions::create("postgresql://host/db");
+    wassert_false(opts->partition_data);
+
+    opts = DBConnectOptions::create("postgresql://host/db?wipe=yes&partition_data=yes");
+    wassert(actual(opts->url) == "postgresql://host/db");
+    wassert_true(opts->wipe);
+    wassert_true(opts->partition_data);
+});
+
+add_method("parse_query_indices", []{
+    auto opts = DBConnectOptions::create("sqlite://test.sqlite");
+    wassert_false(opts->query_indices);
+
+    opts = DBConnectOptions::create("sqlite://test.sqlite?query_indices=yes");
+    wassert(actual(opts->url) == "sqlite://test.sqlite");
+    wassert_true(opts->query_indices);
+
+    wassert_throws(wreport::error_consistency, DBConnectOptions::create("sqlite://test.sqlite?query_indices=maybe"));
+});
+
+add_method("parse_station_grid", []{
+    auto opts = DBConnectOptions::create("sqlite://test.sqlite");
+    wassert_false(opts->station_grid);
+
+    opts = DBConnectOptions::create("sqlite://test.sqlite?station_grid=yes");
+    wassert(actual(opts->url) == "sqlite://test.sqlite");
+    wassert_true(opts->station_grid);
+
+    wassert_throws(wreport::error_consistency, DBConnectOptions::create("sqlite://test.sqlite?station_grid=maybe"));
+});
+
+add_method("parse_write_behind", []{
+    auto opts = DBConnectOptions::create("sqlite://test.sqlite");
+    wassert(actual(opts->write_behind) == 0u);
+
+    opts = DBConnectOptions::create("sqlite://test.sqlite?write_behind=4");
+    wassert(actual(opts->url) == "sqlite://test.sqlite");
+    wassert(actual(opts->write_behind) == 4u);
+
+    wassert_throws(wreport::error_consistency, DBConnectOptions::create("sqlite://test.sqlite?write_behind=many"));
+    wassert_throws(wreport::error_consistency, DBConnectOptions::create("sqlite://test.sqlite?write_behind=-1"));
+});
+
+add_method("sqlite_bulk_profile", []{
+    auto opts = DBConnectOptions::create("sqlite://test.sqlite?profile=bulk");
+    wassert(actual(opts->url) == "sqlite://test.sqlite?profile=bulk");
+
+    // Count the secondary indices whose creation is deferred by bulk imports
+    auto count_indices = [] {
+        auto conn = sql::SQLiteConnection::create();
+        conn->open_file("test.sqlite");
+        auto s = conn->sqlitestatement("SELECT COUNT(*) FROM sqlite_master WHERE type='index' AND name IN ('pa_lon', 'data_lt')");
+        int res = 0;
+        s->execute_one([&]() { res = s->column_int(0); });
+        return res;
+    };
+
+    DB::connect(*DBConnectOptions::create("sqlite://test.sqlite?wipe=yes&profile=bulk"));
+    wassert(actual(count_indices()) == 0);
+
+    core::Data vals;
+    vals.station.report = "synop";
+    vals.station.coords = Coords(44.10, 11.50);
+    vals.level = Level(1);
+    vals.trange = Trange::instant();
+    vals.datetime = Datetime(2015, 4, 25, 12, 30, 45);
+    vals.values.set("B12101", 295.1);
+
+    // Opening the database and querying it does not create them, not even
+    // with the query methods of DB, that use a writable transaction
+    auto db = DB::connect(*DBConnectOptions::create("sqlite://test.sqlite?profile=reader"));
+    wassert(actual(count_indices()) == 0);
+    db->transaction(true)->rollback();
+    wassert(actual(count_indices()) == 0);
+    db->query_stations(core::Query());
+    wassert(actual(count_indices()) == 0);
+
+    // Reader connections do not create them even when writing
+    auto tr = db->transaction();
+    tr->insert_data(vals);
+    tr->commit();
+    wassert(actual(count_indices()) == 0);
+    db.reset();
+
+    // A writable transaction that does not write does not create them
+    db = DB::connect(*DBConnectOptions::create("sqlite://test.sqlite"));
+    tr = db->transaction();
+    tr->query_data(core::Query());
+    tr->commit();
+    wassert(actual(count_indices()) == 0);
+
+    // Writing to it without the bulk or reader profiles creates them
+    tr = db->transaction();
+    vals.datetime = Datetime(2015, 4, 25, 13, 0, 0);
+    tr->insert_data(vals);
+    tr->commit();
+    wassert(actual(count_indices()) == 2);
+});
+
+add_method("sqlite_build_deferred_indices", []{
+    DB::connect(*DBConnectOptions::create("sqlite://test.sqlite?wipe=yes&profile=bulk"));
+
+    // The indices can be created explicitly, also from a reader connection
+    auto db = std::dynamic_pointer_cast<dballe::db::v7::DB>(DB::connect(*DBConnectOptions::create("sqlite://test.sqlite?profile=reader")));
+    auto tr = db->transaction();
+    db->driver().build_deferred_indices();
+    tr->commit();
+
+    auto conn = sql::SQLiteConnection::create();
+    conn->open_file("test.sqlite");
+    wassert(actual(conn->get_setting("indices")) == "created");
+});
+
 }
 
 }
@@ -1,5 +1,7 @@
 #include "db.h"
 #include "db/db.h"
+#include "db/v7/db.h"
+#include "db/v7/sqlite/driver.h"
 #include "sql/sql.h"
 #include "core/string.h"
 #include "wreport/utils/string.h"
@@ -10,7 +12,7 @@ using namespace wreport;
 
 namespace dballe {
 
-static bool parse_wipe(const std::string& strval)
+static bool parse_bool(const char* name, const std::string& strval)
 {
     std::string val = str::lower(strval);
     if (val.empty()) return true;
@@ -20,7 +22,16 @@ static bool parse_wipe(const std::string& strval)
     if (val == "0") return false;
     if (val == "no") return false;
     if (val == "false") return false;
-    wreport::error_consistency::throwf("unsupported value for wipe: %s (supported: 1/0, true/false, yes/no)", strval.c_str());
+    wreport::error_consistency::throwf("unsupported value for %s: %s (supported: 1/0, true/false, yes/no)", name, strval.c_str());
+}
+
+static unsigned parse_unsigned(const char* name, const std::string& strval)
+{
+    char* end;
+    unsigned long val = strtoul(strval.c_str(), &end, 10);
+    if (strval.empty() || strval[0] == '-' || *end)
+        wreport::error_consistency::throwf("unsupported value for %s: %s (expected a number)", name, strval.c_str());
+    return val;
 }
 
 void DBConnectOptions::reset_actions()
@@ -35,10 +46,34 @@ std::unique_ptr<DBConnectOptions> DBConnectOptions::create(const std::string& ur
 
     std::string wipe;
     if (url_pop_query_string(res->url, "wipe", wipe))
-        res->wipe = parse_wipe(wipe);
+        res->wipe = parse_bool("wipe", wipe);
     else
         res->wipe = false;
 
+    std::string preload_levtr;
+    if (url_pop_query_string(res->url, "preload_levtr", preload_levtr))
+        res->preload_levtr = parse_bool("preload_levtr", preload_levtr);
+
+    std::string integer_datetimes;
+    if (url_pop_query_string(res->url, "integer_datetimes", integer_datetimes))
+        res->integer_datetimes = parse_bool("integer_datetimes", integer_datetimes);
+
+    std::string partition_data;
+    if (url_pop_query_string(res->url, "partition_data", partition_data))
+        res->partition_data = parse_bool("partition_data", partition_data);
+
+    std::string query_indices;
+    if (url_pop_query_string(res->url, "query_indices", query_indices))
+        res->query_indices = parse_bool("query_indices", query_indices);
+
+    std::string station_grid;
+    if (url_pop_query_string(res->url, "station_grid", station_grid))
+        res->station_grid = parse_bool("station_grid", station_grid);
+
+    std::string write_behind;
+    if (url_pop_query_string(res->url, "write_behind", write_behind))
+        res->write_behind = parse_unsigned("write_behind", write_behind);
+
     if (strncmp(url.c_str(), "test:", 5) == 0)
     {
         const char* envurl = getenv("DBA_DB");
@@ -119,8 +154,44 @@ std::shared_ptr<DB> DB::connect(const DBConnectOptions& opts)
     } else {
         auto conn(sql::Connection::create(opts));
         auto res = db::DB::create(conn);
+        if (opts.integer_datetimes)
+        {
+            auto v7db = std::dynamic_pointer_cast<db::v7::DB>(res);
+            auto driver = v7db ? dynamic_cast<db::v7::sqlite::Driver*>(&v7db->driver()) : nullptr;
+            if (!driver)
+                throw error_unimplemented("integer_datetimes is only supported on SQLite databases");
+            driver->create_integer_datetimes = true;
+        }
+        if (opts.partition_data)
+        {
+            auto v7db = std::dynamic_pointer_cast<db::v7::DB>(res);
+            if (!v7db || !v7db->driver().supports_partitions())
+                throw error_unimplemented("partition_data is only supported on PostgreSQL databases");
+            v7db->driver().create_partitioned = true;
+        }
+        if (opts.query_indices)
+            if (auto v7db = std::dynamic_pointer_cast<db::v7::DB>(res))
+                v7db->driver().create_query_indices = true;
+        if (opts.station_grid)
+            if (auto v7db = std::dynamic_pointer_cast<db::v7::DB>(res))
+                v7db->driver().create_station_grid = true;
         if (opts.wipe)
             res->reset();
+        else
+        {
+            if (opts.query_indices && conn->has_table("data"))
+                if (auto v7db = std::dynamic_pointer_cast<db::v7::DB>(res))
+                    v7db->driver().add_query_indices();
+            if (opts.station_grid && conn->has_table("station"))
+                if (auto v7db = std::dynamic_pointer_cast<db::v7::DB>(res))
+                    v7db->driver().add_station_grid();
+        }
+        if (opts.preload_levtr)
+            if (auto v7db = std::dynamic_pointer_cast<db::v7::DB>(res))
+                v7db->preload_levtr = true;
+        if (opts.write_behind)
+            if (auto v7db = std::dynamic_pointer_cast<db::v7::DB>(res))
+                v7db->write_behind = opts.write_behind;
         return res;
     }
 }
@@ -27,6 +27,68 @@ public:
     /// Wipe database on connection
     bool wipe = false;
 
+    /**
+     * Load the whole level/timerange table at the start of each transaction,
+     * so that queries do not need to look up levels and timeranges one by
+     * one.
+     *
+     * This is useful on databases with many distinct levels and timeranges.
+     */
+    bool preload_levtr = false;
+
+    /**
+     * When creating the tables of a SQLite database, store datetimes as
+     * integer seconds since the epoch instead of as text.
+     *
+     * This makes the data table smaller and datetime comparisons faster. It
+     * only has effect when the database is created or wiped: existing
+     * databases can be converted with `dbadb convert-datetimes`.
+     */
+    bool integer_datetimes = false;
+
+    /**
+     * When creating the tables of a PostgreSQL database, split measured data
+     * in monthly partitions.
+     *
+     * Queries on a datetime range only read the partitions of the months in
+     * the range, and all the data of a month can be removed at once with
+     * `dbadb drop-partition`. It only has effect when the database is created
+     * or wiped.
+     */
+    bool partition_data = false;
+
+    /**
+     * Create the optional indices for queries by variable code and datetime
+     * range without station constraints.
+     *
+     * They are created with the tables, or added to an existing database on
+     * connection. They make queries for maps of many stations faster, and
+     * imports slower.
+     */
+    bool query_indices = false;
+
+    /**
+     * Store with each station the cell of a 1 degree latitude/longitude grid
+     * that contains it, and index it.
+     *
+     * It is added with the tables, or to an existing database on connection.
+     * It makes queries by area faster on databases with many stations, like
+     * those with mobile reports.
+     */
+    bool station_grid = false;
+
+    /**
+     * If not 0, Transaction::import_messages() hands the messages to a
+     * separate thread that writes them to the database, and returns without
+     * waiting, unless this number of calls are already waiting to be written.
+     *
+     * Errors found while writing are raised by the next method called on the
+     * transaction, or by commit(). The messages are copied before being
+     * queued, so the caller can modify them as soon as import_messages()
+     * returns.
+     */
+    unsigned write_behind = 0;
+
     /**
      * Disable all the one-off actions set to perform on connection.
      *
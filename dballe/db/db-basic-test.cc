@@ -5,6 +5,7 @@
 #include "v7/repinfo.h"
 #include "v7/db.h"
 #include "v7/transaction.h"
+#include "v7/driver.h"
 #include "config.h"
 #include <cstring>
 #include <unistd.h>
@@ -639,6 +640,58 @@ this->add_method("transactions_after_fork", [](Fixture& f) {
     f.db->transaction();
 });
 
+this->add_method("partitions", [](Fixture& f) {
+    auto& driver = f.db->driver();
+    if (!driver.supports_partitions())
+        throw TestSkipped("partitions are not supported on this backend");
+
+    // Recreate the database with partitions, and throw it away at the end
+    f.destroys_db = true;
+    driver.create_partitioned = true;
+    f.db->reset();
+    driver.create_partitioned = false;
+    wassert_true(driver.is_partitioned());
+
+    core::Data data;
+    data.station.coords = Coords(12.0, 48.0);
+    data.station.report = "synop";
+    data.level = Level(1);
+    data.trange = Trange::instant();
+    data.values.set("B12101", 280.0);
+    for (const auto& dt: { Datetime(2020, 1, 31, 23, 59, 59), Datetime(2020, 2, 1), Datetime(2020, 12, 15), Datetime(2021, 1, 1) })
+    {
+        core::Data d = data;
+        d.datetime = dt;
+        f.db->insert_data(d);
+    }
+
+    core::Query query;
+    wassert(actual(f.db->query_data(query)->remaining()) == 4);
+    query.dtrange = DatetimeRange(Datetime(2020, 2, 1), Datetime(2020, 12, 31, 23, 59, 59));
+    wassert(actual(f.db->query_data(query)->remaining()) == 2);
+
+    {
+        auto tr = dynamic_pointer_cast<v7::Transaction>(f.db->transaction());
+        tr->drop_partition(2020, 1);
+        // Dropping a month without data is not an error
+        tr->drop_partition(2019, 6);
+        tr->commit();
+    }
+
+    query.clear();
+    auto cur = f.db->query_data(query);
+    wassert(actual(cur->remaining()) == 3);
+    wassert_true(cur->next());
+    wassert(actual(cur->get_datetime()) == Datetime(2020, 2, 1));
+    cur->discard();
+
+    // New data for the dropped month can be inserted again
+    core::Data d = data;
+    d.datetime = Datetime(2020, 1, 1);
+    f.db->insert_data(d);
+    wassert(actual(f.db->query_data(query)->remaining()) == 4);
+});
+
 }
 
 }
@@ -142,6 +142,47 @@ this->add_method("export", [](Fixture& f) {
     wassert(actual_var(*msgs[0], sc::temp_2m) == 290.0);
 });
 
+this->add_method("export_by_datetime", [](Fixture& f) {
+    // Export in chronological order, across stations
+    DBData test_data;
+    test_data.data["ds4"] = test_data.data["ds0"];
+    test_data.data["ds4"].station.coords = Coords(45.0, 11.0);
+    test_data.data["ds4"].datetime = Datetime(1945, 4, 25, 7, 0);
+    wassert(f.populate(test_data));
+
+    core::Data st;
+    st.station = test_data.data["ds0"].station;
+    st.values.set("B01001", 10);
+    f.tr->insert_station_data(st);
+
+    impl::Messages msgs = dballe::tests::messages_from_db(f.tr, "query=datetime");
+    wassert(actual(msgs.size()) == 5u);
+    wassert(actual(msgs[0]->get_datetime()) == Datetime(1945, 4, 25, 7, 0));
+    wassert(actual_var(*msgs[0], sc::latitude) == 45.0);
+    wassert(actual(*msgs[0]).is_undef(sc::block));
+    wassert(actual(msgs[1]->get_datetime()) == Datetime(1945, 4, 25, 8, 0));
+    wassert(actual_var(*msgs[1], sc::latitude) == 12.34560);
+    wassert(actual_var(*msgs[1], sc::block) == 10);
+    for (unsigned i = 2; i < 5; ++i)
+        wassert(actual(msgs[i]->get_datetime()) == Datetime(1945, 4, 26, 8, 0));
+
+    // Station values are added to all the messages of their station
+    unsigned with_block = 0;
+    for (const auto& msg: msgs)
+        if (msg->get_ident().is_missing() && msg->get_coords() == Coords(12.34560, 76.54321))
+        {
+            wassert(actual_var(*msg, sc::block) == 10);
+            ++with_block;
+        }
+    wassert(actual(with_block) == 2u);
+
+    // The default order is by station first
+    msgs = dballe::tests::messages_from_db(f.tr, core::Query());
+    wassert(actual(msgs.size()) == 5u);
+    wassert(actual(msgs[0]->get_datetime()) == Datetime(1945, 4, 25, 8, 0));
+    wassert(actual(msgs[1]->get_datetime()) == Datetime(1945, 4, 26, 8, 0));
+});
+
 this->add_method("missing_repmemo", [](Fixture& f) {
     // Text exporting of extra station information
     core::Query query;
@@ -296,6 +296,67 @@ class Tests : public FixtureTestCase<EmptyTransactionFixture<DB>>
             wassert(actual(export_third.size()) == 1);
             wassert(actual(diff_msg(third, export_third[0], "third")) == 0);
         });
+        this->add_method("write_behind", [](Fixture& f) {
+            // Imports written by a separate thread are visible to the
+            // following queries, and their errors are raised by the next call
+            f.db->write_behind = 2;
+            try {
+                impl::Messages msgs1 = read_msgs("bufr/obs0-1.22.bufr", Encoding::BUFR);
+                impl::Messages msgs2 = read_msgs("bufr/obs0-3.504.bufr", Encoding::BUFR);
+
+                f.tr->remove_all();
+                for (unsigned i = 0; i < 5; ++i)
+                {
+                    wassert(f.tr->import_messages(msgs1, default_opts));
+                    wassert(f.tr->import_messages(msgs2, default_opts));
+                }
+
+                core::Query query;
+                auto cur = f.tr->query_stations(query);
+                wassert(actual(cur->remaining()) == 2);
+
+                // A message with data but without datetime fails to import
+                auto broken = impl::Message::downcast(std::shared_ptr<dballe::Message>(msgs1[0]->clone()));
+                broken->station_data.unset(WR_VAR(0, 4, 1));
+                impl::Messages msgs3;
+                msgs3.emplace_back(broken);
+                wassert(f.tr->import_messages(msgs3, default_opts));
+                wassert_throws(wreport::error_notfound, f.tr->query_stations(query));
+            } catch (...) {
+                f.db->write_behind = 0;
+                throw;
+            }
+            f.db->write_behind = 0;
+        });
+        this->add_method("write_behind_copy", [](Fixture& f) {
+            // Messages can be modified while their import is queued
+            f.db->write_behind = 2;
+            try {
+                impl::Messages msgs = read_msgs("bufr/obs0-1.22.bufr", Encoding::BUFR);
+                impl::Messages orig = read_msgs("bufr/obs0-1.22.bufr", Encoding::BUFR);
+                auto msg = impl::Message::downcast(msgs[0]);
+
+                f.tr->remove_all();
+                wassert(f.tr->import_messages(msgs, default_opts));
+
+                // Without the datetime the message would fail to import
+                msg->station_data.unset(WR_VAR(0, 4, 1));
+                msg->set_temp_2m(200.0);
+
+                auto expected = impl::Message::downcast(orig[0]);
+                expected->set_rep_memo(impl::Message::repmemo_from_type(expected->type));
+
+                core::Query query;
+                query.report = impl::Message::repmemo_from_type(expected->type);
+                impl::Messages exported = dballe::tests::messages_from_db(f.tr, query);
+                wassert(actual(exported.size()) == 1u);
+                wassert(actual(diff_msg(expected, exported[0], "write_behind_copy")) == 0);
+            } catch (...) {
+                f.db->write_behind = 0;
+                throw;
+            }
+            f.db->write_behind = 0;
+        });
         this->add_method("varlist", [](Fixture& f) {
             // Import filtering by varlist. See: #149
             auto opts = DBImportOptions::create();
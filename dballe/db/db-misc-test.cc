@@ -1,6 +1,8 @@
 #include "dballe/db/tests.h"
 #include "v7/db.h"
 #include "v7/transaction.h"
+#include "dballe/msg/msg.h"
+#include "dballe/core/enq.h"
 #include "config.h"
 #include <algorithm>
 #include <cstring>
@@ -23,6 +25,23 @@ struct NavileDataSet : public TestDataSet
     }
 };
 
+/// Enq that keeps a copy of the variable looked up by code
+struct EnqVar : public impl::Enq
+{
+    std::unique_ptr<Var> var;
+
+    using Enq::Enq;
+    const char* name() const override { return "enq_var"; }
+    void set_bool(bool val) override { throw_notfound(); }
+    void set_int(int val) override { throw_notfound(); }
+    void set_dballe_int(int val) override { throw_notfound(); }
+    void set_var_value(const wreport::Var& val) override
+    {
+        missing = false;
+        var.reset(new Var(val));
+    }
+};
+
 unsigned run_attr_query_data(std::shared_ptr<db::Transaction> tr, int data_id, Values& dest)
 {
     unsigned count = 0;
@@ -336,6 +355,41 @@ this->add_method("delete_notfound", [](Fixture& f) {
     wassert(actual(cur->remaining()) == 4);
     cur->discard();
 });
+this->add_method("delete_attr_filter", [](Fixture& f) {
+    // Delete with attr_filter more values than are removed by a single
+    // DELETE statement
+    core::Data base;
+    base.station.coords = Coords(12.0, 48.0);
+    base.station.report = "synop";
+    base.level = Level(1);
+    base.trange = Trange::instant();
+    int start = Date(2000, 1, 1).to_julian();
+    for (unsigned i = 0; i < 2500; ++i)
+    {
+        core::Data d = base;
+        d.datetime = Datetime::from_julian(start + i / 2, i % 2 ? 12 : 0, 0, 0);
+        d.values.set("B12101", 280.0);
+        f.tr->insert_data(d);
+
+        Values qc;
+        qc.set("B33007", i % 5 ? 80 : 30);
+        f.tr->attr_insert_data(d.values.value(WR_VAR(0, 12, 101)).data_id, qc);
+    }
+
+    core::Query query;
+    query.attr_filter = "B33007>50";
+    f.tr->remove_data(query);
+
+    query.clear();
+    auto cur = f.tr->query_data(query);
+    wassert(actual(cur->remaining()) == 500);
+    cur->discard();
+
+    query.attr_filter = "B33007<50";
+    cur = f.tr->query_data(query);
+    wassert(actual(cur->remaining()) == 500);
+    cur->discard();
+});
 this->add_method("query_datetime", [](Fixture& f) {
     // Test datetime queries
     /* Prepare test data */
@@ -612,6 +666,69 @@ this->add_method("query_ana_filter", [](Fixture& f) {
     wassert(actual(cur->remaining()) == 0);
     cur->discard();
 });
+this->add_method("query_attrs_lazy", [](Fixture& f) {
+    // Attributes selected with query=attrs are decoded on access
+    OldDballeTestDataSet oldf;
+    wassert(f.populate(oldf));
+
+    Values qc;
+    qc.set("B33007", 50);
+    qc.set("B33036", 75);
+    wassert(f.tr->attr_insert_data(oldf.data["metar"].values.value(WR_VAR(0, 1, 11)).data_id, qc));
+
+    core::Query q = core_query_from_string("rep_memo=metar, var=B01011");
+    q.query = "attrs";
+    auto cur = f.tr->query_data(q);
+    wassert(actual(cur->remaining()) == 1);
+    cur->next();
+
+    // Looking up the variable by code, before anything else decoded the
+    // attributes, gives the variable with its attributes
+    {
+        EnqVar enq("B01011", 6);
+        dynamic_cast<db::CursorData*>(cur.get())->enq(enq);
+        wassert_false(enq.missing);
+        const Var* attr = enq.var->enqa(WR_VAR(0, 33, 7));
+        wassert(actual(attr).istrue());
+        wassert(actual(attr->enqi()) == 50);
+        wassert(actual(enq.var->enqa(WR_VAR(0, 33, 36))).istrue());
+    }
+
+    // query_attrs reads the attributes from the cursor
+    qc.clear();
+    dynamic_cast<db::CursorData*>(cur.get())->query_attrs([&](unique_ptr<Var> attr) { qc.set(move(attr)); });
+    wassert(actual(qc.size()) == 2);
+    wassert(actual(qc.var(WR_VAR(0, 33, 7)).enqi()) == 50);
+    wassert(actual(qc.var(WR_VAR(0, 33, 36)).enqi()) == 75);
+
+    // get_var returns the variable with its attributes
+    Var var = cur->get_var();
+    wassert(actual(var.code()) == WR_VAR(0, 1, 11));
+    const Var* attr = var.enqa(WR_VAR(0, 33, 7));
+    wassert(actual(attr).istrue());
+    wassert(actual(attr->enqi()) == 50);
+    attr = var.enqa(WR_VAR(0, 33, 36));
+    wassert(actual(attr).istrue());
+    wassert(actual(attr->enqi()) == 75);
+
+    // Accessing attributes a second time gives the same result
+    var = cur->get_var();
+    wassert(actual(var.enqa(WR_VAR(0, 33, 7))).istrue());
+    cur->discard();
+
+    // The same happens with station data
+    wassert(f.tr->attr_insert_station(oldf.stations["synop"].values.value(WR_VAR(0, 7, 30)).data_id, qc));
+    q = core_query_from_string("rep_memo=synop, var=B07030");
+    q.query = "attrs";
+    auto scur = f.tr->query_station_data(q);
+    wassert(actual(scur->remaining()) == 1);
+    scur->next();
+    EnqVar enq("B07030", 6);
+    dynamic_cast<db::CursorStationData*>(scur.get())->enq(enq);
+    wassert_false(enq.missing);
+    wassert(actual(enq.var->enqa(WR_VAR(0, 33, 7))).istrue());
+    wassert(actual(enq.var->enqa(WR_VAR(0, 33, 36))).istrue());
+});
 this->add_method("query_station_best", [](Fixture& f) {
     // Reproduce a querybest scenario which produced invalid SQL
     OldDballeTestDataSet oldf;
@@ -949,6 +1066,54 @@ this->add_method("fd_leaks", [](Fixture& f) {
     }
 });
 
+this->add_method("write_behind_error", [](Fixture& f) {
+    // After a queued import fails, the transaction raises the error again
+    // until it is rolled back, and cannot be committed
+    impl::Messages msgs = read_msgs("bufr/obs0-1.22.bufr", Encoding::BUFR);
+    // A message with data but without datetime fails to import
+    auto broken = impl::Message::downcast(std::shared_ptr<dballe::Message>(msgs[0]->clone()));
+    broken->station_data.unset(WR_VAR(0, 4, 1));
+    impl::Messages broken_msgs;
+    broken_msgs.emplace_back(broken);
+    impl::DBImportOptions opts;
+
+    f.db->write_behind = 2;
+    try {
+        auto tr = f.db->transaction();
+        bool failed = false;
+        for (unsigned i = 0; i < 8; ++i)
+        {
+            const impl::Messages& to_import = i == 3 ? broken_msgs : msgs;
+            if (failed)
+                wassert_throws(wreport::error_notfound, tr->import_messages(to_import, opts));
+            else
+            {
+                try {
+                    tr->import_messages(to_import, opts);
+                } catch (wreport::error_notfound&) {
+                    failed = true;
+                }
+            }
+        }
+        wassert_throws(wreport::error_notfound, tr->commit());
+        wassert_throws(wreport::error_notfound, tr->commit());
+        wassert_throws(wreport::error_notfound, tr->query_stations(core::Query()));
+        wassert(tr->rollback());
+
+        // Nothing has been written, including the messages before the
+        // failed one
+        tr = f.db->transaction();
+        auto cur = tr->query_stations(core::Query());
+        wassert(actual(cur->remaining()) == 0);
+        cur.reset();
+        tr->rollback();
+    } catch (...) {
+        f.db->write_behind = 0;
+        throw;
+    }
+    f.db->write_behind = 0;
+});
+
 }
 
 }
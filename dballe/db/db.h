@@ -29,6 +29,7 @@ struct DBImportOptions : public dballe::DBImportOptions
 {
     DBImportOptions() = default;
     DBImportOptions(const DBImportOptions& o) = default;
+    DBImportOptions(const dballe::DBImportOptions& o) : dballe::DBImportOptions(o) {}
     DBImportOptions(DBImportOptions&& o) = default;
     DBImportOptions& operator=(const DBImportOptions&) = default;
     DBImportOptions& operator=(DBImportOptions&&) = default;
@@ -41,7 +41,35 @@ add_method("levtr", [] {
     wassert(actual(*cache.find_entry(1)) == lt);
     wassert(actual(cache.find_id(lt)) == 1);
 
-    wassert(actual(cache.reverse[lt.level].size()) == 1u);
+    wassert(actual(cache.size()) == 1u);
+});
+
+add_method("levtr_many", [] {
+    db::v7::LevTrCache cache;
+
+    // Insert enough entries to resize the indices a few times
+    vector<const db::v7::LevTrEntry*> entries;
+    for (int i = 1; i <= 1000; ++i)
+        entries.push_back(cache.insert(db::v7::LevTrEntry(i, Level(103, i), Trange(254, 0, i % 3))));
+    wassert(actual(cache.size()) == 1000u);
+
+    // Pointers to entries stay valid as the cache grows
+    for (int i = 1; i <= 1000; ++i)
+    {
+        wassert_true(cache.find_entry(i) == entries[i - 1]);
+        wassert(actual(cache.find_id(db::v7::LevTrEntry(Level(103, i), Trange(254, 0, i % 3)))) == i);
+    }
+    wassert_false(cache.find_entry(1001));
+    wassert(actual(cache.find_id(db::v7::LevTrEntry(Level(103, 1), Trange(254, 0, 0)))) == MISSING_INT);
+
+    // Inserting the same ID with different data is an error
+    wassert_throws(std::runtime_error, cache.insert(db::v7::LevTrEntry(1, Level(103, 2), Trange(254, 0, 1))));
+
+    cache.complete = true;
+    cache.clear();
+    wassert(actual(cache.size()) == 0u);
+    wassert_false(cache.complete);
+    wassert_false(cache.find_entry(1));
 });
 
 }
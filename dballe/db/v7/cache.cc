@@ -1,5 +1,7 @@
 #include "cache.h"
 #include <ostream>
+#include <stdexcept>
+#include <cstdint>
 
 using namespace std;
 
@@ -33,87 +35,145 @@ std::ostream& operator<<(std::ostream& out, const LevTrEntry& l)
     return out << ":" << l.level << ":" << l.trange;
 }
 
-int LevTrReverseIndex::find_id(const LevTrEntry& lt) const
+namespace {
+
+/// Finalizer from MurmurHash3, to spread the bits of the key on the hash
+inline uint64_t mix(uint64_t h)
 {
-    auto li = find(lt.level);
-    if (li == end())
-        return MISSING_INT;
-    for (auto i: li->second)
-        if (i->level == lt.level && i->trange == lt.trange)
-            return i->id;
-    return MISSING_INT;
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return h;
 }
 
-void LevTrReverseIndex::add(const LevTrEntry* lt)
+inline uint64_t pack(int a, int b)
 {
-    auto li = find(lt->level);
-    if (li == end())
-        insert(make_pair(lt->level, std::vector<const LevTrEntry*>{lt}));
-    else
-        li->second.push_back(lt);
+    return ((uint64_t)(uint32_t)a << 32) | (uint32_t)b;
+}
+
+inline uint64_t hash_id(int id)
+{
+    return mix((uint32_t)id);
+}
+
+inline uint64_t hash_levtr(const Level& level, const Trange& trange)
+{
+    uint64_t h = mix(pack(level.ltype1, level.l1));
+    h = mix(h ^ pack(level.ltype2, level.l2));
+    h = mix(h ^ pack(trange.pind, trange.p1));
+    return mix(h ^ (uint32_t)trange.p2);
+}
+
+}
+
+void LevTrCache::rehash(size_t size)
+{
+    size_t capacity = by_id.empty() ? 64 : by_id.size();
+    while (capacity < size * 2)
+        capacity *= 2;
+    if (capacity == by_id.size())
+        return;
+
+    by_id.assign(capacity, 0);
+    by_levtr.assign(capacity, 0);
+    for (unsigned pos = 0; pos < entries.size(); ++pos)
+        index(pos);
 }
 
+void LevTrCache::index(unsigned pos)
+{
+    const LevTrEntry& e = entries[pos];
+    size_t mask = by_id.size() - 1;
+
+    size_t i = hash_id(e.id) & mask;
+    while (by_id[i])
+        i = (i + 1) & mask;
+    by_id[i] = pos + 1;
+
+    i = hash_levtr(e.level, e.trange) & mask;
+    while (by_levtr[i])
+    {
+        // If the same level and time range is already indexed, keep the
+        // existing entry
+        const LevTrEntry& o = entries[by_levtr[i] - 1];
+        if (o.level == e.level && o.trange == e.trange)
+            return;
+        i = (i + 1) & mask;
+    }
+    by_levtr[i] = pos + 1;
+}
 
-LevTrCache::~LevTrCache()
+void LevTrCache::reserve(size_t size)
 {
-    for (auto& i: by_id)
-        delete i.second;
+    rehash(size);
 }
 
 void LevTrCache::clear()
 {
-    for (auto& i: by_id)
-        delete i.second;
+    entries.clear();
+    // Keep the allocated memory, in case the cache is filled again
     by_id.clear();
-    reverse.clear();
+    by_levtr.clear();
+    complete = false;
 }
 
 const LevTrEntry* LevTrCache::find_entry(int id) const
 {
-    auto i = by_id.find(id);
-    if (i == by_id.end())
+    if (by_id.empty())
         return nullptr;
-    return i->second;
+    size_t mask = by_id.size() - 1;
+    for (size_t i = hash_id(id) & mask; by_id[i]; i = (i + 1) & mask)
+    {
+        const LevTrEntry& e = entries[by_id[i] - 1];
+        if (e.id == id)
+            return &e;
+    }
+    return nullptr;
 }
 
 const LevTrEntry* LevTrCache::insert(const LevTrEntry& e)
 {
-    return insert(std::unique_ptr<LevTrEntry>(new LevTrEntry(e)));
+    return insert(e, e.id);
 }
 
 const LevTrEntry* LevTrCache::insert(const LevTrEntry& e, int id)
 {
-    std::unique_ptr<LevTrEntry> ne(new LevTrEntry(e));
-    ne->id = id;
-    return insert(move(ne));
-}
-
-const LevTrEntry* LevTrCache::insert(std::unique_ptr<LevTrEntry> e)
-{
-    if (e->id == MISSING_INT)
-        throw std::runtime_error("station to cache in transaction state must have a database ID");
+    if (id == MISSING_INT)
+        throw std::runtime_error("levtr to cache in transaction state must have a database ID");
 
-    auto i = this->by_id.find(e->id);
-    if (i != this->by_id.end())
+    if (const LevTrEntry* found = find_entry(id))
     {
-        // StationCache do not move: if we have a match on the ID, we just need to
-        // enforce that there is no mismatch on the station data
-        if (*i->second != *e)
+        // Cached entries do not move: if we have a match on the ID, we just
+        // need to enforce that there is no mismatch on the level and time
+        // range
+        if (found->level != e.level || found->trange != e.trange)
             throw std::runtime_error("cannot replace a cached DB entry with one with the same ID and different data");
-        return i->second;
+        return found;
     }
 
-    const LevTrEntry* res = e.get();
-    this->by_id.insert(make_pair(res->id, e.release()));
-    reverse.add(res);
-    return res;
+    if ((entries.size() + 1) * 2 > by_id.size())
+        rehash(entries.size() + 1);
+    entries.emplace_back(id, e.level, e.trange);
+    index(entries.size() - 1);
+    return &entries.back();
 }
 
 int LevTrCache::find_id(const LevTrEntry& e) const
 {
     if (e.id != MISSING_INT)
         return e.id;
-    return reverse.find_id(e);
+    if (by_levtr.empty())
+        return MISSING_INT;
+    size_t mask = by_levtr.size() - 1;
+    for (size_t i = hash_levtr(e.level, e.trange) & mask; by_levtr[i]; i = (i + 1) & mask)
+    {
+        const LevTrEntry& o = entries[by_levtr[i] - 1];
+        if (o.level == e.level && o.trange == e.trange)
+            return o.id;
+    }
+    return MISSING_INT;
 }
 
 }
@@ -2,8 +2,7 @@
 #define DBALLE_DB_V7_CACHE_H
 
 #include <dballe/types.h>
-#include <unordered_map>
-#include <memory>
+#include <deque>
 #include <vector>
 #include <iosfwd>
 
@@ -36,30 +35,60 @@ struct LevTrEntry
 
 std::ostream& operator<<(std::ostream&, const LevTrEntry&);
 
-struct LevTrReverseIndex : public std::unordered_map<Level, std::vector<const LevTrEntry*>>
-{
-    int find_id(const LevTrEntry& st) const;
-    void add(const LevTrEntry* st);
-};
-
-
+/**
+ * Cache of LevTrEntry objects, indexed both by database ID and by level and
+ * time range.
+ *
+ * Entries are stored in a deque, so that pointers to them stay valid as new
+ * entries are added. The indices are flat open addressing hash tables of
+ * positions in the deque.
+ */
 struct LevTrCache
 {
-    std::unordered_map<int, LevTrEntry*> by_id;
-    LevTrReverseIndex reverse;
+protected:
+    /// Cached entries
+    std::deque<LevTrEntry> entries;
+
+    /**
+     * Open addressing hash table of entries hashed by ID.
+     *
+     * Each slot contains the position of the entry in entries, plus one, or 0
+     * if the slot is empty.
+     */
+    std::vector<unsigned> by_id;
+
+    /// Same as by_id, but hashed by level and time range
+    std::vector<unsigned> by_levtr;
+
+    /// Resize the indices to fit at least \a size entries
+    void rehash(size_t size);
+
+    /// Add entries[pos] to the indices
+    void index(unsigned pos);
+
+public:
+    /**
+     * True if the cache contains all the contents of the levtr table, and
+     * there is no need to prefetch entries before a query.
+     */
+    bool complete = false;
 
     LevTrCache() = default;
     LevTrCache(const LevTrCache&) = delete;
     LevTrCache(LevTrCache&&) = delete;
     LevTrCache& operator=(const LevTrCache&) = delete;
     LevTrCache& operator=(LevTrCache&&) = delete;
-    ~LevTrCache();
+
+    /// Number of cached entries
+    size_t size() const { return entries.size(); }
+
+    /// Preallocate the indices to fit \a size entries
+    void reserve(size_t size);
 
     const LevTrEntry* find_entry(int id) const;
 
     const LevTrEntry* insert(const LevTrEntry& e);
     const LevTrEntry* insert(const LevTrEntry& e, int id);
-    const LevTrEntry* insert(std::unique_ptr<LevTrEntry> e);
 
     int find_id(const LevTrEntry& e) const;
 
@@ -44,7 +44,7 @@ void StationRows::enq(impl::Enq& enq) const
 
 void StationDataRows::enq(impl::Enq& enq) const
 {
-    if (enq.search_b_value(cur->value)) return;
+    if (enq.search_b_value(cur->value_with_attrs())) return;
 
     const auto key = enq.key;
     const auto len = enq.len;
@@ -60,11 +60,11 @@ void StationDataRows::enq(impl::Enq& enq) const
         case "lon":         enq.set_lon(cur->station.coords.lon);
         case "coords":      enq.set_coords(cur->station.coords);
         case "station":     enq.set_station(cur->station);
-        case "var":         enq.set_varcode(cur->value.code());
-        case "variable":    enq.set_var(cur->value.get());
-        case "attrs":       enq.set_attrs(cur->value.get());
-        case "context_id":  enq.set_dballe_int(cur->value.data_id);
-        default:            enq.search_alias_value(cur->value);
+        case "var":         enq.set_varcode(cur->code());
+        case "variable":    enq.set_var(cur->value_with_attrs().get());
+        case "attrs":       enq.set_attrs(cur->value_with_attrs().get());
+        case "context_id":  enq.set_dballe_int(cur->data_id());
+        default:            enq.search_alias_value(cur->value_with_attrs());
     }
 }
 
@@ -74,7 +74,7 @@ void StationDataRows::enq(impl::Enq& enq) const
 
 void BaseDataRows::enq(impl::Enq& enq) const
 {
-    if (enq.search_b_value(cur->value)) return;
+    if (enq.search_b_value(cur->value_with_attrs())) return;
 
     const auto key = enq.key;
     const auto len = enq.len;
@@ -106,11 +106,11 @@ void BaseDataRows::enq(impl::Enq& enq) const
         case "pindicator":  enq.set_dballe_int(get_levtr().trange.pind);
         case "p1":          enq.set_dballe_int(get_levtr().trange.p1);
         case "p2":          enq.set_dballe_int(get_levtr().trange.p2);
-        case "var":         enq.set_varcode(cur->value.code());
-        case "variable":    enq.set_var(cur->value.get());
-        case "attrs":       enq.set_attrs(cur->value.get());
-        case "context_id":  enq.set_dballe_int(cur->value.data_id);
-        default:            enq.search_alias_value(cur->value);
+        case "var":         enq.set_varcode(cur->code());
+        case "variable":    enq.set_var(cur->value_with_attrs().get());
+        case "attrs":       enq.set_attrs(cur->value_with_attrs().get());
+        case "context_id":  enq.set_dballe_int(cur->data_id());
+        default:            enq.search_alias_value(cur->value_with_attrs());
     }
 }
 
@@ -13,6 +13,7 @@
 #include "dballe/core/var.h"
 #include "dballe/core/data.h"
 #include "dballe/core/query.h"
+#include "dballe/core/values.h"
 #include "wreport/var.h"
 #include <unordered_map>
 #include <cstring>
@@ -50,6 +51,7 @@ const DBValues& StationRows::values() const
 {
     if (!cur->values.get())
     {
+        tr->sync_imports();
         cur->values.reset(new DBValues);
         Tracer<> trc(tr->trc ? tr->trc->trace_add_station_vars() : nullptr);
         // FIXME: this could be made more efficient by querying all matching
@@ -64,8 +66,8 @@ const DBValues& StationRows::values() const
 void StationDataRows::load(Tracer<>& trc, const DataQueryBuilder& qb)
 {
     results.clear();
-    tr->station_data().run_station_data_query(trc, qb, [&](const dballe::DBStation& station, int id_data, std::unique_ptr<wreport::Var> var) {
-        results.emplace_back(station, id_data, std::move(var));
+    tr->station_data().run_station_data_query(trc, qb, [&](const dballe::DBStation& station, int id_data, std::unique_ptr<wreport::Var> var, std::vector<uint8_t>&& attrs) {
+        results.emplace_back(station, id_data, std::move(var), std::move(attrs));
     });
     at_start = true;
     cur = results.begin();
@@ -75,17 +77,18 @@ void DataRows::load(Tracer<>& trc, const DataQueryBuilder& qb)
 {
     results.clear();
     std::set<int> ids;
-    tr->data().run_data_query(trc, qb, [&](const dballe::DBStation& station, int id_levtr, const Datetime& datetime, int id_data, std::unique_ptr<wreport::Var> var) {
-        results.emplace_back(station, id_levtr, datetime, id_data, std::move(var));
-        ids.insert(id_levtr);
+    bool prefetch = !tr->levtr().is_preloaded();
+    tr->data().run_data_query(trc, qb, [&](const dballe::DBStation& station, int id_levtr, const Datetime& datetime, int id_data, std::unique_ptr<wreport::Var> var, std::vector<uint8_t>&& attrs) {
+        results.emplace_back(station, id_levtr, datetime, id_data, std::move(var), std::move(attrs));
+        if (prefetch) ids.insert(id_levtr);
     });
     at_start = true;
     cur = results.begin();
 
-    tr->levtr().prefetch_ids(trc, ids);
+    if (prefetch) tr->levtr().prefetch_ids(trc, ids);
 }
 
-bool DataRows::add_to_best_results(const dballe::DBStation& station, int id_levtr, const Datetime& datetime, int id_data, std::unique_ptr<wreport::Var> var)
+bool DataRows::add_to_best_results(const dballe::DBStation& station, int id_levtr, const Datetime& datetime, int id_data, std::unique_ptr<wreport::Var> var, std::vector<uint8_t>&& attrs)
 {
     int prio = tr->repinfo().get_priority(station.report);
 
@@ -94,18 +97,18 @@ bool DataRows::add_to_best_results(const dballe::DBStation& station, int id_levt
     if (station.ident != results.back().station.ident) goto append;
     if (id_levtr != results.back().id_levtr) goto append;
     if (datetime != results.back().datetime) goto append;
-    if (var->code() != results.back().value.code()) goto append;
+    if (var->code() != results.back().code()) goto append;
 
     if (prio <= insert_cur_prio) return false;
 
     // Replace
     results.back().station = station;
-    results.back().value = DBValue(id_data, std::move(var));
+    results.back().replace_value(id_data, std::move(var), std::move(attrs));
     insert_cur_prio = prio;
     return true;
 
 append:
-    results.emplace_back(station, id_levtr, datetime, id_data, std::move(var));
+    results.emplace_back(station, id_levtr, datetime, id_data, std::move(var), std::move(attrs));
     insert_cur_prio = prio;
     return true;
 }
@@ -114,28 +117,30 @@ void DataRows::load_best(Tracer<>& trc, const DataQueryBuilder& qb)
 {
     results.clear();
     set<int> ids;
-    tr->data().run_data_query(trc, qb, [&](const dballe::DBStation& station, int id_levtr, const Datetime& datetime, int id_data, std::unique_ptr<wreport::Var> var) {
-        if (add_to_best_results(station, id_levtr, datetime, id_data, move(var)))
+    bool prefetch = !tr->levtr().is_preloaded();
+    tr->data().run_data_query(trc, qb, [&](const dballe::DBStation& station, int id_levtr, const Datetime& datetime, int id_data, std::unique_ptr<wreport::Var> var, std::vector<uint8_t>&& attrs) {
+        if (add_to_best_results(station, id_levtr, datetime, id_data, move(var), move(attrs)) && prefetch)
             ids.insert(id_levtr);
     });
     at_start = true;
     cur = results.begin();
 
-    tr->levtr().prefetch_ids(trc, ids);
+    if (prefetch) tr->levtr().prefetch_ids(trc, ids);
 }
 
 void SummaryRows::load(Tracer<>& trc, const SummaryQueryBuilder& qb)
 {
     results.clear();
     set<int> ids;
+    bool prefetch = !tr->levtr().is_preloaded();
     tr->data().run_summary_query(trc, qb, [&](const dballe::DBStation& station, int id_levtr, wreport::Varcode code, const DatetimeRange& datetime, size_t count) {
         results.emplace_back(station, id_levtr, code, datetime, count);
-        ids.insert(id_levtr);
+        if (prefetch) ids.insert(id_levtr);
     });
     at_start = true;
     cur = results.begin();
 
-    tr->levtr().prefetch_ids(trc, ids);
+    if (prefetch) tr->levtr().prefetch_ids(trc, ids);
 }
 
 
@@ -175,11 +180,28 @@ void StationRow::dump(FILE* out) const
     fprintf(out, "%02d %8.8s %02.4f %02.4f %-10s\n", station.id, station.report.c_str(), station.coords.dlat(), station.coords.dlon(), station.ident.get());
 }
 
+const DBValue& StationDataRow::value_with_attrs() const
+{
+    if (!attrs.empty())
+    {
+        core::value::Decoder::decode_attrs(attrs, *value);
+        // Release the memory of the encoded attributes
+        std::vector<uint8_t>().swap(attrs);
+    }
+    return value;
+}
+
+void StationDataRow::replace_value(int id_data, std::unique_ptr<wreport::Var> var, std::vector<uint8_t>&& attrs)
+{
+    value = DBValue(id_data, std::move(var));
+    this->attrs = std::move(attrs);
+}
+
 void StationDataRow::dump(FILE* out) const
 {
     fprintf(out, "%02d %8.8s %02.4f %02.4f %-10s ",
             station.id, station.report.c_str(), station.coords.dlat(), station.coords.dlon(), station.ident.get());
-    value.print(out);
+    value_with_attrs().print(out);
 }
 
 void DataRow::dump(FILE* out) const
@@ -188,7 +210,7 @@ void DataRow::dump(FILE* out) const
             station.id, station.report.c_str(), station.coords.dlat(), station.coords.dlon(), station.ident.get(), id_levtr);
     datetime.print_iso8601(out, ' ');
     fprintf(out, " ");
-    value.print(out);
+    value_with_attrs().print(out);
 }
 
 void SummaryRow::dump(FILE* out) const
@@ -218,7 +240,7 @@ void StationData::query_attrs(std::function<void(std::unique_ptr<wreport::Var>)>
 {
     if (!force_read && with_attributes)
     {
-        for (const wreport::Var* a = rows->value->next_attr(); a != NULL; a = a->next_attr())
+        for (const wreport::Var* a = rows->value_with_attrs()->next_attr(); a != NULL; a = a->next_attr())
             dest(std::unique_ptr<wreport::Var>(new Var(*a)));
     } else {
         rows.tr->attr_query_station(attr_reference_id(), dest);
@@ -227,7 +249,7 @@ void StationData::query_attrs(std::function<void(std::unique_ptr<wreport::Var>)>
 
 void StationData::remove()
 {
-    rows.tr->remove_station_data_by_id(rows->value.data_id);
+    rows.tr->remove_station_data_by_id(rows->data_id());
 }
 
 
@@ -238,7 +260,7 @@ void Data::query_attrs(std::function<void(std::unique_ptr<wreport::Var>)> dest,
 {
     if (!force_read && with_attributes)
     {
-        for (const Var* a = rows->value->next_attr(); a != NULL; a = a->next_attr())
+        for (const Var* a = rows->value_with_attrs()->next_attr(); a != NULL; a = a->next_attr())
             dest(std::unique_ptr<wreport::Var>(new Var(*a)));
     } else {
         rows.tr->attr_query_data(attr_reference_id(), dest);
@@ -247,7 +269,7 @@ void Data::query_attrs(std::function<void(std::unique_ptr<wreport::Var>)> dest,
 
 void Data::remove()
 {
-    rows.tr->remove_data_by_id(rows->value.data_id);
+    rows.tr->remove_data_by_id(rows->data_id());
 }
 
 
@@ -8,6 +8,7 @@
 #include <dballe/db/v7/levtr.h>
 #include <dballe/values.h>
 #include <memory>
+#include <vector>
 
 namespace dballe {
 namespace db {
@@ -34,16 +35,52 @@ struct StationRow
 
 struct StationDataRow
 {
+protected:
+    /**
+     * Value, whose attributes are only set after value_with_attrs() is
+     * called.
+     *
+     * It is not accessible directly, so that reading the value cannot
+     * accidentally miss its attributes.
+     */
+    mutable DBValue value;
+    /// Encoded attributes of value that have not been decoded yet
+    mutable std::vector<uint8_t> attrs;
+
+public:
     dballe::DBStation station;
-    DBValue value;
 
-    StationDataRow(const dballe::DBStation& station, int id_data, std::unique_ptr<wreport::Var> var) : station(station), value(id_data, std::move(var)) {}
+    StationDataRow(const dballe::DBStation& station, int id_data, std::unique_ptr<wreport::Var> var, std::vector<uint8_t>&& attrs=std::vector<uint8_t>())
+        : value(id_data, std::move(var)), attrs(std::move(attrs)), station(station) {}
     StationDataRow(const StationDataRow&) = delete;
     StationDataRow(StationDataRow&& o) = default;
     StationDataRow& operator=(const StationDataRow&) = delete;
     StationDataRow& operator=(StationDataRow&& o) = default;
     ~StationDataRow() {}
 
+    /// Database ID of the value
+    int data_id() const { return value.data_id; }
+
+    /// Variable code of the value
+    wreport::Varcode code() const { return value.code(); }
+
+    /**
+     * Return the value, decoding its attributes the first time it is called.
+     *
+     * Attributes read by the query are kept encoded until needed, so that
+     * rows whose attributes are never accessed do not need to decode them.
+     */
+    const DBValue& value_with_attrs() const;
+
+    /**
+     * Return the variable, possibly without its attributes, for callers that
+     * only look at its value
+     */
+    const wreport::Var& var_without_attrs() const { return *value; }
+
+    /// Replace the value and its encoded attributes
+    void replace_value(int id_data, std::unique_ptr<wreport::Var> var, std::vector<uint8_t>&& attrs);
+
     void dump(FILE* out) const;
 };
 
@@ -54,8 +91,8 @@ struct DataRow : public StationDataRow
 
     using StationDataRow::StationDataRow;
 
-    DataRow(const dballe::DBStation& station, int id_levtr, const Datetime& datetime, int id_data, std::unique_ptr<wreport::Var> var)
-        : StationDataRow(station, id_data, std::move(var)), id_levtr(id_levtr), datetime(datetime) {}
+    DataRow(const dballe::DBStation& station, int id_levtr, const Datetime& datetime, int id_data, std::unique_ptr<wreport::Var> var, std::vector<uint8_t>&& attrs=std::vector<uint8_t>())
+        : StationDataRow(station, id_data, std::move(var), std::move(attrs)), id_levtr(id_levtr), datetime(datetime) {}
 
     void dump(FILE* out) const;
 };
@@ -110,6 +147,20 @@ struct Rows
         at_start = false;
         cur = results.end();
     }
+
+    /**
+     * Return the row that the next call to next() would move to, or nullptr
+     * if there are no more rows
+     */
+    const Row* peek_next() const
+    {
+        auto res = cur;
+        if (!at_start && res != results.end())
+            ++res;
+        if (res == results.end())
+            return nullptr;
+        return &*res;
+    }
 };
 
 struct StationRows : public Rows<StationRow>
@@ -150,8 +201,12 @@ struct LevTrRows : public Rows<Row>
     const LevTrEntry& get_levtr() const
     {
         if (levtr == nullptr)
+        {
+            // Imports queued after the query may be changing the cache
+            this->tr->sync_imports();
             // We prefetch levtr info for all IDs, so we do not need to hit the database here
             levtr = &(this->tr->levtr().lookup_cache(this->cur->id_levtr));
+        }
         return *levtr;
     }
 };
@@ -169,7 +224,7 @@ struct DataRows : public BaseDataRows
     int insert_cur_prio;
 
     /// Append or replace the last result according to priority. Returns false if the value has been ignored.
-    bool add_to_best_results(const dballe::DBStation& station, int id_levtr, const Datetime& datetime, int id_data, std::unique_ptr<wreport::Var> var);
+    bool add_to_best_results(const dballe::DBStation& station, int id_levtr, const Datetime& datetime, int id_data, std::unique_ptr<wreport::Var> var, std::vector<uint8_t>&& attrs);
 
     void load(Tracer<>& trc, const DataQueryBuilder& qb);
     void load_best(Tracer<>& trc, const DataQueryBuilder& qb);
@@ -293,9 +348,9 @@ struct StationData : public Base<StationData>
 
     StationData(DataQueryBuilder& qb, bool with_attributes);
     std::shared_ptr<dballe::db::Transaction> get_transaction() const override { return rows.tr; }
-    wreport::Varcode get_varcode() const override { return rows->value.code(); }
-    wreport::Var get_var() const override { return *rows->value; }
-    int attr_reference_id() const override { return rows->value.data_id; }
+    wreport::Varcode get_varcode() const override { return rows->code(); }
+    wreport::Var get_var() const override { return *rows->value_with_attrs(); }
+    int attr_reference_id() const override { return rows->data_id(); }
     void query_attrs(std::function<void(std::unique_ptr<wreport::Var>)> dest, bool force_read) override;
     void remove() override;
 };
@@ -310,9 +365,9 @@ struct Data : public Base<Data>
     std::shared_ptr<dballe::db::Transaction> get_transaction() const override { return rows.tr; }
 
     Datetime get_datetime() const override { return rows->datetime; }
-    wreport::Varcode get_varcode() const override { return rows->value.code(); }
-    wreport::Var get_var() const override { return *rows->value; }
-    int attr_reference_id() const override { return rows->value.data_id; }
+    wreport::Varcode get_varcode() const override { return rows->code(); }
+    wreport::Var get_var() const override { return *rows->value_with_attrs(); }
+    int attr_reference_id() const override { return rows->data_id(); }
     Level get_level() const override { return rows.get_levtr().level; }
     Trange get_trange() const override { return rows.get_levtr().trange; }
 
@@ -8,6 +8,8 @@
 #include "dballe/db/v7/station.h"
 #include "dballe/db/v7/levtr.h"
 #include "dballe/db/v7/data.h"
+#include "dballe/db/v7/sqlite/driver.h"
+#include "dballe/core/query.h"
 #include "config.h"
 
 using namespace dballe;
@@ -152,6 +154,53 @@ add_method("attrs", [](Fixture& f) {
     wassert(actual(attrs[0]) == 50);
 });
 
+add_method("convert_datetimes", [](Fixture& f) {
+    using namespace dballe::db::v7;
+    auto driver = dynamic_cast<db::v7::sqlite::Driver*>(&f.db->driver());
+    if (!driver) throw TestSkipped("converting datetimes is only supported on SQLite");
+
+    Tracer<> trc;
+    auto& da = f.tr->data();
+
+    Var var(varinfo(WR_VAR(0, 1, 2)), 123);
+    for (const auto& dt: { Datetime(1960, 2, 3, 4, 5, 6), Datetime(2001, 2, 3, 4, 5, 6) })
+    {
+        std::vector<batch::MeasuredDatum> vars;
+        vars.emplace_back(f.lt1, &var);
+        wassert(da.insert(trc, f.sde1.id, dt, vars, false));
+    }
+
+    auto check = [&] {
+        unsigned count = 0;
+        da.query(trc, f.sde1.id, Datetime(1960, 2, 3, 4, 5, 6), [&](int id, int id_levtr, wreport::Varcode code) { ++count; });
+        wassert(actual(count) == 1u);
+
+        core::Query query;
+        query.dtrange = DatetimeRange(Datetime(1950, 1, 1), Datetime(2000, 1, 1));
+        auto cur = f.tr->query_data(query);
+        wassert(actual(cur->remaining()) == 1);
+        wassert_true(cur->next());
+        wassert(actual(cur->get_datetime()) == Datetime(1960, 2, 3, 4, 5, 6));
+    };
+
+    wassert(driver->convert_datetimes(true));
+    wassert_true(driver->conn.integer_datetimes);
+    wassert(check());
+
+    wassert(driver->convert_datetimes(false));
+    wassert_false(driver->conn.integer_datetimes);
+    wassert(check());
+
+    // Invalid values are reported instead of being normalized or lost
+    driver->conn.exec("UPDATE data SET datetime='2001-02-03 04:05:60' WHERE datetime='2001-02-03 04:05:06'");
+    {
+        auto e = wassert_throws(wreport::error_consistency, driver->convert_datetimes(true));
+        wassert(actual(e.what()).contains("'2001-02-03 04:05:60'"));
+    }
+    wassert_false(driver->conn.integer_datetimes);
+    wassert(check());
+});
+
 }
 
 }
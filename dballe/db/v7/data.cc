@@ -1,4 +1,9 @@
 #include "data.h"
+#include "db.h"
+#include "transaction.h"
+#include "trace.h"
+#include "dballe/sql/sql.h"
+#include "dballe/sql/querybuf.h"
 #include "dballe/types.h"
 #include "dballe/values.h"
 #include <algorithm>
@@ -63,6 +68,26 @@ void DataCommon<Traits>::remove_attrs(Tracer<>& trc, int id_data, const db::Attr
     }
 }
 
+template<typename Traits>
+void DataCommon<Traits>::remove_ids(Tracer<>& trc, const std::vector<int>& ids)
+{
+    for (auto begin = ids.begin(); begin != ids.end(); )
+    {
+        auto end = (size_t)(ids.end() - begin) > remove_chunk_size ? begin + remove_chunk_size : ids.end();
+
+        sql::Querybuf dq(64 + 12 * (end - begin));
+        dq.appendf("DELETE FROM %s WHERE id IN (", table_name);
+        dq.start_list(",");
+        for (auto i = begin; i != end; ++i)
+            dq.append_listf("%d", *i);
+        dq.append(")");
+
+        Tracer<> trc_del(trc ? trc->trace_delete(dq, end - begin) : nullptr);
+        tr.db->conn->execute(dq);
+        begin = end;
+    }
+}
+
 template class DataCommon<StationDataTraits>;
 template class DataCommon<DataTraits>;
 
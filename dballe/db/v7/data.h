@@ -5,6 +5,7 @@
 #include <dballe/values.h>
 #include <dballe/core/fwd.h>
 #include <dballe/core/defs.h>
+#include <dballe/core/values.h>
 #include <dballe/sql/fwd.h>
 #include <dballe/db/defs.h>
 #include <dballe/db/v7/fwd.h>
@@ -28,6 +29,9 @@ protected:
 
     v7::Transaction& tr;
 
+    /// Encoder for attributes, reused to avoid allocating a buffer per row
+    core::value::Encoder attr_encoder;
+
     /**
      * Load attributes from the database into a Values
      */
@@ -49,6 +53,15 @@ protected:
      */
     virtual void remove_all_attrs(Tracer<>& trc, int id_data) = 0;
 
+    /// Maximum number of IDs deleted by each statement run by remove_ids()
+    static const unsigned remove_chunk_size = 1000;
+
+    /**
+     * Delete the records with the given IDs, running one DELETE statement
+     * for every remove_chunk_size IDs
+     */
+    void remove_ids(Tracer<>& trc, const std::vector<int>& ids);
+
 public:
     DataCommon(v7::Transaction& tr) : tr(tr) {}
     virtual ~DataCommon() {}
@@ -149,7 +162,7 @@ struct StationData : public DataCommon<StationDataTraits>
     /**
      * Run a station data query, iterating on the resulting variables
      */
-    virtual void run_station_data_query(Tracer<>& trc, const v7::DataQueryBuilder& qb, std::function<void(const dballe::DBStation& station, int id_data, std::unique_ptr<wreport::Var> var)>) = 0;
+    virtual void run_station_data_query(Tracer<>& trc, const v7::DataQueryBuilder& qb, std::function<void(const dballe::DBStation& station, int id_data, std::unique_ptr<wreport::Var> var, std::vector<uint8_t>&& attrs)>) = 0;
 };
 
 struct Data : public DataCommon<DataTraits>
@@ -165,7 +178,7 @@ struct Data : public DataCommon<DataTraits>
     /**
      * Run a data query, iterating on the resulting variables
      */
-    virtual void run_data_query(Tracer<>& trc, const v7::DataQueryBuilder& qb, std::function<void(const dballe::DBStation& station, int id_levtr, const Datetime& datetime, int id_data, std::unique_ptr<wreport::Var> var)>) = 0;
+    virtual void run_data_query(Tracer<>& trc, const v7::DataQueryBuilder& qb, std::function<void(const dballe::DBStation& station, int id_levtr, const Datetime& datetime, int id_data, std::unique_ptr<wreport::Var> var, std::vector<uint8_t>&& attrs)>) = 0;
 
     /**
      * Run a summary query, iterating on the resulting variables
@@ -60,13 +60,19 @@ v7::Driver& DB::driver()
 std::shared_ptr<dballe::Transaction> DB::transaction(bool readonly)
 {
     auto res = conn->transaction(readonly);
-    return make_shared<v7::Transaction>(dynamic_pointer_cast<v7::DB>(shared_from_this()), move(res));
+    auto tr = make_shared<v7::Transaction>(dynamic_pointer_cast<v7::DB>(shared_from_this()), move(res));
+    if (preload_levtr)
+        tr->preload_levtr();
+    return tr;
 }
 
 std::shared_ptr<dballe::db::Transaction> DB::test_transaction(bool readonly)
 {
     auto res = conn->transaction(readonly);
-    return make_shared<v7::TestTransaction>(dynamic_pointer_cast<v7::DB>(shared_from_this()), move(res));
+    auto tr = make_shared<v7::TestTransaction>(dynamic_pointer_cast<v7::DB>(shared_from_this()), move(res));
+    if (preload_levtr)
+        tr->preload_levtr();
+    return tr;
 }
 
 void DB::delete_tables()
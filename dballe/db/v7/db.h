@@ -26,6 +26,17 @@ public:
     Trace* trace = nullptr;
     /// True if we print an EXPLAIN trace of all queries to stderr
     bool explain_queries = false;
+    /// True if transactions load the whole levtr table when they start
+    bool preload_levtr = false;
+    /**
+     * If not 0, import_messages() queues messages to be written by a separate
+     * thread, and returns as soon as there are less than this number of
+     * calls waiting to be written.
+     *
+     * The messages must not be modified until the transaction is committed,
+     * or until one of its other methods is called.
+     */
+    unsigned write_behind = 0;
 
 protected:
     /// SQL driver backend
@@ -1,7 +1,9 @@
 #include "driver.h"
 #include "config.h"
+#include "dballe/db/v7/station.h"
 #include "dballe/db/v7/sqlite/driver.h"
 #include "dballe/sql/sqlite.h"
+#include "dballe/sql/querybuf.h"
 #ifdef HAVE_LIBPQ
 #include "dballe/db/v7/postgresql/driver.h"
 #include "dballe/sql/postgresql.h"
@@ -23,6 +25,7 @@ namespace v7 {
 Driver::Driver(sql::Connection& connection)
     : connection(connection)
 {
+    station_grid = connection.get_setting("station_grid") == "yes";
 }
 
 Driver::~Driver()
@@ -64,6 +67,58 @@ void Driver::remove_all_v7()
     connection.execute("DELETE FROM station");
 }
 
+bool Driver::supports_partitions() const
+{
+    return false;
+}
+
+bool Driver::is_partitioned() const
+{
+    return false;
+}
+
+void Driver::drop_partition(int year, int month)
+{
+    throw error_consistency("cannot drop a partition: the data table is not partitioned");
+}
+
+void Driver::build_deferred_indices()
+{
+}
+
+void Driver::on_write()
+{
+}
+
+void Driver::add_station_grid()
+{
+    if (station_grid)
+        return;
+
+    // Add, fill and index the column in one go, so that an interrupted
+    // migration does not leave stations without a grid cell. MySQL commits
+    // implicitly after each DDL statement, so there it is not atomic.
+    auto t = connection.transaction();
+
+    connection.execute("ALTER TABLE station ADD COLUMN grid INTEGER");
+
+    // Same computation as Station::grid_cell, including clamping the column
+    // of lon=180 to the last one. Coordinates are shifted to be positive, so
+    // that integer division truncates the same way everywhere
+    const char* div = connection.server_type == sql::ServerType::MYSQL ? "DIV" : "/";
+    sql::Querybuf q;
+    q.appendf("UPDATE station SET grid=((lat + 9000000) %s %d) * %d"
+              " + CASE WHEN (lon + 18000000) %s %d < %d THEN (lon + 18000000) %s %d ELSE %d END",
+            div, Station::grid_step, Station::grid_columns,
+            div, Station::grid_step, Station::grid_columns, div, Station::grid_step, Station::grid_columns - 1);
+    connection.execute(q);
+
+    connection.execute("CREATE INDEX pa_grid ON station(grid)");
+    connection.set_setting("station_grid", "yes");
+    t->commit();
+    station_grid = true;
+}
+
 std::unique_ptr<Driver> Driver::create(dballe::sql::Connection& conn)
 {
     using namespace dballe::sql;
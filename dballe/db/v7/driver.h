@@ -21,6 +21,27 @@ struct Driver
 public:
     sql::Connection& connection;
 
+    /**
+     * Split the data table in monthly partitions when creating tables.
+     *
+     * Existing databases keep the layout they were created with.
+     */
+    bool create_partitioned = false;
+
+    /**
+     * Also create the optional query indices when creating tables.
+     *
+     * See add_query_indices().
+     */
+    bool create_query_indices = false;
+
+    /**
+     * Also add the station grid column when creating tables.
+     *
+     * See add_station_grid().
+     */
+    bool create_station_grid = false;
+
     Driver(sql::Connection& connection);
     virtual ~Driver();
 
@@ -60,8 +81,65 @@ public:
     /// Perform database cleanup/maintenance on v7 databases
     virtual void vacuum_v7() = 0;
 
+    /**
+     * Create the optional indices on the data table that speed up queries by
+     * variable code and datetime range without station constraints, and
+     * summary queries.
+     *
+     * They make imports slower and the database larger, so they are not
+     * created by default. Indices that already exist are left untouched.
+     */
+    virtual void add_query_indices() = 0;
+
+    /**
+     * Add to the station table the index of the cell of a regular
+     * latitude/longitude grid that contains each station, and index it.
+     *
+     * Queries by area use it to only look at the stations in the cells that
+     * intersect the area. It does nothing if the column already exists.
+     */
+    void add_station_grid();
+
+    /// Check if the station table has the grid column
+    bool has_station_grid() const { return station_grid; }
+
+    /// Check if the backend can split the data table in monthly partitions
+    virtual bool supports_partitions() const;
+
+    /// Check if the data table is split in monthly partitions
+    virtual bool is_partitioned() const;
+
+    /**
+     * Remove all the measured data of the given month, by dropping its
+     * partition.
+     *
+     * Raises an error if the data table is not partitioned.
+     */
+    virtual void drop_partition(int year, int month);
+
+    /**
+     * Create the secondary indices whose creation was deferred to speed up
+     * a bulk import.
+     *
+     * It does nothing if there are no deferred indices. It should be run
+     * inside a transaction.
+     */
+    virtual void build_deferred_indices();
+
+    /**
+     * Called by Transaction before importing, inserting or removing data.
+     *
+     * Backends use it to create deferred indices when the connection is not
+     * doing a bulk import.
+     */
+    virtual void on_write();
+
     /// Create a Driver for this connection
     static std::unique_ptr<Driver> create(dballe::sql::Connection& conn);
+
+protected:
+    /// True if the station table has the grid column
+    bool station_grid = false;
 };
 
 }
@@ -9,7 +9,9 @@
 #include "dballe/msg/msg.h"
 #include "dballe/msg/context.h"
 #include "dballe/core/query.h"
-#include <map>
+#include "dballe/core/values.h"
+#include <set>
+#include <unordered_map>
 #include <memory>
 #include <cstring>
 #include <iostream>
@@ -24,86 +26,133 @@ namespace v7 {
 
 namespace {
 
-struct StationValues : public Values
-{
-    Tracer<>& trc;
-
-    StationValues(Tracer<>& trc) : trc(trc) {}
-
-    void read(v7::Transaction& tr, int id_station)
-    {
-        clear();
-        tr.station().get_station_vars(trc, id_station, [&](std::unique_ptr<wreport::Var> var) {
-            set(std::move(var));
-        });
-    }
-};
+/// Number of stations whose variables are read with a single query
+const size_t station_vars_batch = 1000;
 
 struct ProtoVar
 {
     int id_levtr;
     std::unique_ptr<wreport::Var> var;
-    ProtoVar(int id_levtr, std::unique_ptr<wreport::Var> var) : id_levtr(id_levtr), var(std::move(var)) {}
+    /// Encoded attributes, decoded when building the message
+    std::vector<uint8_t> attrs;
+    ProtoVar(int id_levtr, std::unique_ptr<wreport::Var> var, std::vector<uint8_t>&& attrs)
+        : id_levtr(id_levtr), var(std::move(var)), attrs(std::move(attrs)) {}
 };
 
+/// Station, datetime and values of a message that has not been built yet
 struct ProtoMessage
 {
-    std::unique_ptr<impl::Message> msg;
+    dballe::DBStation station;
+    Datetime datetime;
     std::vector<ProtoVar> vars;
-    ProtoMessage() : msg(new impl::Message) {}
+    ProtoMessage(const dballe::DBStation& station, const Datetime& datetime) : station(station), datetime(datetime) {}
 };
 
+/**
+ * Cursor building messages one at a time from the results of the export
+ * query.
+ *
+ * All the information needed to build messages is read from the database
+ * when the cursor is created, so that iterating does not need to access the
+ * transaction.
+ */
 struct Cursor : public impl::CursorMessage
 {
-    typedef std::vector<std::unique_ptr<dballe::Message>> Results;
-    Results results;
-    Results::iterator cur;
+    /// Messages in output order
+    std::vector<ProtoMessage> protos;
+    /// Station variables, indexed by station ID
+    std::unordered_map<int, Values> station_values;
+    /// Levels and time ranges, indexed by levtr ID
+    std::unordered_map<int, LevTrEntry> levtrs;
+    /// Position in protos of the current message
+    size_t cur = 0;
     bool at_start = true;
+    /// Current message
+    std::unique_ptr<impl::Message> msg;
 
-    bool has_value() const { return !at_start && cur != results.end(); }
+    bool has_value() const { return !at_start && cur < protos.size(); }
 
     const Message& get_message() const override
     {
-        return **cur;
+        return *msg;
     }
 
     std::unique_ptr<Message> detach_message() override
     {
-        return std::move(*cur);
+        return std::move(msg);
     }
 
     int remaining() const override
     {
-        if (at_start)
-            return results.size();
-        return results.end() - cur;
+        return protos.size() - cur;
     }
 
     bool next() override
     {
         if (at_start)
-        {
-            cur = results.begin();
             at_start = false;
-        }
-        else if (cur != results.end())
+        else if (cur < protos.size())
             ++cur;
-        return cur != results.end();
 
+        if (cur == protos.size())
+        {
+            msg.reset();
+            return false;
+        }
+
+        build(protos[cur]);
+        return true;
     }
 
     void discard() override
     {
-        cur = results.end();
+        at_start = false;
+        cur = protos.size();
+        msg.reset();
     }
 
     DBStation get_station() const override
     {
-        DBStation res;
-        res.coords = (*cur)->get_coords();
-        res.ident  = (*cur)->get_ident();
-        res.report = (*cur)->get_report();
-        return res;
+        return protos[cur].station;
+    }
+
+    /// Build msg from proto, moving its variables into the message
+    void build(ProtoMessage& proto)
+    {
+        msg.reset(new impl::Message);
+        msg->set_datetime(proto.datetime);
+        msg->station_data.set(newvar(WR_VAR(0, 1, 194), proto.station.report));
+        msg->type = impl::Message::type_from_repmemo(proto.station.report.c_str());
+        msg->station_data.set(newvar(WR_VAR(0, 5, 1), proto.station.coords.lat));
+        msg->station_data.set(newvar(WR_VAR(0, 6, 1), proto.station.coords.lon));
+        if (!proto.station.ident.is_missing())
+            msg->station_data.set(newvar(WR_VAR(0, 1, 11), (const char*)proto.station.ident));
+
+        // Fill in station information
+        auto sv = station_values.find(proto.station.id);
+        if (sv != station_values.end())
+            msg->station_data.merge(sv->second);
+
+        // Move variables to contexts
+        int last_id_levtr = -1;
+        impl::msg::Context* ctx = nullptr;
+        for (auto& pvar: proto.vars)
+        {
+            if (pvar.id_levtr != last_id_levtr)
+            {
+                const LevTrEntry& lt = levtrs.at(pvar.id_levtr);
+                ctx = &msg->obtain_context(lt.level, lt.trange);
+                last_id_levtr = pvar.id_levtr;
+            }
+            if (!pvar.attrs.empty())
+                core::value::Decoder::decode_attrs(pvar.attrs, *pvar.var);
+            ctx->values.set(std::move(pvar.var));
+        }
+        // Release the memory of the variables already moved to the message
+        std::vector<ProtoVar>().swap(proto.vars);
+
+        if (msg->type == MessageType::PILOT || msg->type == MessageType::TEMP || msg->type == MessageType::TEMP_SHIP)
+            msg->sounding_pack_levels();
     }
 };
 
@@ -111,84 +160,73 @@ struct Cursor : public impl::CursorMessage
 
 std::unique_ptr<dballe::CursorMessage> Transaction::query_messages(const Query& query)
 {
+    sync_imports();
     Tracer<> trc(this->trc ? this->trc->trace_export_msgs(query) : nullptr);
     v7::LevTr& lt = levtr();
+    const core::Query& q = core::Query::downcast(query);
 
-    // The big export query
-    DataQueryBuilder qb(dynamic_pointer_cast<v7::Transaction>(shared_from_this()), core::Query::downcast(query), DBA_DB_MODIFIER_SORT_FOR_EXPORT | DBA_DB_MODIFIER_WITH_ATTRIBUTES, false);
+    // The big export query. Rows come sorted by station and datetime, or by
+    // datetime and station, so that all rows of a message are consecutive
+    unsigned modifiers = DBA_DB_MODIFIER_SORT_FOR_EXPORT | DBA_DB_MODIFIER_WITH_ATTRIBUTES;
+    modifiers |= q.get_modifiers() & DBA_DB_MODIFIER_SORT_BY_DATETIME;
+    DataQueryBuilder qb(dynamic_pointer_cast<v7::Transaction>(shared_from_this()), q, modifiers, false);
     qb.build();
 
-    // Current context information used to detect context changes
-    Datetime last_datetime;
-    int last_ana_id = -1;
-
-    StationValues station_values(trc);
-
     if (db->explain_queries)
     {
         fprintf(stderr, "EXPLAIN "); query.print(stderr);
         db->conn->explain(qb.sql_query, stderr);
     }
 
-    // Retrieve results, buffering them locally to avoid performing concurrent
-    // queries
-    std::map<int, std::vector<ProtoMessage>> results;
+    // Current context information used to detect context changes
+    Datetime last_datetime;
+    int last_ana_id = -1;
+    int last_id_levtr = -1;
+
+    // Retrieve results in a single pass, buffering them locally to avoid
+    // performing concurrent queries
+    std::unique_ptr<Cursor> res(new Cursor);
+    std::set<int> id_stations;
     std::set<int> id_levtrs;
-    ProtoMessage* msg;
-    data().run_data_query(trc, qb, [&](const dballe::DBStation& station, int id_levtr, const Datetime& datetime, int id_data, std::unique_ptr<wreport::Var> var) {
+    ProtoMessage* msg = nullptr;
+    data().run_data_query(trc, qb, [&](const dballe::DBStation& station, int id_levtr, const Datetime& datetime, int id_data, std::unique_ptr<wreport::Var> var, std::vector<uint8_t>&& attrs) {
         if (station.id != last_ana_id || datetime != last_datetime)
         {
-            auto& vec = results[station.id];
-            vec.emplace_back();
-            msg = &vec.back();
-            msg->msg->set_datetime(datetime);
-            msg->msg->station_data.set(newvar(WR_VAR(0, 1, 194), station.report));
-            msg->msg->type = impl::Message::type_from_repmemo(station.report.c_str());
-            msg->msg->station_data.set(newvar(WR_VAR(0, 5, 1), station.coords.lat));
-            msg->msg->station_data.set(newvar(WR_VAR(0, 6, 1), station.coords.lon));
-            if (!station.ident.is_missing())
-                msg->msg->station_data.set(newvar(WR_VAR(0, 1, 11), (const char*)station.ident));
+            res->protos.emplace_back(station, datetime);
+            msg = &res->protos.back();
+            id_stations.insert(station.id);
             last_datetime = datetime;
             last_ana_id = station.id;
+            last_id_levtr = -1;
+        }
+        if (id_levtr != last_id_levtr)
+        {
+            id_levtrs.insert(id_levtr);
+            last_id_levtr = id_levtr;
         }
-        id_levtrs.insert(id_levtr);
-        msg->vars.emplace_back(id_levtr, std::move(var));
+        msg->vars.emplace_back(id_levtr, std::move(var), std::move(attrs));
     });
 
-    lt.prefetch_ids(trc, id_levtrs);
-
-    std::unique_ptr<Cursor> res(new Cursor);
-    for (auto& r: results)
+    // Resolve levels and time ranges
+    if (!lt.is_preloaded()) lt.prefetch_ids(trc, id_levtrs);
+    for (auto id: id_levtrs)
+        res->levtrs.emplace(id, *lt.lookup_id(trc, id));
+
+    // Read station variables with one query per batch of stations
+    auto add_station_var = [&](int id_station, std::unique_ptr<wreport::Var> var) {
+        res->station_values[id_station].set(std::move(var));
+    };
+    std::set<int> batch;
+    for (auto id: id_stations)
     {
-        station_values.read(*this, r.first);
-        for (auto& msg: r.second)
+        batch.insert(batch.end(), id);
+        if (batch.size() == station_vars_batch)
         {
-            // Fill in station information
-            msg.msg->station_data.merge(station_values);
-
-            // Move variables to contexts
-            int last_id_levtr = -1;
-            impl::msg::Context* ctx = nullptr;
-            for (auto& pvar: msg.vars)
-            {
-                if (pvar.id_levtr != last_id_levtr)
-                {
-                    ctx = lt.to_msg(trc, pvar.id_levtr, *msg.msg);
-                    last_id_levtr = pvar.id_levtr;
-                }
-                ctx->values.set(std::move(pvar.var));
-            }
-            msg.vars.clear();
-
-            // Send message to consumer
-            if (msg.msg->type == MessageType::PILOT || msg.msg->type == MessageType::TEMP || msg.msg->type == MessageType::TEMP_SHIP)
-                msg.msg->sounding_pack_levels();
-
-            res->results.emplace_back(std::move(msg.msg));
+            station().get_station_vars(trc, batch, add_station_var);
+            batch.clear();
         }
-        r.second.clear();
     }
-    results.clear();
+    station().get_station_vars(trc, batch, add_station_var);
 
     return std::unique_ptr<dballe::CursorMessage>(res.release());
 }
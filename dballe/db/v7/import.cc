@@ -93,6 +93,10 @@ void Transaction::add_msg_to_batch(Tracer<>& trc, const Message& message, const
 
 void Transaction::import_message(const dballe::Message& message, const dballe::DBImportOptions& opts)
 {
+    // The caller owns message: it cannot be written after returning
+    sync_imports();
+    db->driver().on_write();
+
     Tracer<> trc(this->trc ? this->trc->trace_import(1) : nullptr);
 
     batch.set_write_attrs(opts.import_attributes);
@@ -104,6 +108,17 @@ void Transaction::import_message(const dballe::Message& message, const dballe::D
 }
 
 void Transaction::import_messages(const std::vector<std::shared_ptr<dballe::Message>>& messages, const dballe::DBImportOptions& opts)
+{
+    // If the write-behind thread is running, an earlier import already
+    // created any deferred index, and this does not touch the connection
+    db->driver().on_write();
+    if (db->write_behind)
+        queue_import(messages, opts);
+    else
+        import_messages_now(messages, opts);
+}
+
+void Transaction::import_messages_now(const std::vector<std::shared_ptr<dballe::Message>>& messages, const dballe::DBImportOptions& opts)
 {
     Tracer<> trc(this->trc ? this->trc->trace_import(messages.size()) : nullptr);
 
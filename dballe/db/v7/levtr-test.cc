@@ -43,6 +43,32 @@ add_method("insert", [](Fixture& f) {
     i = lt.obtain_id(trc, db::v7::LevTrEntry(Level(2, 3, 1, 4), Trange(5, 6, 7)));
     wassert(actual(i) == 2);
 });
+
+add_method("preload", [](Fixture& f) {
+    db::v7::Tracer<> trc;
+    auto& lt = f.tr->levtr();
+
+    auto id1 = lt.obtain_id(trc, db::v7::LevTrEntry(Level(1, 2, 0, 3), Trange(4, 5, 6)));
+    auto id2 = lt.obtain_id(trc, db::v7::LevTrEntry(Level(2, 3, 1, 4), Trange(5, 6, 7)));
+
+    lt.clear_cache();
+    wassert_false(lt.is_preloaded());
+    wassert_throws(wreport::error_notfound, lt.lookup_cache(id1));
+
+    lt.preload(trc);
+    wassert_true(lt.is_preloaded());
+    wassert(actual(lt.lookup_cache(id1).level) == Level(1, 2, 0, 3));
+    wassert(actual(lt.lookup_cache(id2).trange) == Trange(5, 6, 7));
+
+    // New entries are added to the preloaded cache
+    auto id3 = lt.obtain_id(trc, db::v7::LevTrEntry(Level(3, 4, 2, 5), Trange(6, 7, 8)));
+    wassert_true(lt.is_preloaded());
+    wassert(actual(lt.lookup_cache(id3).level) == Level(3, 4, 2, 5));
+    wassert(actual(lt.obtain_id(trc, db::v7::LevTrEntry(Level(2, 3, 1, 4), Trange(5, 6, 7)))) == id2);
+
+    lt.clear_cache();
+    wassert_false(lt.is_preloaded());
+});
 }
 
 }
@@ -38,9 +38,24 @@ public:
 
     /**
      * Given a set of IDs, load LevTr information for them and add it to the cache.
+     *
+     * It does nothing if the cache already contains the whole table.
      */
     virtual void prefetch_ids(Tracer<>& trc, const std::set<int>& ids) = 0;
 
+    /**
+     * Load the whole lev_tr table into the cache.
+     *
+     * Until the cache is cleared, prefetch_ids() does not need to be called.
+     */
+    virtual void preload(Tracer<>& trc) = 0;
+
+    /**
+     * Check if the cache contains the whole lev_tr table, so that there is no
+     * need to collect IDs for prefetch_ids().
+     */
+    bool is_preloaded() const { return cache.complete; }
+
     /**
      * Get/create a Context in the Msg for this level/timerange.
      *
@@ -52,7 +52,7 @@ void MySQLDataCommon<Parent>::read_attrs(Tracer<>& trc, int id_data, std::functi
 template<typename Parent>
 void MySQLDataCommon<Parent>::write_attrs(Tracer<>& trc, int id_data, const Values& values)
 {
-    vector<uint8_t> encoded = values.encode();
+    const auto& encoded = this->attr_encoder.encode_values(values);
     string escaped = conn.escape(encoded);
     Querybuf qb;
     qb.appendf("UPDATE %s SET attrs=X'%s' WHERE id=%d", Parent::table_name, escaped.c_str(), id_data);
@@ -69,20 +69,6 @@ void MySQLDataCommon<Parent>::remove_all_attrs(Tracer<>& trc, int id_data)
     conn.exec_no_data(query);
 }
 
-namespace {
-
-bool match_attrs(const Varmatch& match, const std::vector<uint8_t>& attrs)
-{
-    bool found = false;
-    Values::decode(attrs, [&](std::unique_ptr<wreport::Var> var) {
-        if (match(*var))
-            found = true;
-    });
-    return found;
-}
-
-}
-
 template<typename Parent>
 void MySQLDataCommon<Parent>::remove(Tracer<>& trc, const v7::IdQueryBuilder& qb)
 {
@@ -93,28 +79,19 @@ void MySQLDataCommon<Parent>::remove(Tracer<>& trc, const v7::IdQueryBuilder& qb
     if (!qb.query.attr_filter.empty())
         attr_filter = Varmatch::parse(qb.query.attr_filter);
 
-    Querybuf dq(512);
-    dq.appendf("DELETE FROM %s WHERE id IN (", Parent::table_name);
-    dq.start_list(",");
-    unsigned count = 0;
+    // MySQL does not allow a DELETE to select from the table it is deleting
+    // from, so we collect the IDs first, and delete them a chunk at a time
+    std::vector<int> ids;
     Tracer<> trc_sel(trc ? trc->trace_select(qb.sql_query) : nullptr);
     auto res = conn.exec_store(qb.sql_query);
     while (auto row = res.fetch())
     {
         if (trc_sel) trc_sel->add_row();
-        if (attr_filter.get() && !match_attrs(*attr_filter, row.as_blob(1))) return;
-
-        // Note: if the query gets too long, we can split this in more DELETE
-        // runs
-        dq.append_list(row.as_cstring(0));
-        ++count;
-    }
-    dq.append(")");
-    if (count)
-    {
-        Tracer<> trc_del(trc ? trc->trace_delete(dq, count) : nullptr);
-        conn.exec_no_data(dq);
+        if (attr_filter.get() && !attr_filter->match_encoded(row.as_blob(1))) continue;
+        ids.push_back(row.as_int(0));
     }
+    trc_sel.done();
+    this->remove_ids(trc, ids);
 }
 
 template<typename Parent>
@@ -138,9 +115,8 @@ void MySQLDataCommon<Parent>::update(Tracer<>& trc, std::vector<typename Parent:
         Querybuf qb;
         if (with_attrs && v.var->next_attr())
         {
-            core::value::Encoder enc;
-            enc.append_attributes(*v.var);
-            string escaped_attrs = conn.escape(enc.buf);
+            const auto& attrs = this->attr_encoder.encode_attributes(*v.var);
+            string escaped_attrs = conn.escape(attrs);
             qb.appendf("UPDATE %s SET value='%s', attrs=X'%s' WHERE id=%d", Parent::table_name, escaped_value.c_str(), escaped_attrs.c_str(), v.id);
         }
         else
@@ -184,9 +160,8 @@ void MySQLStationData::insert(Tracer<>& trc, int id_station, std::vector<batch::
         string escaped_value = conn.escape(v->var->enqc());
         if (with_attrs && v->var->next_attr())
         {
-            core::value::Encoder enc;
-            enc.append_attributes(*v->var);
-            string escaped_attrs = conn.escape(enc.buf);
+            const auto& attrs = attr_encoder.encode_attributes(*v->var);
+            string escaped_attrs = conn.escape(attrs);
             qb.appendf("INSERT INTO station_data (id_station, code, value, attrs) VALUES (%d, %d, '%s', X'%s')",
                     id_station,
                     (int)v->var->code(),
@@ -204,7 +179,7 @@ void MySQLStationData::insert(Tracer<>& trc, int id_station, std::vector<batch::
     }
 }
 
-void MySQLStationData::run_station_data_query(Tracer<>& trc, const v7::DataQueryBuilder& qb, std::function<void(const dballe::DBStation& station, int id_data, std::unique_ptr<wreport::Var> var)> dest)
+void MySQLStationData::run_station_data_query(Tracer<>& trc, const v7::DataQueryBuilder& qb, std::function<void(const dballe::DBStation& station, int id_data, std::unique_ptr<wreport::Var> var, std::vector<uint8_t>&& attrs)> dest)
 {
     if (qb.bind_in_ident)
         throw error_unimplemented("binding in MySQL driver is not implemented");
@@ -215,14 +190,16 @@ void MySQLStationData::run_station_data_query(Tracer<>& trc, const v7::DataQuery
         if (trc_sel) trc_sel->add_row();
         wreport::Varcode code = row.as_int(5);
         const char* value = row.as_cstring(7);
-        auto var = newvar(code, value);
+        std::vector<uint8_t> attrs;
         if (qb.select_attrs)
-            core::value::Decoder::decode_attrs(row.as_blob(8), *var);
+            attrs = row.as_blob(8);
 
         // Postprocessing filter of attr_filter
-        if (qb.attr_filter && !qb.match_attrs(*var))
+        if (qb.attr_filter && !qb.match_attrs(attrs))
             return;
 
+        auto var = newvar(code, value);
+
         int id_station = row.as_int(0);
         if (id_station != station.id)
         {
@@ -238,7 +215,7 @@ void MySQLStationData::run_station_data_query(Tracer<>& trc, const v7::DataQuery
 
         int id_data = row.as_int(6);
 
-        dest(station, id_data, move(var));
+        dest(station, id_data, move(var), move(attrs));
     });
 }
 
@@ -296,9 +273,8 @@ void MySQLData::insert(Tracer<>& trc, int id_station, const Datetime& datetime,
 
         if (with_attrs && v->var->next_attr())
         {
-            core::value::Encoder enc;
-            enc.append_attributes(*v->var);
-            string escaped_attrs = conn.escape(enc.buf);
+            const auto& attrs = attr_encoder.encode_attributes(*v->var);
+            string escaped_attrs = conn.escape(attrs);
             qb.appendf("INSERT INTO data (id_station, id_levtr, datetime, code, value, attrs) VALUES (%d, %d, '%04d-%02d-%02d %02d:%02d:%02d', %d, '%s', X'%s')",
                     id_station, v->id_levtr, dt.year, dt.month, dt.day, dt.hour, dt.minute, dt.second,
                     (int)v->var->code(),
@@ -316,7 +292,7 @@ void MySQLData::insert(Tracer<>& trc, int id_station, const Datetime& datetime,
     }
 }
 
-void MySQLData::run_data_query(Tracer<>& trc, const v7::DataQueryBuilder& qb, std::function<void(const dballe::DBStation& station, int id_levtr, const Datetime& datetime, int id_data, std::unique_ptr<wreport::Var> var)> dest)
+void MySQLData::run_data_query(Tracer<>& trc, const v7::DataQueryBuilder& qb, std::function<void(const dballe::DBStation& station, int id_levtr, const Datetime& datetime, int id_data, std::unique_ptr<wreport::Var> var, std::vector<uint8_t>&& attrs)> dest)
 {
     if (qb.bind_in_ident)
         throw error_unimplemented("binding in MySQL driver is not implemented");
@@ -327,14 +303,16 @@ void MySQLData::run_data_query(Tracer<>& trc, const v7::DataQueryBuilder& qb, st
         if (trc_sel) trc_sel->add_row();
         wreport::Varcode code = row.as_int(6);
         const char* value = row.as_cstring(9);
-        auto var = newvar(code, value);
+        std::vector<uint8_t> attrs;
         if (qb.select_attrs)
-            core::value::Decoder::decode_attrs(row.as_blob(10), *var);
+            attrs = row.as_blob(10);
 
         // Postprocessing filter of attr_filter
-        if (qb.attr_filter && !qb.match_attrs(*var))
+        if (qb.attr_filter && !qb.match_attrs(attrs))
             return;
 
+        auto var = newvar(code, value);
+
         int id_station = row.as_int(0);
         if (id_station != station.id)
         {
@@ -352,7 +330,7 @@ void MySQLData::run_data_query(Tracer<>& trc, const v7::DataQueryBuilder& qb, st
         int id_data = row.as_int(7);
         Datetime datetime = row.as_datetime(8);
 
-        dest(station, id_levtr, datetime, id_data, move(var));
+        dest(station, id_levtr, datetime, id_data, move(var), move(attrs));
     });
 }
 
@@ -123,9 +123,29 @@ void Driver::create_tables_v7()
            INDEX(id_levtr)
         )
     )" DBA_MYSQL_DEFAULT_TABLE_OPTIONS);
+    if (create_query_indices)
+        add_query_indices();
+    if (create_station_grid)
+        add_station_grid();
 
     conn.set_setting("version", "V7");
 }
+void Driver::add_query_indices()
+{
+    using namespace dballe::sql::mysql;
+    // MySQL does not support CREATE INDEX IF NOT EXISTS
+    auto create = [&](const char* name, const char* columns) {
+        string query = "SELECT COUNT(*) FROM information_schema.statistics WHERE table_schema=DATABASE() AND table_name='data' AND index_name='";
+        query += name;
+        query += "'";
+        Result res(conn.exec_store(query));
+        if (res.expect_one_result().as_unsigned(0) > 0)
+            return;
+        conn.exec_no_data(string("CREATE INDEX ") + name + " ON data(" + columns + ")");
+    };
+    create("data_dt", "datetime");
+    create("data_code_dt", "code, datetime, id_station, id_levtr");
+}
 void Driver::delete_tables_v7()
 {
     conn.drop_table_if_exists("data");
@@ -134,6 +154,7 @@ void Driver::delete_tables_v7()
     conn.drop_table_if_exists("repinfo");
     conn.drop_table_if_exists("station");
     conn.drop_settings();
+    station_grid = false;
 }
 void Driver::vacuum_v7()
 {
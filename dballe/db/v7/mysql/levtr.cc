@@ -52,29 +52,45 @@ MySQLLevTr::~MySQLLevTr()
 
 void MySQLLevTr::prefetch_ids(Tracer<>& trc, const std::set<int>& ids)
 {
-    if (ids.empty()) return;
+    if (ids.empty() || cache.complete) return;
 
-    sql::Querybuf qb;
-    if (ids.size() < 100)
+    // With many IDs, it is faster to load the whole table
+    if (ids.size() >= 100)
     {
-        qb.append("SELECT id, ltype1, l1, ltype2, l2, pind, p1, p2 FROM levtr WHERE id IN (");
-        qb.start_list(",");
-        for (auto id: ids)
-            qb.append_listf("%d", id);
-        qb.append(")");
-    } else
-        qb.append("SELECT id, ltype1, l1, ltype2, l2, pind, p1, p2 FROM levtr");
+        preload(trc);
+        return;
+    }
+
+    sql::Querybuf qb;
+    qb.append("SELECT id, ltype1, l1, ltype2, l2, pind, p1, p2 FROM levtr WHERE id IN (");
+    qb.start_list(",");
+    for (auto id: ids)
+        qb.append_listf("%d", id);
+    qb.append(")");
 
     Tracer<> trc_sel(trc ? trc->trace_select(qb) : nullptr);
     auto res = conn.exec_store(qb);
     while (auto row = res.fetch())
     {
         if (trc_sel) trc_sel->add_row();
-        cache.insert(unique_ptr<LevTrEntry>(new LevTrEntry(
-            row.as_int(0),
-            Level(row.as_int(1), row.as_int(2), row.as_int(3), row.as_int(4)),
-            Trange(row.as_int(5), row.as_int(6), row.as_int(7)))));
+        cache.insert(LevTrEntry(row.as_int(0), to_level(row, 1), to_trange(row, 5)));
+    }
+}
+
+void MySQLLevTr::preload(Tracer<>& trc)
+{
+    if (cache.complete) return;
+
+    const char* query = "SELECT id, ltype1, l1, ltype2, l2, pind, p1, p2 FROM levtr";
+    Tracer<> trc_sel(trc ? trc->trace_select(query) : nullptr);
+    auto res = conn.exec_store(query);
+    cache.reserve(res.rowcount());
+    while (auto row = res.fetch())
+    {
+        if (trc_sel) trc_sel->add_row();
+        cache.insert(LevTrEntry(row.as_int(0), to_level(row, 1), to_trange(row, 5)));
     }
+    cache.complete = true;
 }
 
 const LevTrEntry* MySQLLevTr::lookup_id(Tracer<>& trc, int id)
@@ -90,16 +106,7 @@ const LevTrEntry* MySQLLevTr::lookup_id(Tracer<>& trc, int id)
     while (auto row = qres.fetch())
     {
         if (trc_sel) trc_sel->add_row();
-        std::unique_ptr<LevTrEntry> e(new LevTrEntry);
-        e->id = id;
-        e->level.ltype1 = row.as_int(0);
-        e->level.l1 = row.as_int(1);
-        e->level.ltype2 = row.as_int(2);
-        e->level.l2 = row.as_int(3);
-        e->trange.pind = row.as_int(4);
-        e->trange.p1 = row.as_int(5);
-        e->trange.p2 = row.as_int(6);
-        res = cache.insert(move(e));
+        res = cache.insert(LevTrEntry(id, to_level(row), to_trange(row, 4)));
     }
 
     if (!res)
@@ -35,6 +35,7 @@ public:
     ~MySQLLevTr();
 
     void prefetch_ids(Tracer<>& trc, const std::set<int>& ids) override;
+    void preload(Tracer<>& trc) override;
     const LevTrEntry* lookup_id(Tracer<>& trc, int id) override;
     int obtain_id(Tracer<>& trc, const LevTrEntry& desc) override;
 };
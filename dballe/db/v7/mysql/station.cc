@@ -97,17 +97,20 @@ int MySQLStation::insert_new(Tracer<>& trc, const dballe::DBStation& desc)
     // If no station was found, insert a new one
     int rep = tr.repinfo().get_id(desc.report.c_str());
     Querybuf qb;
+    if (station_grid)
+        qb.append("INSERT INTO station (rep, lat, lon, ident, grid)");
+    else
+        qb.append("INSERT INTO station (rep, lat, lon, ident)");
     if (desc.ident.get())
     {
         string escaped_ident = conn.escape(desc.ident.get());
-        qb.appendf(R"(
-            INSERT INTO station (rep, lat, lon, ident) VALUES (%d, %d, %d, '%s')
-        )", rep, desc.coords.lat, desc.coords.lon, escaped_ident.c_str());
+        qb.appendf(" VALUES (%d, %d, %d, '%s'", rep, desc.coords.lat, desc.coords.lon, escaped_ident.c_str());
     } else {
-        qb.appendf(R"(
-            INSERT INTO station (rep, lat, lon, ident) VALUES (%d, %d, %d, NULL)
-        )", rep, desc.coords.lat, desc.coords.lon);
+        qb.appendf(" VALUES (%d, %d, %d, NULL", rep, desc.coords.lat, desc.coords.lon);
     }
+    if (station_grid)
+        qb.appendf(", %d", grid_cell(desc.coords));
+    qb.append(")");
     Tracer<> trc_ins(trc ? trc->trace_insert(qb, 1) : nullptr);
     conn.exec_no_data(qb);
     return conn.get_last_insert_id();
@@ -178,6 +181,29 @@ void MySQLStation::get_station_vars(Tracer<>& trc, int id_station, std::function
     }
 }
 
+void MySQLStation::get_station_vars(Tracer<>& trc, const std::set<int>& ids, std::function<void(int id_station, std::unique_ptr<wreport::Var>)> dest)
+{
+    if (ids.empty()) return;
+
+    Querybuf qb;
+    qb.append("SELECT d.id_station, d.code, d.value, d.attrs FROM station_data d WHERE d.id_station IN (");
+    qb.start_list(",");
+    for (auto id: ids)
+        qb.append_listf("%d", id);
+    qb.append(") ORDER BY d.id_station, d.code");
+
+    Tracer<> trc_sel(trc ? trc->trace_select(qb) : nullptr);
+    auto res = conn.exec_store(qb);
+    while (auto row = res.fetch())
+    {
+        if (trc_sel) trc_sel->add_row();
+        unique_ptr<Var> var = newvar((Varcode)row.as_int(1), row.as_cstring(2));
+        if (!row.isnull(3))
+            DBValues::decode(row.as_blob(3), [&](unique_ptr<wreport::Var> a) { var->seta(move(a)); });
+        dest(row.as_int(0), move(var));
+    }
+}
+
 void MySQLStation::add_station_vars(Tracer<>& trc, int id_station, DBValues& values)
 {
     Querybuf qb;
@@ -38,6 +38,7 @@ public:
     int maybe_get_id(Tracer<>& trc, const dballe::DBStation& st) override;
     int insert_new(Tracer<>& trc, const dballe::DBStation& desc) override;
     void get_station_vars(Tracer<>& trc, int id_station, std::function<void(std::unique_ptr<wreport::Var>)> dest) override;
+    void get_station_vars(Tracer<>& trc, const std::set<int>& ids, std::function<void(int id_station, std::unique_ptr<wreport::Var>)> dest) override;
     void add_station_vars(Tracer<>& trc, int id_station, DBValues& values) override;
     void run_station_query(Tracer<>& trc, const v7::StationQueryBuilder& qb, std::function<void(const dballe::DBStation&)>) override;
 };
@@ -63,7 +63,7 @@ void PostgreSQLDataCommon<Parent>::write_attrs(Tracer<>& trc, int id_data, const
         conn.prepare(write_attrs_query_name, query);
     }
     Tracer<> trc_upd(trc ? trc->trace_update("UPDATE … SET attrs=$1::bytea WHERE id=$2::int4", 1) : nullptr);
-    vector<uint8_t> encoded = values.encode();
+    const auto& encoded = this->attr_encoder.encode_values(values);
     conn.exec_prepared_no_data(write_attrs_query_name, encoded, id_data);
 }
 
@@ -82,36 +82,14 @@ void PostgreSQLDataCommon<Parent>::remove_all_attrs(Tracer<>& trc, int id_data)
     conn.exec_prepared_no_data(remove_attrs_query_name, id_data);
 }
 
-namespace {
-
-bool match_attrs(const Varmatch& match, const std::vector<uint8_t>& attrs)
-{
-    bool found = false;
-    Values::decode(attrs, [&](std::unique_ptr<wreport::Var> var) {
-        if (match(*var))
-            found = true;
-    });
-    return found;
-}
-
-}
-
 template<typename Parent>
 void PostgreSQLDataCommon<Parent>::remove(Tracer<>& trc, const v7::IdQueryBuilder& qb)
 {
     if (!qb.query.attr_filter.empty())
     {
         // We need to apply attr_filter to all results of the query, so we
-        // iterate the results and delete the matching ones one by one.
+        // iterate the results and delete the matching ones a chunk at a time
         std::unique_ptr<Varmatch> attr_filter = Varmatch::parse(qb.query.attr_filter);
-        if (remove_data_query_name.empty())
-        {
-            remove_data_query_name = Parent::table_name;
-            remove_data_query_name += "v7_remove_data";
-            char query[64];
-            snprintf(query, 64, "DELETE FROM %s WHERE id=$1::int4", Parent::table_name);
-            conn.prepare(remove_data_query_name, query);
-        }
 
         Tracer<> trc_sel(trc ? trc->trace_select(qb.sql_query) : nullptr);
         Result to_remove;
@@ -121,12 +99,14 @@ void PostgreSQLDataCommon<Parent>::remove(Tracer<>& trc, const v7::IdQueryBuilde
             to_remove = conn.exec(qb.sql_query);
         if (trc_sel) trc_sel->add_row(to_remove.rowcount());
         trc_sel.done();
+
+        std::vector<int> ids;
         for (unsigned row = 0; row < to_remove.rowcount(); ++row)
         {
-            if (!match_attrs(*attr_filter, to_remove.get_bytea(row, 1))) return;
-            Tracer<> trc_del(trc ? trc->trace_delete(remove_data_query_name, 1) : nullptr);
-            conn.exec_prepared(remove_data_query_name, (int)to_remove.get_int4(row, 0));
+            if (!attr_filter->match_encoded(to_remove.get_bytea(row, 1))) continue;
+            ids.push_back(to_remove.get_int4(row, 0));
         }
+        this->remove_ids(trc, ids);
     } else {
         Querybuf dq(512);
         dq.append("DELETE FROM ");
@@ -177,9 +157,8 @@ void PostgreSQLDataCommon<Parent>::update(Tracer<>& trc, std::vector<typename Pa
             qb.append(",");
             if (v.var->next_attr())
             {
-                core::value::Encoder enc;
-                enc.append_attributes(*v.var);
-                conn.append_escaped(qb, enc.buf);
+                const auto& attrs = this->attr_encoder.encode_attributes(*v.var);
+                conn.append_escaped(qb, attrs);
             } else
                 qb.append("NULL");
             qb.append("::bytea)");
@@ -253,9 +232,8 @@ void PostgreSQLStationData::insert(Tracer<>& trc, int id_station, std::vector<ba
         dq.append(",");
         if (with_attrs && v->var->next_attr())
         {
-            core::value::Encoder enc;
-            enc.append_attributes(*v->var);
-            conn.append_escaped(dq, enc.buf);
+            const auto& attrs = attr_encoder.encode_attributes(*v->var);
+            conn.append_escaped(dq, attrs);
         } else
             dq.append("NULL::bytea");
         dq.append(")");
@@ -281,7 +259,7 @@ void PostgreSQLStationData::insert(Tracer<>& trc, int id_station, std::vector<ba
     }
 }
 
-void PostgreSQLStationData::run_station_data_query(Tracer<>& trc, const v7::DataQueryBuilder& qb, std::function<void(const dballe::DBStation& station, int id_data, std::unique_ptr<wreport::Var> var)> dest)
+void PostgreSQLStationData::run_station_data_query(Tracer<>& trc, const v7::DataQueryBuilder& qb, std::function<void(const dballe::DBStation& station, int id_data, std::unique_ptr<wreport::Var> var, std::vector<uint8_t>&& attrs)> dest)
 {
     Tracer<> trc_sel(trc ? trc->trace_select(qb.sql_query) : nullptr);
     using namespace dballe::sql::postgresql;
@@ -305,14 +283,16 @@ void PostgreSQLStationData::run_station_data_query(Tracer<>& trc, const v7::Data
         {
             wreport::Varcode code = res.get_int4(row, 5);
             const char* value = res.get_string(row, 7);
-            auto var = newvar(code, value);
+            std::vector<uint8_t> attrs;
             if (qb.select_attrs)
-                core::value::Decoder::decode_attrs(res.get_bytea(row, 8), *var);
+                attrs = res.get_bytea(row, 8);
 
             // Postprocessing filter of attr_filter
-            if (qb.attr_filter && !qb.match_attrs(*var))
+            if (qb.attr_filter && !qb.match_attrs(attrs))
                 return;
 
+            auto var = newvar(code, value);
+
             int id_station = res.get_int4(row, 0);
             if (id_station != station.id)
             {
@@ -328,7 +308,7 @@ void PostgreSQLStationData::run_station_data_query(Tracer<>& trc, const v7::Data
 
             int id_data = res.get_int4(row, 6);
 
-            dest(station, id_data, move(var));
+            dest(station, id_data, move(var), move(attrs));
         }
     });
 }
@@ -348,8 +328,8 @@ void PostgreSQLStationData::dump(FILE* out)
 }
 
 
-PostgreSQLData::PostgreSQLData(v7::Transaction& tr, PostgreSQLConnection& conn)
-    : PostgreSQLDataCommon(tr, conn)
+PostgreSQLData::PostgreSQLData(v7::Transaction& tr, PostgreSQLConnection& conn, bool partitioned)
+    : PostgreSQLDataCommon(tr, conn), partitioned(partitioned)
 {
     conn.prepare("datav7_select", "SELECT id, id_levtr, code FROM data WHERE id_station=$1::int4 AND datetime=$2::timestamp");
 }
@@ -368,8 +348,27 @@ void PostgreSQLData::query(Tracer<>& trc, int id_station, const Datetime& dateti
     }
 }
 
+void PostgreSQLData::ensure_partition(Tracer<>& trc, const Datetime& datetime)
+{
+    int month = datetime.year * 12 + datetime.month - 1;
+    if (partitions.find(month) != partitions.end())
+        return;
+
+    int next_year = datetime.year + (datetime.month == 12 ? 1 : 0);
+    int next_month = datetime.month == 12 ? 1 : datetime.month + 1;
+    char query[192];
+    snprintf(query, 192, "CREATE TABLE IF NOT EXISTS data_%04d%02d PARTITION OF data FOR VALUES FROM ('%04d-%02d-01') TO ('%04d-%02d-01')",
+            datetime.year, datetime.month, datetime.year, datetime.month, next_year, next_month);
+    Tracer<> trc_cre(trc ? trc->add_child(new trace::Step("create", query)) : nullptr);
+    conn.exec_no_data(query);
+    partitions.insert(month);
+}
+
 void PostgreSQLData::insert(Tracer<>& trc, int id_station, const Datetime& datetime, std::vector<batch::MeasuredDatum>& vars, bool with_attrs)
 {
+    if (partitioned)
+        ensure_partition(trc, datetime);
+
     std::sort(vars.begin(), vars.end());
 
     const Datetime& dt = datetime;
@@ -398,9 +397,8 @@ void PostgreSQLData::insert(Tracer<>& trc, int id_station, const Datetime& datet
         dq.append(",");
         if (with_attrs && v->var->next_attr())
         {
-            core::value::Encoder enc;
-            enc.append_attributes(*v->var);
-            conn.append_escaped(dq, enc.buf);
+            const auto& attrs = attr_encoder.encode_attributes(*v->var);
+            conn.append_escaped(dq, attrs);
         } else
             dq.append("NULL::bytea");
         dq.append(")");
@@ -426,7 +424,7 @@ void PostgreSQLData::insert(Tracer<>& trc, int id_station, const Datetime& datet
     }
 }
 
-void PostgreSQLData::run_data_query(Tracer<>& trc, const v7::DataQueryBuilder& qb, std::function<void(const dballe::DBStation& station, int id_levtr, const Datetime& datetime, int id_data, std::unique_ptr<wreport::Var> var)> dest)
+void PostgreSQLData::run_data_query(Tracer<>& trc, const v7::DataQueryBuilder& qb, std::function<void(const dballe::DBStation& station, int id_levtr, const Datetime& datetime, int id_data, std::unique_ptr<wreport::Var> var, std::vector<uint8_t>&& attrs)> dest)
 {
     Tracer<> trc_sel(trc ? trc->trace_select(qb.sql_query) : nullptr);
     using namespace dballe::sql::postgresql;
@@ -450,14 +448,16 @@ void PostgreSQLData::run_data_query(Tracer<>& trc, const v7::DataQueryBuilder& q
         {
             wreport::Varcode code = res.get_int4(row, 6);
             const char* value = res.get_string(row, 9);
-            auto var = newvar(code, value);
+            std::vector<uint8_t> attrs;
             if (qb.select_attrs)
-                core::value::Decoder::decode_attrs(res.get_bytea(row, 10), *var);
+                attrs = res.get_bytea(row, 10);
 
             // Postprocessing filter of attr_filter
-            if (qb.attr_filter && !qb.match_attrs(*var))
+            if (qb.attr_filter && !qb.match_attrs(attrs))
                 return;
 
+            auto var = newvar(code, value);
+
             int id_station = res.get_int4(row, 0);
             if (id_station != station.id)
             {
@@ -475,7 +475,7 @@ void PostgreSQLData::run_data_query(Tracer<>& trc, const v7::DataQueryBuilder& q
             int id_data = res.get_int4(row, 7);
             Datetime datetime = res.get_timestamp(row, 8);
 
-            dest(station, id_levtr, datetime, id_data, move(var));
+            dest(station, id_levtr, datetime, id_data, move(var), move(attrs));
         }
     });
 }
@@ -4,6 +4,7 @@
 #include <dballe/db/v7/data.h>
 #include <dballe/db/v7/cache.h>
 #include <dballe/sql/fwd.h>
+#include <set>
 
 namespace dballe {
 namespace db {
@@ -20,7 +21,6 @@ protected:
     std::string select_attrs_query_name;
     std::string write_attrs_query_name;
     std::string remove_attrs_query_name;
-    std::string remove_data_query_name;
 
 public:
     PostgreSQLDataCommon(v7::Transaction& tr, dballe::sql::PostgreSQLConnection& conn);
@@ -49,24 +49,33 @@ public:
 
     void query(Tracer<>& trc, int id_station, std::function<void(int id, wreport::Varcode code)> dest) override;
     void insert(Tracer<>& trc, int id_station, std::vector<batch::StationDatum>& vars, bool with_attrs) override;
-    void run_station_data_query(Tracer<>& trc, const v7::DataQueryBuilder& qb, std::function<void(const dballe::DBStation& station, int id_data, std::unique_ptr<wreport::Var> var)>) override;
+    void run_station_data_query(Tracer<>& trc, const v7::DataQueryBuilder& qb, std::function<void(const dballe::DBStation& station, int id_data, std::unique_ptr<wreport::Var> var, std::vector<uint8_t>&& attrs)>) override;
     void dump(FILE* out) override;
     void clear_cache() override {}
 };
 
 class PostgreSQLData : public PostgreSQLDataCommon<Data>
 {
+protected:
+    /// True if the data table is split in monthly partitions
+    bool partitioned;
+    /// Months (as year * 12 + month - 1) whose partition is known to exist
+    std::set<int> partitions;
+
+    /// Create the partition for the month of \a datetime, if missing
+    void ensure_partition(Tracer<>& trc, const Datetime& datetime);
+
 public:
     using PostgreSQLDataCommon::PostgreSQLDataCommon;
 
-    PostgreSQLData(v7::Transaction& tr, dballe::sql::PostgreSQLConnection& conn);
+    PostgreSQLData(v7::Transaction& tr, dballe::sql::PostgreSQLConnection& conn, bool partitioned=false);
 
     void query(Tracer<>& trc, int id_station, const Datetime& datetime, std::function<void(int id, int id_levtr, wreport::Varcode code)> dest) override;
     void insert(Tracer<>& trc, int id_station, const Datetime& datetime, std::vector<batch::MeasuredDatum>& vars, bool with_attrs) override;
-    void run_data_query(Tracer<>& trc, const v7::DataQueryBuilder& qb, std::function<void(const dballe::DBStation& station, int id_levtr, const Datetime& datetime, int id_data, std::unique_ptr<wreport::Var> var)>) override;
+    void run_data_query(Tracer<>& trc, const v7::DataQueryBuilder& qb, std::function<void(const dballe::DBStation& station, int id_levtr, const Datetime& datetime, int id_data, std::unique_ptr<wreport::Var> var, std::vector<uint8_t>&& attrs)>) override;
     void run_summary_query(Tracer<>& trc, const v7::SummaryQueryBuilder& qb, std::function<void(const dballe::DBStation& station, int id_levtr, wreport::Varcode code, const DatetimeRange& datetime, size_t size)>) override;
     void dump(FILE* out) override;
-    void clear_cache() override {}
+    void clear_cache() override { partitions.clear(); }
 };
 
 }
@@ -24,6 +24,7 @@ namespace postgresql {
 Driver::Driver(PostgreSQLConnection& conn)
     : v7::Driver(conn), conn(conn)
 {
+    partitioned = conn.get_setting("partitioning") == "month";
 }
 
 Driver::~Driver()
@@ -52,7 +53,7 @@ std::unique_ptr<v7::StationData> Driver::create_station_data(v7::Transaction& tr
 
 std::unique_ptr<v7::Data> Driver::create_data(v7::Transaction& tr)
 {
-    return unique_ptr<v7::Data>(new PostgreSQLData(tr, conn));
+    return unique_ptr<v7::Data>(new PostgreSQLData(tr, conn, partitioned));
 }
 
 void Driver::create_tables_v7()
@@ -107,7 +108,19 @@ void Driver::create_tables_v7()
     )");
     conn.exec_no_data("CREATE UNIQUE INDEX station_data_uniq on station_data(id_station, code);");
 
-    conn.exec_no_data(R"(
+    // A partitioned table cannot have a primary key that does not include
+    // the partition key, so in that case id is only indexed
+    conn.exec_no_data(create_partitioned ? R"(
+        CREATE TABLE data (
+           id          SERIAL,
+           id_station  INTEGER NOT NULL REFERENCES station (id) ON DELETE CASCADE,
+           id_levtr    INTEGER NOT NULL REFERENCES levtr(id) ON DELETE CASCADE,
+           datetime    TIMESTAMP NOT NULL,
+           code        INTEGER NOT NULL,
+           value       VARCHAR(255) NOT NULL,
+           attrs       BYTEA
+        ) PARTITION BY RANGE (datetime);
+    )" : R"(
         CREATE TABLE data (
            id          SERIAL PRIMARY KEY,
            id_station  INTEGER NOT NULL REFERENCES station (id) ON DELETE CASCADE,
@@ -118,11 +131,27 @@ void Driver::create_tables_v7()
            attrs       BYTEA
         );
     )");
+    if (create_partitioned)
+        conn.exec_no_data("CREATE INDEX data_id ON data(id);");
     conn.exec_no_data("CREATE UNIQUE INDEX data_uniq on data(id_station, datetime, id_levtr, code);");
     // When possible, replace with a postgresql 9.5 BRIN index
     conn.exec_no_data("CREATE INDEX data_dt ON data(datetime);");
+    if (create_query_indices)
+        add_query_indices();
+    if (create_station_grid)
+        add_station_grid();
 
     conn.set_setting("version", "V7");
+    if (create_partitioned)
+        conn.set_setting("partitioning", "month");
+    partitioned = create_partitioned;
+}
+void Driver::add_query_indices()
+{
+    // data_dt already covers queries by datetime only. Including the
+    // station and level/timerange lets summary queries by variable run on
+    // the index alone
+    conn.exec_no_data("CREATE INDEX IF NOT EXISTS data_code_dt ON data(code, datetime, id_station, id_levtr);");
 }
 void Driver::delete_tables_v7()
 {
@@ -132,7 +161,18 @@ void Driver::delete_tables_v7()
     conn.drop_table_if_exists("station");
     conn.drop_table_if_exists("repinfo");
     conn.drop_settings();
+    station_grid = false;
+    partitioned = false;
 }
+void Driver::drop_partition(int year, int month)
+{
+    if (!partitioned)
+        v7::Driver::drop_partition(year, month);
+    char name[32];
+    snprintf(name, 32, "data_%04d%02d", year, month);
+    conn.drop_table_if_exists(name);
+}
+
 void Driver::vacuum_v7()
 {
     conn.exec_no_data(R"(
@@ -13,6 +13,9 @@ struct Driver : public v7::Driver
 {
     dballe::sql::PostgreSQLConnection& conn;
 
+    /// True if the data table is split in monthly partitions
+    bool partitioned = false;
+
     Driver(dballe::sql::PostgreSQLConnection& conn);
     virtual ~Driver();
 
@@ -24,6 +27,10 @@ struct Driver : public v7::Driver
     void create_tables_v7() override;
     void delete_tables_v7() override;
     void vacuum_v7() override;
+    void add_query_indices() override;
+    bool supports_partitions() const override { return true; }
+    bool is_partitioned() const override { return partitioned; }
+    void drop_partition(int year, int month) override;
 };
 
 }
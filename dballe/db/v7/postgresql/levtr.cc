@@ -60,25 +60,41 @@ PostgreSQLLevTr::~PostgreSQLLevTr()
 
 void PostgreSQLLevTr::prefetch_ids(Tracer<>& trc, const std::set<int>& ids)
 {
-    if (ids.empty()) return;
+    if (ids.empty() || cache.complete) return;
 
-    sql::Querybuf qb;
-    if (ids.size() < 100)
+    // With many IDs, it is faster to load the whole table
+    if (ids.size() >= 100)
     {
-        qb.append("SELECT id, ltype1, l1, ltype2, l2, pind, p1, p2 FROM levtr WHERE id IN (");
-        qb.start_list(",");
-        for (auto id: ids)
-            qb.append_listf("%d", id);
-        qb.append(")");
-    } else
-        qb.append("SELECT id, ltype1, l1, ltype2, l2, pind, p1, p2 FROM levtr");
+        preload(trc);
+        return;
+    }
+
+    sql::Querybuf qb;
+    qb.append("SELECT id, ltype1, l1, ltype2, l2, pind, p1, p2 FROM levtr WHERE id IN (");
+    qb.start_list(",");
+    for (auto id: ids)
+        qb.append_listf("%d", id);
+    qb.append(")");
 
     Tracer<> trc_sel(trc ? trc->trace_select(qb) : nullptr);
     auto res = conn.exec(qb);
     if (trc_sel) trc_sel->add_row(res.rowcount());
     for (unsigned row = 0; row < res.rowcount(); ++row)
-        cache.insert(unique_ptr<LevTrEntry>(new LevTrEntry(
-                    res.get_int4(row, 0), to_level(res, row, 1), to_trange(res, row, 5))));
+        cache.insert(LevTrEntry(res.get_int4(row, 0), to_level(res, row, 1), to_trange(res, row, 5)));
+}
+
+void PostgreSQLLevTr::preload(Tracer<>& trc)
+{
+    if (cache.complete) return;
+
+    const char* query = "SELECT id, ltype1, l1, ltype2, l2, pind, p1, p2 FROM levtr";
+    Tracer<> trc_sel(trc ? trc->trace_select(query) : nullptr);
+    auto res = conn.exec(query);
+    if (trc_sel) trc_sel->add_row(res.rowcount());
+    cache.reserve(res.rowcount());
+    for (unsigned row = 0; row < res.rowcount(); ++row)
+        cache.insert(LevTrEntry(res.get_int4(row, 0), to_level(res, row, 1), to_trange(res, row, 5)));
+    cache.complete = true;
 }
 
 const LevTrEntry* PostgreSQLLevTr::lookup_id(Tracer<>& trc, int id)
@@ -93,7 +109,7 @@ const LevTrEntry* PostgreSQLLevTr::lookup_id(Tracer<>& trc, int id)
     switch (res.rowcount())
     {
         case 0: error_notfound::throwf("levtr with id %d not found in the database", id);
-        case 1: return cache.insert(unique_ptr<LevTrEntry>(new LevTrEntry(id, to_level(res, 0, 0), to_trange(res, 0, 4))));
+        case 1: return cache.insert(LevTrEntry(id, to_level(res, 0, 0), to_trange(res, 0, 4)));
         default: error_consistency::throwf("select levtr data query returned %u results", res.rowcount());
     }
 }
@@ -5,6 +5,7 @@
 #include "dballe/db/v7/db.h"
 #include "dballe/db/v7/repinfo.h"
 #include "dballe/sql/postgresql.h"
+#include "dballe/sql/querybuf.h"
 #include "dballe/core/var.h"
 #include "dballe/values.h"
 #include <wreport/var.h>
@@ -26,6 +27,8 @@ PostgreSQLStation::PostgreSQLStation(v7::Transaction& tr, PostgreSQLConnection&
     conn.prepare("v7_station_select_fixed", "SELECT id FROM station WHERE rep=$1::int4 AND lat=$2::int4 AND lon=$3::int4 AND ident IS NULL");
     conn.prepare("v7_station_select_mobile", "SELECT id FROM station WHERE rep=$1::int4 AND lat=$2::int4 AND lon=$3::int4 AND ident=$4::text");
     conn.prepare("v7_station_insert", "INSERT INTO station (id, rep, lat, lon, ident) VALUES (DEFAULT, $1::int4, $2::int4, $3::int4, $4::text) RETURNING id");
+    if (station_grid)
+        conn.prepare("v7_station_insert_grid", "INSERT INTO station (id, rep, lat, lon, ident, grid) VALUES (DEFAULT, $1::int4, $2::int4, $3::int4, $4::text, $5::int4) RETURNING id");
     conn.prepare("v7_station_select_station_data", "SELECT rep, lat, lon, ident FROM station WHERE id=$1::int4");
     conn.prepare("v7_station_get_station_vars", R"(
         SELECT d.code, d.value, d.attrs
@@ -110,6 +113,11 @@ int PostgreSQLStation::insert_new(Tracer<>& trc, const dballe::DBStation& desc)
 {
     // If no station was found, insert a new one
     int rep = tr.repinfo().get_id(desc.report.c_str());
+    if (station_grid)
+    {
+        Tracer<> trc_ins(trc ? trc->trace_insert("v7_station_insert_grid", 1) : nullptr);
+        return conn.exec_prepared_one_row("v7_station_insert_grid", rep, desc.coords.lat, desc.coords.lon, desc.ident.get(), grid_cell(desc.coords)).get_int4(0, 0);
+    }
     Tracer<> trc_ins(trc ? trc->trace_insert("v7_station_insert", 1) : nullptr);
     return conn.exec_prepared_one_row("v7_station_insert", rep, desc.coords.lat, desc.coords.lon, desc.ident.get()).get_int4(0, 0);
 }
@@ -140,6 +148,31 @@ void PostgreSQLStation::get_station_vars(Tracer<>& trc, int id_station, std::fun
     };
 }
 
+void PostgreSQLStation::get_station_vars(Tracer<>& trc, const std::set<int>& ids, std::function<void(int id_station, std::unique_ptr<wreport::Var>)> dest)
+{
+    using namespace dballe::sql::postgresql;
+
+    if (ids.empty()) return;
+
+    sql::Querybuf qb;
+    qb.append("SELECT d.id_station, d.code, d.value, d.attrs FROM station_data d WHERE d.id_station IN (");
+    qb.start_list(",");
+    for (auto id: ids)
+        qb.append_listf("%d", id);
+    qb.append(") ORDER BY d.id_station, d.code");
+
+    Tracer<> trc_sel(trc ? trc->trace_select(qb) : nullptr);
+    Result res(conn.exec(qb));
+    if (trc_sel) trc_sel->add_row(res.rowcount());
+    for (unsigned row = 0; row < res.rowcount(); ++row)
+    {
+        unique_ptr<Var> var = newvar((Varcode)res.get_int4(row, 1), res.get_string(row, 2));
+        if (!res.is_null(row, 3))
+            DBValues::decode(res.get_bytea(row, 3), [&](unique_ptr<wreport::Var> a) { var->seta(move(a)); });
+        dest(res.get_int4(row, 0), move(var));
+    }
+}
+
 void PostgreSQLStation::add_station_vars(Tracer<>& trc, int id_station, DBValues& values)
 {
     using namespace dballe::sql::postgresql;
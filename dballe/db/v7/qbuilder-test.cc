@@ -0,0 +1,144 @@
+#include "dballe/db/tests.h"
+#include "dballe/sql/sql.h"
+#include "dballe/db/v7/db.h"
+#include "dballe/db/v7/transaction.h"
+#include "dballe/db/v7/driver.h"
+#include "dballe/db/v7/qbuilder.h"
+#include "dballe/core/query.h"
+#include "config.h"
+#include <system_error>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+
+using namespace dballe;
+using namespace dballe::tests;
+using namespace wreport;
+using namespace std;
+
+namespace {
+
+/**
+ * A representative query, with the index that its plan is expected to use on
+ * each backend.
+ *
+ * A nullptr index means that the plan is only printed, and not checked.
+ */
+struct PlanCase
+{
+    /// Name used in error messages
+    const char* name;
+    /// Query, in the format of core::Query::set_from_test_string
+    const char* query;
+    /// True for a summary query, false for a data query
+    bool summary;
+    const char* sqlite;
+    const char* postgresql;
+};
+
+const PlanCase plan_cases[] = {
+    // Maps of a variable over all stations
+    { "var_dt", "var=B12101, yearmin=2016, monthmin=1, daymin=1, yearmax=2016, monthmax=1, daymax=2", false, "data_code_dt", "data_code_dt" },
+    { "var", "var=B12101", false, "data_code_dt", "data_code_dt" },
+    { "dt", "yearmin=2016, monthmin=1, daymin=1, yearmax=2016, monthmax=1, daymax=2", false, "data_dt", "data_dt" },
+    // Summaries only need the indexed columns
+    { "summary_var", "var=B12101", true, "COVERING INDEX data_code_dt", "data_code_dt" },
+    { "summary_var_dt", "var=B12101, yearmin=2016, monthmin=1, daymin=1, yearmax=2016, monthmax=1, daymax=2", true, "COVERING INDEX data_code_dt", "data_code_dt" },
+    // Time series of a station
+    { "station", "ana_id=1", false, "sqlite_autoindex_data_1", "data_uniq" },
+    { "level", "leveltype1=103, l1=2000", false, "data_lt", nullptr },
+};
+
+struct Fixture : EmptyTransactionFixture<V7DB>
+{
+    using EmptyTransactionFixture::EmptyTransactionFixture;
+
+    void create_db() override
+    {
+        EmptyTransactionFixture::create_db();
+        db->driver().add_query_indices();
+    }
+
+    /// Build the SQL of a query and return the output of explain for it
+    std::string explain(const PlanCase& c)
+    {
+        core::Query query;
+        query.set_from_test_string(c.query);
+
+        std::unique_ptr<db::v7::DataQueryBuilder> qb;
+        if (c.summary)
+            qb.reset(new db::v7::SummaryQueryBuilder(tr, query, DBA_DB_MODIFIER_SUMMARY_DETAILS, false));
+        else
+            qb.reset(new db::v7::DataQueryBuilder(tr, query, 0, false));
+        qb->build();
+
+        char* buf = nullptr;
+        size_t size = 0;
+        FILE* out = open_memstream(&buf, &size);
+        if (!out)
+            throw std::system_error(errno, std::system_category(), "cannot create memory stream");
+        try {
+            db->conn->explain(qb->sql_query, out);
+        } catch (...) {
+            fclose(out);
+            free(buf);
+            throw;
+        }
+        fclose(out);
+        std::string res(buf, size);
+        free(buf);
+        return res;
+    }
+};
+
+class Tests : public FixtureTestCase<Fixture>
+{
+    using FixtureTestCase::FixtureTestCase;
+
+    void register_tests() override;
+};
+
+Tests tg1("db_v7_qbuilder_sqlite", "SQLITE");
+#ifdef HAVE_LIBPQ
+Tests tg3("db_v7_qbuilder_postgresql", "POSTGRESQL");
+#endif
+#ifdef HAVE_MYSQL
+Tests tg4("db_v7_qbuilder_mysql", "MYSQL");
+#endif
+
+
+void Tests::register_tests()
+{
+
+// Lock in the use of indices by representative queries. Set
+// DBA_EXPLAIN_CORPUS to print the query plans
+add_method("query_plans", [](Fixture& f) {
+    // On empty tables PostgreSQL prefers sequential scans: discourage them to
+    // see which indices would be used
+    if (f.db->conn->server_type == sql::ServerType::POSTGRES)
+        f.db->conn->execute("SET LOCAL enable_seqscan = off");
+
+    for (const auto& c: plan_cases)
+    {
+        WREPORT_TEST_INFO(info);
+        info() << c.name << ": " << c.query;
+
+        std::string plan = f.explain(c);
+        if (getenv("DBA_EXPLAIN_CORPUS"))
+            fprintf(stderr, "%s:\n%s\n", c.name, plan.c_str());
+
+        const char* expected = nullptr;
+        switch (f.db->conn->server_type)
+        {
+            case sql::ServerType::SQLITE: expected = c.sqlite; break;
+            case sql::ServerType::POSTGRES: expected = c.postgresql; break;
+            default: break;
+        }
+        if (expected)
+            wassert(actual(plan).contains(expected));
+    }
+});
+
+}
+
+}
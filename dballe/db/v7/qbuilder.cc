@@ -1,5 +1,8 @@
 #include "qbuilder.h"
 #include "transaction.h"
+#include "db.h"
+#include "driver.h"
+#include "station.h"
 #include "dballe/core/defs.h"
 #include "dballe/core/aliases.h"
 #include "dballe/core/query.h"
@@ -205,6 +208,57 @@ struct Constraints
         found = true;
     }
 
+    /**
+     * Restrict the query to the station grid cells that intersect the
+     * latitude and longitude ranges, as a complement to add_lat() and
+     * add_lon() that can use the index on the grid column.
+     *
+     * Nothing is added if the area would need too many ranges of cells.
+     */
+    void add_grid()
+    {
+        // Above this, an index scan on longitude is likely to be as good
+        static const unsigned max_ranges = 32;
+
+        if (query.latrange.is_missing() && query.lonrange.is_missing()) return;
+
+        int row_min = Station::grid_row(query.latrange.imin);
+        int row_max = Station::grid_row(query.latrange.imax);
+
+        // Ranges of columns covered by the longitude range
+        std::vector<std::pair<int, int>> columns;
+        if (query.lonrange.is_missing())
+            columns.emplace_back(0, Station::grid_columns - 1);
+        else if (query.lonrange.imin <= query.lonrange.imax)
+            columns.emplace_back(Station::grid_column(query.lonrange.imin), Station::grid_column(query.lonrange.imax));
+        else
+        {
+            columns.emplace_back(Station::grid_column(query.lonrange.imin), Station::grid_columns - 1);
+            columns.emplace_back(0, Station::grid_column(query.lonrange.imax));
+        }
+
+        // Full latitude rows are contiguous ranges of cells
+        if (columns.size() == 1 && columns[0].first == 0 && columns[0].second == Station::grid_columns - 1)
+        {
+            q.append_listf("%s.grid BETWEEN %d AND %d", tbl,
+                    row_min * Station::grid_columns, row_max * Station::grid_columns + Station::grid_columns - 1);
+            return;
+        }
+
+        if ((unsigned)(row_max - row_min + 1) * columns.size() > max_ranges) return;
+
+        q.append_list("(");
+        bool first = true;
+        for (int row = row_min; row <= row_max; ++row)
+            for (const auto& c: columns)
+            {
+                q.appendf("%s%s.grid BETWEEN %d AND %d", first ? "" : " OR ", tbl,
+                        row * Station::grid_columns + c.first, row * Station::grid_columns + c.second);
+                first = false;
+            }
+        q.append(")");
+    }
+
     void add_mobile()
     {
         if (query.mobile != MISSING_INT)
@@ -387,12 +441,9 @@ bool DataQueryBuilder::build_where()
     return has_where;
 }
 
-bool DataQueryBuilder::match_attrs(const Var& var) const
+bool DataQueryBuilder::match_attrs(const std::vector<uint8_t>& attrs) const
 {
-    for (const Var* a = var.next_attr(); a != NULL; a = a->next_attr())
-        if ((*attr_filter)(*a))
-            return true;
-    return false;
+    return attr_filter->match_encoded(attrs);
 }
 
 #if 0
@@ -425,6 +476,20 @@ bool DataQueryBuilder::add_attrfilter_where(const char* tbl)
 
 void DataQueryBuilder::build_order_by()
 {
+    if ((modifiers & DBA_DB_MODIFIER_SORT_BY_DATETIME) && !query_station_vars)
+    {
+        sql_query.append(" ORDER BY d.datetime");
+        if (modifiers & DBA_DB_MODIFIER_BEST)
+            sql_query.append(", s.lat, s.lon, s.ident");
+        else
+            sql_query.append(", d.id_station");
+        sql_query.append(", ltr.ltype1, ltr.l1, ltr.ltype2, ltr.l2, ltr.pind, ltr.p1, ltr.p2");
+        if (modifiers & DBA_DB_MODIFIER_BEST)
+            sql_query.append(", s.rep");
+        sql_query.append(", d.code");
+        return;
+    }
+
     if (modifiers & DBA_DB_MODIFIER_BEST)
         sql_query.append(" ORDER BY s.lat, s.lon, s.ident");
     else
@@ -529,6 +594,8 @@ bool QueryBuilder::add_pa_where(const char* tbl)
     }
     c.add_lat();
     c.add_lon();
+    if (tr->db->driver().has_station_grid())
+        c.add_grid();
     c.add_mobile();
     if (!query.ident.is_missing())
     {
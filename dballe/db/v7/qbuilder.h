@@ -5,6 +5,7 @@
 #include <dballe/db/v7/db.h>
 #include <dballe/core/query.h>
 #include <regex.h>
+#include <vector>
 
 namespace dballe {
 struct Varmatch;
@@ -104,8 +105,8 @@ struct DataQueryBuilder : public QueryBuilder
 
     // bool add_attrfilter_where(const char* tbl);
 
-    /// Match the attributes of var against attr_filter
-    bool match_attrs(const wreport::Var& var) const;
+    /// Match encoded attributes against attr_filter
+    bool match_attrs(const std::vector<uint8_t>& attrs) const;
 
     virtual void build_select();
     virtual bool build_where();
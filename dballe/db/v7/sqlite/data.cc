@@ -73,8 +73,7 @@ void SQLiteDataCommon<Parent>::write_attrs(Tracer<>& trc, int id_data, const Val
         write_attrs_stm = conn.sqlitestatement(query).release();
     }
     Tracer<> trc_upd(trc ? trc->trace_update("UPDATE … SET attrs=? WHERE id=?", 1) : nullptr);
-    vector<uint8_t> encoded = values.encode();
-    write_attrs_stm->bind_val(1, encoded);
+    write_attrs_stm->bind_val(1, this->attr_encoder.encode_values(values));
     write_attrs_stm->bind_val(2, id_data);
     write_attrs_stm->execute();
 }
@@ -93,44 +92,44 @@ void SQLiteDataCommon<Parent>::remove_all_attrs(Tracer<>& trc, int id_data)
     remove_attrs_stm->execute();
 }
 
-namespace {
-
-bool match_attrs(const Varmatch& match, const std::vector<uint8_t>& attrs)
-{
-    bool found = false;
-    Values::decode(attrs, [&](std::unique_ptr<wreport::Var> var) {
-        if (match(*var))
-            found = true;
-    });
-    return found;
-}
-
-}
-
 template<typename Parent>
 void SQLiteDataCommon<Parent>::remove(Tracer<>& trc, const v7::IdQueryBuilder& qb)
 {
-    char query[64];
-    snprintf(query, 64, "DELETE FROM %s WHERE id=?", Parent::table_name);
-    auto stmd = conn.sqlitestatement(query);
+    if (qb.query.attr_filter.empty())
+    {
+        // Delete all the selected records with a single statement
+        Querybuf dq(512);
+        dq.appendf("DELETE FROM %s WHERE id IN (", Parent::table_name);
+        dq.append(qb.sql_query);
+        dq.append(")");
+        Tracer<> trc_del(trc ? trc->trace_delete(dq) : nullptr);
+        auto stmd = conn.sqlitestatement(dq);
+        if (qb.bind_in_ident) stmd->bind_val(1, qb.bind_in_ident);
+        stmd->execute();
+        if (trc_del) trc_del->add_row(conn.changes());
+        return;
+    }
+
+    // attr_filter needs to be matched on the decoded attributes: iterate the
+    // selected records, deleting the matching ones a chunk at a time
+    std::unique_ptr<Varmatch> attr_filter = Varmatch::parse(qb.query.attr_filter);
     auto stm = conn.sqlitestatement(qb.sql_query);
     if (qb.bind_in_ident) stm->bind_val(1, qb.bind_in_ident);
 
-    std::unique_ptr<Varmatch> attr_filter;
-    if (!qb.query.attr_filter.empty())
-        attr_filter = Varmatch::parse(qb.query.attr_filter);
-
-    // Iterate all the data_id results, deleting the related data and attributes
+    std::vector<int> ids;
     Tracer<> trc_sel(trc ? trc->trace_select(qb.sql_query) : nullptr);
     stm->execute([&]() {
         if (trc_sel) trc_sel->add_row();
-        if (attr_filter.get() && !match_attrs(*attr_filter, stm->column_blob(1))) return;
-
-        // Compile the DELETE query for the data
-        Tracer<> trc_del(trc ? trc->trace_delete(query, 1) : nullptr);
-        stmd->bind_val(1, stm->column_int(0));
-        stmd->execute();
+        if (!attr_filter->match_encoded(stm->column_blob(1))) return;
+        ids.push_back(stm->column_int(0));
+        if (ids.size() >= Parent::remove_chunk_size)
+        {
+            this->remove_ids(trc, ids);
+            ids.clear();
+        }
     });
+    trc_sel.done();
+    this->remove_ids(trc, ids);
 }
 
 template<typename Parent>
@@ -150,12 +149,8 @@ void SQLiteDataCommon<Parent>::update(Tracer<>& trc, std::vector<typename Parent
     for (auto& v: vars)
     {
         ustm->bind_val(1, v.var->enqc());
-        core::value::Encoder enc;
         if (with_attrs && v.var->next_attr())
-        {
-            enc.append_attributes(*v.var);
-            ustm->bind_val(2, enc.buf);
-        }
+            ustm->bind_val(2, this->attr_encoder.encode_attributes(*v.var));
         else
             ustm->bind_null_val(2);
         ustm->bind_val(3, v.id);
@@ -199,12 +194,8 @@ void SQLiteStationData::insert(Tracer<>& trc, int id_station, std::vector<batch:
             continue;
         istm->bind_val(2, v->var->code());
         istm->bind_val(3, v->var->enqc());
-        core::value::Encoder enc;
         if (with_attrs && v->var->next_attr())
-        {
-            enc.append_attributes(*v->var);
-            istm->bind_val(4, enc.buf);
-        }
+            istm->bind_val(4, attr_encoder.encode_attributes(*v->var));
         else
             istm->bind_null_val(4);
         Tracer<> trc_ins(trc ? trc->trace_insert(insert_station_data_query, 1) : nullptr);
@@ -213,7 +204,7 @@ void SQLiteStationData::insert(Tracer<>& trc, int id_station, std::vector<batch:
     }
 }
 
-void SQLiteStationData::run_station_data_query(Tracer<>& trc, const v7::DataQueryBuilder& qb, std::function<void(const dballe::DBStation& station, int id_data, std::unique_ptr<wreport::Var> var)> dest)
+void SQLiteStationData::run_station_data_query(Tracer<>& trc, const v7::DataQueryBuilder& qb, std::function<void(const dballe::DBStation& station, int id_data, std::unique_ptr<wreport::Var> var, std::vector<uint8_t>&& attrs)> dest)
 {
     Tracer<> trc_sel(trc ? trc->trace_select(qb.sql_query) : nullptr);
     auto stm = conn.sqlitestatement(qb.sql_query);
@@ -225,14 +216,16 @@ void SQLiteStationData::run_station_data_query(Tracer<>& trc, const v7::DataQuer
         if (trc_sel) trc_sel->add_row();
         wreport::Varcode code = stm->column_int(5);
         const char* value = stm->column_string(7);
-        auto var = newvar(code, value);
+        std::vector<uint8_t> attrs;
         if (qb.select_attrs)
-            core::value::Decoder::decode_attrs(stm->column_blob(8), *var);
+            attrs = stm->column_blob(8);
 
         // Postprocessing filter of attr_filter
-        if (qb.attr_filter && !qb.match_attrs(*var))
+        if (qb.attr_filter && !qb.match_attrs(attrs))
             return;
 
+        auto var = newvar(code, value);
+
         int id_station = stm->column_int(0);
         if (id_station != station.id)
         {
@@ -248,7 +241,7 @@ void SQLiteStationData::run_station_data_query(Tracer<>& trc, const v7::DataQuer
 
         int id_data = stm->column_int(6);
 
-        dest(station, id_data, move(var));
+        dest(station, id_data, move(var), move(attrs));
     });
 }
 
@@ -305,12 +298,8 @@ void SQLiteData::insert(Tracer<>& trc, int id_station, const Datetime& datetime,
         istm->bind_val(2, v->id_levtr);
         istm->bind_val(4, v->var->code());
         istm->bind_val(5, v->var->enqc());
-        core::value::Encoder enc;
         if (with_attrs && v->var->next_attr())
-        {
-            enc.append_attributes(*v->var);
-            istm->bind_val(6, enc.buf);
-        }
+            istm->bind_val(6, attr_encoder.encode_attributes(*v->var));
         else
             istm->bind_null_val(6);
         istm->execute();
@@ -319,7 +308,7 @@ void SQLiteData::insert(Tracer<>& trc, int id_station, const Datetime& datetime,
     }
 }
 
-void SQLiteData::run_data_query(Tracer<>& trc, const v7::DataQueryBuilder& qb, std::function<void(const dballe::DBStation& station, int id_levtr, const Datetime& datetime, int id_data, std::unique_ptr<wreport::Var> var)> dest)
+void SQLiteData::run_data_query(Tracer<>& trc, const v7::DataQueryBuilder& qb, std::function<void(const dballe::DBStation& station, int id_levtr, const Datetime& datetime, int id_data, std::unique_ptr<wreport::Var> var, std::vector<uint8_t>&& attrs)> dest)
 {
     Tracer<> trc_sel(trc ? trc->trace_select(qb.sql_query) : nullptr);
     auto stm = conn.sqlitestatement(qb.sql_query);
@@ -331,14 +320,16 @@ void SQLiteData::run_data_query(Tracer<>& trc, const v7::DataQueryBuilder& qb, s
         if (trc_sel) trc_sel->add_row();
         wreport::Varcode code = stm->column_int(6);
         const char* value = stm->column_string(9);
-        auto var = newvar(code, value);
+        std::vector<uint8_t> attrs;
         if (qb.select_attrs)
-            core::value::Decoder::decode_attrs(stm->column_blob(10), *var);
+            attrs = stm->column_blob(10);
 
         // Postprocessing filter of attr_filter
-        if (qb.attr_filter && !qb.match_attrs(*var))
+        if (qb.attr_filter && !qb.match_attrs(attrs))
             return;
 
+        auto var = newvar(code, value);
+
         int id_station = stm->column_int(0);
         if (id_station != station.id)
         {
@@ -356,7 +347,7 @@ void SQLiteData::run_data_query(Tracer<>& trc, const v7::DataQueryBuilder& qb, s
         int id_data = stm->column_int(7);
         Datetime datetime = stm->column_datetime(8);
 
-        dest(station, id_levtr, datetime, id_data, move(var));
+        dest(station, id_levtr, datetime, id_data, move(var), move(attrs));
     });
 }
 
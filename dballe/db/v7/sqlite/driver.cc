@@ -7,6 +7,7 @@
 #include "dballe/db/v7/db.h"
 #include "dballe/db/v7/transaction.h"
 #include "dballe/sql/sqlite.h"
+#include "dballe/sql/querybuf.h"
 #include "dballe/var.h"
 #include <algorithm>
 #include <cstring>
@@ -26,6 +27,8 @@ namespace sqlite {
 Driver::Driver(SQLiteConnection& conn)
     : v7::Driver(conn), conn(conn)
 {
+    conn.integer_datetimes = conn.get_setting("datetime") == "integer";
+    indices_deferred = conn.get_setting("indices") == "deferred";
 }
 
 Driver::~Driver()
@@ -81,7 +84,6 @@ void Driver::create_tables_v7()
            UNIQUE (rep, lat, lon, ident)
         );
         CREATE INDEX pa_rep ON station(rep);
-        CREATE INDEX pa_lon ON station(lon);
     )");
     conn.exec(R"(
         CREATE TABLE levtr (
@@ -106,22 +108,128 @@ void Driver::create_tables_v7()
            UNIQUE (id_station, code)
         );
     )");
-    conn.exec(R"(
-        CREATE TABLE data (
+    create_data_table("data", create_integer_datetimes);
+
+    conn.set_setting("version", "V7");
+    // With the bulk profile, the secondary indices are created at the end of
+    // the import, which is faster than updating them at each insert
+    indices_deferred = conn.profile == "bulk";
+    if (indices_deferred)
+        conn.set_setting("indices", "deferred");
+    else
+    {
+        conn.exec("CREATE INDEX pa_lon ON station(lon)");
+        conn.exec("CREATE INDEX data_lt ON data(id_levtr)");
+    }
+    if (create_query_indices)
+        add_query_indices();
+    if (create_station_grid)
+        add_station_grid();
+    conn.set_setting("datetime", create_integer_datetimes ? "integer" : "text");
+    conn.integer_datetimes = create_integer_datetimes;
+}
+
+void Driver::create_data_table(const char* name, bool integer)
+{
+    Querybuf q;
+    q.appendf(R"(
+        CREATE TABLE %s (
            id          INTEGER PRIMARY KEY,
            id_station  INTEGER NOT NULL REFERENCES station (id) ON DELETE CASCADE,
            id_levtr    INTEGER NOT NULL REFERENCES levtr(id) ON DELETE CASCADE,
-           datetime    TEXT NOT NULL,
+           datetime    %s NOT NULL,
            code        INTEGER NOT NULL,
            value       VARCHAR(255) NOT NULL,
            attrs       BLOB,
            UNIQUE (id_station, datetime, id_levtr, code)
-        );
-        CREATE INDEX data_lt ON data(id_levtr);
-    )");
+        )
+    )", name, integer ? "INTEGER" : "TEXT");
+    conn.exec(q);
+}
 
-    conn.set_setting("version", "V7");
+void Driver::convert_datetimes(bool integer)
+{
+    if (integer == conn.integer_datetimes)
+        return;
+
+    // SQLite's date functions silently turn values they cannot parse into
+    // NULL, and normalize out of range fields: refuse to convert if a value
+    // does not survive the round trip
+    {
+        const char* query = integer
+            ? "SELECT id, CAST(datetime AS TEXT) FROM data WHERE strftime('%Y-%m-%d %H:%M:%S', datetime) IS NOT datetime LIMIT 1"
+            : "SELECT id, CAST(datetime AS TEXT) FROM data WHERE typeof(datetime) != 'integer' OR strftime('%Y-%m-%d %H:%M:%S', datetime, 'unixepoch') IS NULL LIMIT 1";
+        auto stm = conn.sqlitestatement(query);
+        stm->execute([&]() {
+            const char* val = stm->column_string(1);
+            error_consistency::throwf("cannot convert the datetime of data row %d: invalid value '%s'", stm->column_int(0), val ? val : "NULL");
+        });
+    }
+
+    // Dropping the data table also drops its indices
+    bool query_indices = has_index("data_code_dt");
+
+    // SQLite's date functions use the same proleptic Gregorian calendar as
+    // dballe::Datetime, so the conversion can be done entirely in SQL
+    create_data_table("data_new", integer);
+    Querybuf q;
+    q.appendf(R"(
+        INSERT INTO data_new (id, id_station, id_levtr, datetime, code, value, attrs)
+             SELECT id, id_station, id_levtr, %s, code, value, attrs
+               FROM data
+    )", integer ? "CAST(strftime('%s', datetime) AS INTEGER)" : "strftime('%Y-%m-%d %H:%M:%S', datetime, 'unixepoch')");
+    conn.exec(q);
+    conn.exec("DROP TABLE data");
+    conn.exec("ALTER TABLE data_new RENAME TO data");
+    if (conn.get_setting("indices") != "deferred")
+        conn.exec("CREATE INDEX data_lt ON data(id_levtr)");
+    if (query_indices)
+        add_query_indices();
+
+    conn.set_setting("datetime", integer ? "integer" : "text");
+    conn.integer_datetimes = integer;
+}
+
+void Driver::build_deferred_indices()
+{
+    // Check the setting again: another connection may have created them
+    if (conn.get_setting("indices") == "deferred")
+    {
+        conn.exec("CREATE INDEX IF NOT EXISTS pa_lon ON station(lon)");
+        conn.exec("CREATE INDEX IF NOT EXISTS data_lt ON data(id_levtr)");
+        conn.set_setting("indices", "created");
+    }
+    indices_deferred = false;
+}
+
+void Driver::on_write()
+{
+    // Indices deferred by a bulk import are created by the first write that
+    // is not part of a bulk import. Reader connections never create them,
+    // not to take the write lock on the database.
+    if (indices_deferred && conn.profile != "bulk" && conn.profile != "reader")
+        build_deferred_indices();
 }
+
+void Driver::add_query_indices()
+{
+    // data_code_dt also includes the station and level/timerange, so that
+    // summary queries by variable can run on the index alone
+    conn.exec("CREATE INDEX IF NOT EXISTS data_dt ON data(datetime)");
+    conn.exec("CREATE INDEX IF NOT EXISTS data_code_dt ON data(code, datetime, id_station, id_levtr)");
+}
+
+bool Driver::has_index(const char* name)
+{
+    auto stm = conn.sqlitestatement("SELECT COUNT(*) FROM sqlite_master WHERE type='index' AND name=?");
+    stm->bind(name);
+    int count = 0;
+    stm->execute_one([&]() {
+        count = stm->column_int(0);
+    });
+    return count > 0;
+}
+
 void Driver::delete_tables_v7()
 {
     conn.drop_table_if_exists("data");
@@ -130,6 +238,9 @@ void Driver::delete_tables_v7()
     conn.drop_table_if_exists("repinfo");
     conn.drop_table_if_exists("station");
     conn.drop_settings();
+    station_grid = false;
+    indices_deferred = false;
+    conn.integer_datetimes = false;
 }
 void Driver::vacuum_v7()
 {
@@ -13,6 +13,14 @@ struct Driver : public v7::Driver
 {
     dballe::sql::SQLiteConnection& conn;
 
+    /**
+     * Store datetimes as integer seconds since the epoch when creating new
+     * tables.
+     *
+     * Existing databases keep the encoding recorded in their settings.
+     */
+    bool create_integer_datetimes = false;
+
     Driver(dballe::sql::SQLiteConnection& conn);
     virtual ~Driver();
 
@@ -24,6 +32,34 @@ struct Driver : public v7::Driver
     void create_tables_v7() override;
     void delete_tables_v7() override;
     void vacuum_v7() override;
+    void add_query_indices() override;
+
+    /**
+     * Create the data_lt and pa_lon indices, if their creation was deferred
+     * by creating the tables with the bulk profile.
+     */
+    void build_deferred_indices() override;
+    void on_write() override;
+
+    /**
+     * Rebuild the data table storing datetimes as integer seconds since the
+     * epoch if \a integer is true, or as text if it is false.
+     *
+     * It does nothing if the database already uses the requested encoding.
+     * It raises error_consistency, without changing the database, if a
+     * datetime is not valid. It should be run inside a transaction.
+     */
+    void convert_datetimes(bool integer);
+
+protected:
+    /// True if the settings record that the secondary indices are deferred
+    bool indices_deferred = false;
+
+    /// Create the data table with the given name and datetime encoding
+    void create_data_table(const char* name, bool integer);
+
+    /// Check if the database has an index with the given name
+    bool has_index(const char* name);
 };
 
 }
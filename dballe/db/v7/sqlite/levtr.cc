@@ -48,6 +48,8 @@ static const char* select_data_query =
     "SELECT ltype1, l1, ltype2, l2, pind, p1, p2 FROM levtr WHERE id=?";
 static const char* insert_query =
     "INSERT INTO levtr (ltype1, l1, ltype2, l2, pind, p1, p2) VALUES (?, ?, ?, ?, ?, ?, ?)";
+static const char* select_all_query =
+    "SELECT id, ltype1, l1, ltype2, l2, pind, p1, p2 FROM levtr";
 
 SQLiteLevTr::SQLiteLevTr(v7::Transaction& tr, SQLiteConnection& conn)
     : v7::LevTr(tr), conn(conn)
@@ -71,28 +73,41 @@ SQLiteLevTr::~SQLiteLevTr()
 
 void SQLiteLevTr::prefetch_ids(Tracer<>& trc, const std::set<int>& ids)
 {
-    if (ids.empty()) return;
+    if (ids.empty() || cache.complete) return;
 
-    sql::Querybuf qb;
-    if (ids.size() < 100)
+    // With many IDs, it is faster to load the whole table
+    if (ids.size() >= 100)
     {
-        qb.append("SELECT id, ltype1, l1, ltype2, l2, pind, p1, p2 FROM levtr WHERE id IN (");
-        qb.start_list(",");
-        for (auto id: ids)
-            qb.append_listf("%d", id);
-        qb.append(")");
-    } else
-        qb.append("SELECT id, ltype1, l1, ltype2, l2, pind, p1, p2 FROM levtr");
+        preload(trc);
+        return;
+    }
+
+    sql::Querybuf qb;
+    qb.append("SELECT id, ltype1, l1, ltype2, l2, pind, p1, p2 FROM levtr WHERE id IN (");
+    qb.start_list(",");
+    for (auto id: ids)
+        qb.append_listf("%d", id);
+    qb.append(")");
 
     Tracer<> trc_sel(trc ? trc->trace_select(qb) : nullptr);
     auto stm = conn.sqlitestatement(qb);
     stm->execute([&]() {
         if (trc_sel) trc_sel->add_row();
-        cache.insert(unique_ptr<LevTrEntry>(new LevTrEntry(
-                stm->column_int(0),
-                Level(stm->column_int(1), stm->column_int(2), stm->column_int(3), stm->column_int(4)),
-                Trange(stm->column_int(5), stm->column_int(6), stm->column_int(7)))));
+        cache.insert(LevTrEntry(stm->column_int(0), to_level(*stm, 1), to_trange(*stm, 5)));
+    });
+}
+
+void SQLiteLevTr::preload(Tracer<>& trc)
+{
+    if (cache.complete) return;
+
+    Tracer<> trc_sel(trc ? trc->trace_select(select_all_query) : nullptr);
+    auto stm = conn.sqlitestatement(select_all_query);
+    stm->execute([&]() {
+        if (trc_sel) trc_sel->add_row();
+        cache.insert(LevTrEntry(stm->column_int(0), to_level(*stm, 1), to_trange(*stm, 5)));
     });
+    cache.complete = true;
 }
 
 const LevTrEntry* SQLiteLevTr::lookup_id(Tracer<>& trc, int id)
@@ -105,16 +120,7 @@ const LevTrEntry* SQLiteLevTr::lookup_id(Tracer<>& trc, int id)
     sdstm->bind(id);
     sdstm->execute_one([&]() {
         if (trc_sel) trc_sel->add_row();
-        std::unique_ptr<LevTrEntry> e(new LevTrEntry);
-        e->id = id;
-        e->level.ltype1 = sdstm->column_int(0);
-        e->level.l1 = sdstm->column_int(1);
-        e->level.ltype2 = sdstm->column_int(2);
-        e->level.l2 = sdstm->column_int(3);
-        e->trange.pind = sdstm->column_int(4);
-        e->trange.p1 = sdstm->column_int(5);
-        e->trange.p2 = sdstm->column_int(6);
-        res = cache.insert(move(e));
+        res = cache.insert(LevTrEntry(id, to_level(*sdstm), to_trange(*sdstm, 4)));
     });
 
     if (!res)
@@ -43,6 +43,7 @@ public:
     ~SQLiteLevTr();
 
     void prefetch_ids(Tracer<>& trc, const std::set<int>& id) override;
+    void preload(Tracer<>& trc) override;
     const LevTrEntry* lookup_id(Tracer<>& trc, int id) override;
     int obtain_id(Tracer<>& trc, const LevTrEntry& desc) override;
 };
@@ -5,6 +5,7 @@
 #include "dballe/db/v7/trace.h"
 #include "dballe/db/v7/qbuilder.h"
 #include "dballe/sql/sqlite.h"
+#include "dballe/sql/querybuf.h"
 #include "dballe/core/var.h"
 #include "dballe/values.h"
 #include <wreport/var.h>
@@ -27,6 +28,9 @@ static const char* select_mobile_query =
 static const char* insert_query =
         "INSERT INTO station (rep, lat, lon, ident)"
         " VALUES (?, ?, ?, ?);";
+static const char* insert_grid_query =
+        "INSERT INTO station (rep, lat, lon, ident, grid)"
+        " VALUES (?, ?, ?, ?, ?);";
 static const char* select_station_data_query =
         "SELECT rep, lat, lon, ident FROM station WHERE id=?";
 
@@ -40,7 +44,7 @@ SQLiteStation::SQLiteStation(v7::Transaction& tr, SQLiteConnection& conn)
     smstm = conn.sqlitestatement(select_mobile_query).release();
 
     // Create the statement for insert
-    istm = conn.sqlitestatement(insert_query).release();
+    istm = conn.sqlitestatement(station_grid ? insert_grid_query : insert_query).release();
 
     // Create the statement for insert
     ssdstm = conn.sqlitestatement(select_station_data_query).release();
@@ -129,8 +133,10 @@ int SQLiteStation::insert_new(Tracer<>& trc, const dballe::DBStation& desc)
         istm->bind_val(4, desc.ident.get());
     else
         istm->bind_null_val(4);
+    if (station_grid)
+        istm->bind_val(5, grid_cell(desc.coords));
     istm->execute();
-    if (trc) trc->trace_insert(insert_query, 1);
+    if (trc) trc->trace_insert(station_grid ? insert_grid_query : insert_query, 1);
     return conn.get_last_insert_id();
 }
 
@@ -166,6 +172,28 @@ void SQLiteStation::get_station_vars(Tracer<>& trc, int id_station, std::functio
     });
 }
 
+void SQLiteStation::get_station_vars(Tracer<>& trc, const std::set<int>& ids, std::function<void(int id_station, std::unique_ptr<wreport::Var>)> dest)
+{
+    if (ids.empty()) return;
+
+    sql::Querybuf qb;
+    qb.append("SELECT d.id_station, d.code, d.value, d.attrs FROM station_data d WHERE d.id_station IN (");
+    qb.start_list(",");
+    for (auto id: ids)
+        qb.append_listf("%d", id);
+    qb.append(") ORDER BY d.id_station, d.code");
+
+    Tracer<> trc_sel(trc ? trc->trace_select(qb) : nullptr);
+    auto stm = conn.sqlitestatement(qb);
+    stm->execute([&]() {
+        if (trc_sel) trc_sel->add_row();
+        unique_ptr<Var> var = newvar((Varcode)stm->column_int(1), stm->column_string(2));
+        if (!stm->column_isnull(3))
+            DBValues::decode(stm->column_blob(3), [&](unique_ptr<wreport::Var> a) { var->seta(move(a)); });
+        dest(stm->column_int(0), move(var));
+    });
+}
+
 void SQLiteStation::add_station_vars(Tracer<>& trc, int id_station, DBValues& values)
 {
     const char* query = R"(
@@ -6,6 +6,8 @@
 #include "repinfo.h"
 #include "station.h"
 #include "transaction.h"
+#include "qbuilder.h"
+#include "dballe/core/query.h"
 #include "config.h"
 
 using namespace dballe;
@@ -23,12 +25,34 @@ class Tests : public FixtureTestCase<EmptyTransactionFixture<V7DB>>
     void register_tests() override;
 };
 
+struct GridFixture : public EmptyTransactionFixture<V7DB>
+{
+    using EmptyTransactionFixture::EmptyTransactionFixture;
+
+    void create_db() override
+    {
+        db = V7DB::create_db(backend, false);
+        db->driver().create_station_grid = true;
+        db->reset();
+    }
+};
+
+class GridTests : public FixtureTestCase<GridFixture>
+{
+    using FixtureTestCase::FixtureTestCase;
+
+    void register_tests() override;
+};
+
 Tests test_sqlite("db_v7_station_sqlite", "SQLITE");
+GridTests test_grid_sqlite("db_v7_station_grid_sqlite", "SQLITE");
 #ifdef HAVE_LIBPQ
 Tests test_psql("db_v7_station_postgresql", "POSTGRESQL");
+GridTests test_grid_psql("db_v7_station_grid_postgresql", "POSTGRESQL");
 #endif
 #ifdef HAVE_MYSQL
 Tests test_mysql("db_v7_station_mysql", "MYSQL");
+GridTests test_grid_mysql("db_v7_station_grid_mysql", "MYSQL");
 #endif
 
 void Tests::register_tests()
@@ -74,6 +98,143 @@ add_method("insert", [](Fixture& f) {
     wassert(actual(si) == 2);
 });
 
+add_method("add_station_grid", [](Fixture& f) {
+    // Adding the grid column changes the schema: recreate the database for
+    // the next tests
+    f.destroys_db = true;
+    f.tr->rollback();
+    f.tr.reset();
+
+    // Stations inserted before the migration
+    const Coords coords[] = {
+        Coords(4550000, 1100000),
+        Coords(-3350000, -7050000),
+        Coords(50000, 17950000),
+        Coords(-50000, -17950000),
+    };
+    const char* queries[] = {
+        "latmin=45.0, latmax=46.0, lonmin=10.5, lonmax=11.5",
+        "latmin=-34.0, latmax=-33.0, lonmin=-71.0, lonmax=-70.0",
+        "latmin=0.0, latmax=1.0, lonmin=179.0, lonmax=179.9",
+        "latmin=-1.0, latmax=0.0, lonmin=-180.0, lonmax=-179.0",
+    };
+
+    core::Data vals;
+    vals.station.report = "ship";
+    vals.level = Level(1);
+    vals.trange = Trange::instant();
+    vals.datetime = Datetime(2018, 1, 1);
+    vals.values.set("B12101", 273.15);
+    auto tr = dynamic_pointer_cast<db::v7::Transaction>(f.db->transaction());
+    for (const auto& c: coords)
+    {
+        vals.clear_ids();
+        vals.station.coords = c;
+        vals.station.ident = "mobile";
+        wassert(tr->insert_data(vals));
+    }
+    tr->commit();
+
+    wassert(f.db->driver().add_station_grid());
+    wassert_true(f.db->driver().has_station_grid());
+
+    // The migration computes the same cells as Station::grid_cell, so area
+    // queries going through the grid find every station
+    tr = dynamic_pointer_cast<db::v7::Transaction>(f.db->transaction());
+    for (const auto& q: queries)
+    {
+        WREPORT_TEST_INFO(info);
+        info() << q;
+        auto cur = tr->query_stations(core_query_from_string(q));
+        wassert(actual(cur->remaining()) == 1);
+        cur->discard();
+    }
+    tr->rollback();
+});
+
+}
+
+void GridTests::register_tests()
+{
+add_method("grid_cell", [](GridFixture& f) {
+    using db::v7::Station;
+    wassert(actual(Station::grid_cell(Coords(-9000000, -18000000))) == 0);
+    wassert(actual(Station::grid_cell(Coords(0, 0))) == 90 * 360 + 180);
+    wassert(actual(Station::grid_cell(Coords(-1, -1))) == 89 * 360 + 179);
+    wassert(actual(Station::grid_cell(Coords(4550000, 1100000))) == 135 * 360 + 191);
+    wassert(actual(Station::grid_cell(Coords(9000000, 17999999))) == 180 * 360 + 359);
+});
+
+add_method("query", [](GridFixture& f) {
+    wassert_true(f.db->driver().has_station_grid());
+
+    const Coords coords[] = {
+        Coords(4550000, 1100000),
+        Coords(4450000, 1150000),
+        Coords(4400000, 1000000),
+        Coords(-3350000, -7050000),
+        Coords(-3300000, -7000000),
+        Coords(50000, 17950000),
+        Coords(-50000, -17950000),
+        Coords(0, 0),
+        Coords(8990000, 4500000),
+    };
+
+    core::Data vals;
+    vals.station.report = "ship";
+    vals.level = Level(1);
+    vals.trange = Trange::instant();
+    vals.datetime = Datetime(2018, 1, 1);
+    vals.values.set("B12101", 273.15);
+    for (const auto& c: coords)
+    {
+        vals.clear_ids();
+        vals.station.coords = c;
+        vals.station.ident = "mobile";
+        wassert(f.tr->insert_data(vals));
+    }
+
+    const char* queries[] = {
+        "latmin=44.0, latmax=46.0, lonmin=10.5, lonmax=12.0",
+        "latmin=45.5, latmax=45.5, lonmin=11.0, lonmax=11.0",
+        "latmin=-34.0, latmax=-33.0",
+        "latmin=-1.0, latmax=1.0, lonmin=179.0, lonmax=-179.0",
+        "lonmin=-71.0, lonmax=-70.0",
+        "latmin=80.0",
+        "latmax=-0.1",
+    };
+
+    for (const auto& q: queries)
+    {
+        WREPORT_TEST_INFO(info);
+        info() << q;
+
+        core::Query query = core_query_from_string(q);
+        unsigned expected = 0;
+        for (const auto& c: coords)
+            if (query.latrange.contains(c.lat) && query.lonrange.contains(c.lon))
+                ++expected;
+
+        auto cur = f.tr->query_stations(query);
+        wassert(actual(cur->remaining()) == expected);
+        cur->discard();
+    }
+
+    // Small areas are looked up using the grid
+    core::Query query = core_query_from_string(queries[0]);
+    db::v7::StationQueryBuilder qb(f.tr, query, 0);
+    qb.build();
+    wassert(actual((std::string)qb.sql_query).contains("s.grid BETWEEN"));
+
+    // Areas spanning many rows and columns use only latitude and longitude
+    query = core_query_from_string("latmin=-60.0, latmax=60.0, lonmin=-90.0, lonmax=90.0");
+    db::v7::StationQueryBuilder qb1(f.tr, query, 0);
+    qb1.build();
+    wassert(actual((std::string)qb1.sql_query).not_contains("grid"));
+});
+
+}
+
 }
 
 }
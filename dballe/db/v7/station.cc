@@ -1,6 +1,8 @@
 #include "station.h"
 #include "dballe/core/values.h"
 #include "transaction.h"
+#include "db.h"
+#include "driver.h"
 
 using namespace wreport;
 using namespace dballe::db;
@@ -10,9 +12,17 @@ namespace dballe {
 namespace db {
 namespace v7 {
 
+constexpr int Station::grid_step;
+constexpr int Station::grid_columns;
+
 Station::Station(v7::Transaction& tr)
-    : tr(tr)
+    : tr(tr), station_grid(tr.db->driver().has_station_grid())
+{
+}
+
+int Station::grid_cell(const Coords& coords)
 {
+    return grid_row(coords.lat) * grid_columns + grid_column(coords.lon);
 }
 
 Station::~Station()
@@ -9,6 +9,7 @@
 #include <memory>
 #include <cstdio>
 #include <functional>
+#include <set>
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
@@ -25,9 +26,29 @@ struct Station
 {
 protected:
     v7::Transaction& tr;
+    /// True if new stations need to have their grid cell stored
+    bool station_grid;
     virtual void _dump(std::function<void(int, int, const Coords& coords, const char* ident)> out) = 0;
 
 public:
+    /// Size of the cells of the station grid, in 1/100000 of degree
+    static constexpr int grid_step = 100000;
+    /// Number of cells in each latitude row of the station grid
+    static constexpr int grid_columns = 360;
+
+    /// Latitude row of the station grid cell that contains \a lat
+    static int grid_row(int lat) { return (lat + 9000000) / grid_step; }
+
+    /// Longitude column of the station grid cell that contains \a lon
+    static int grid_column(int lon)
+    {
+        int res = (lon + 18000000) / grid_step;
+        return res < grid_columns ? res : grid_columns - 1;
+    }
+
+    /// Index of the station grid cell that contains the given coordinates
+    static int grid_cell(const Coords& coords);
+
     Station(v7::Transaction& tr);
     virtual ~Station();
 
@@ -58,6 +79,14 @@ public:
      */
     virtual void get_station_vars(Tracer<>& trc, int id_station, std::function<void(std::unique_ptr<wreport::Var>)> dest) = 0;
 
+    /**
+     * Export the station variables of many stations with a single query.
+     *
+     * Variables are sent to dest grouped by station, and sorted by varcode
+     * inside each station.
+     */
+    virtual void get_station_vars(Tracer<>& trc, const std::set<int>& ids, std::function<void(int id_station, std::unique_ptr<wreport::Var>)> dest) = 0;
+
     /**
      * Add all station variables (without attributes) to values.
      *
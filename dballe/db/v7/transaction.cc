@@ -9,6 +9,7 @@
 #include "trace.h"
 #include "dballe/core/query.h"
 #include "dballe/core/data.h"
+#include "dballe/core/workers.h"
 #include "dballe/sql/sql.h"
 #include <cassert>
 #include <memory>
@@ -20,6 +21,37 @@ namespace dballe {
 namespace db {
 namespace v7 {
 
+/**
+ * Messages queued by Transaction::import_messages.
+ *
+ * The job owns a copy of the messages, so that the caller can reuse or
+ * modify them while they are written.
+ */
+struct WriteBehindJob
+{
+    std::vector<std::shared_ptr<dballe::Message>> messages;
+    impl::DBImportOptions opts;
+
+    WriteBehindJob(const std::vector<std::shared_ptr<dballe::Message>>& messages, const dballe::DBImportOptions& opts)
+        : opts(opts)
+    {
+        this->messages.reserve(messages.size());
+        for (const auto& msg: messages)
+            this->messages.emplace_back(msg->clone());
+    }
+};
+
+/**
+ * Thread that writes the queued messages.
+ *
+ * While there are queued messages, only this thread uses the database
+ * connection.
+ */
+struct WriteBehind : public core::OrderedWorkers<WriteBehindJob, bool>
+{
+    using OrderedWorkers::OrderedWorkers;
+};
+
 Transaction::Transaction(std::shared_ptr<v7::DB> db, std::unique_ptr<dballe::sql::Transaction> sql_transaction)
     : db(db), sql_transaction(std::move(sql_transaction)), batch(*this), trc(db->trace->trace_transaction())
 {
@@ -68,6 +100,7 @@ v7::Data& Transaction::data()
 void Transaction::commit()
 {
     if (fired) return;
+    sync_imports();
     sql_transaction->commit();
     clear_cached_state();
     fired = true;
@@ -77,6 +110,8 @@ void Transaction::commit()
 void Transaction::rollback()
 {
     if (fired) return;
+    write_behind.reset();
+    write_behind_error = nullptr;
     sql_transaction->rollback();
     clear_cached_state();
     fired = true;
@@ -86,14 +121,74 @@ void Transaction::rollback()
 void Transaction::rollback_nothrow() noexcept
 {
     if (fired) return;
+    write_behind.reset();
+    write_behind_error = nullptr;
     sql_transaction->rollback_nothrow();
     clear_cached_state();
     fired = true;
     trc.done();
 }
 
+void Transaction::preload_levtr()
+{
+    sync_imports();
+    Tracer<> trc(this->trc ? this->trc->trace_func("preload_levtr") : nullptr);
+    levtr().preload(trc);
+}
+
+void Transaction::queue_import(const std::vector<std::shared_ptr<Message>>& messages, const dballe::DBImportOptions& opts)
+{
+    if (write_behind_error)
+        std::rethrow_exception(write_behind_error);
+
+    if (!write_behind)
+    {
+        write_behind_failed = false;
+        write_behind.reset(new WriteBehind(1, db->write_behind, [this](unsigned, WriteBehindJob& job) {
+            // After a failure the transaction can only be rolled back: do
+            // not write anything else
+            if (write_behind_failed)
+                return false;
+            try {
+                import_messages_now(job.messages, job.opts);
+            } catch (...) {
+                write_behind_failed = true;
+                throw;
+            }
+            return true;
+        }));
+    }
+
+    if (write_behind->full())
+        pop_import();
+    write_behind->submit(WriteBehindJob(messages, opts));
+}
+
+void Transaction::pop_import()
+{
+    try {
+        write_behind->pop();
+    } catch (...) {
+        // Stop at the first error, discarding the imports queued after it,
+        // and refuse to do anything else until the transaction is rolled
+        // back
+        write_behind_error = std::current_exception();
+        write_behind.reset();
+        throw;
+    }
+}
+
+void Transaction::sync_imports()
+{
+    if (write_behind_error)
+        std::rethrow_exception(write_behind_error);
+    while (write_behind && !write_behind->empty())
+        pop_import();
+}
+
 void Transaction::clear_cached_state()
 {
+    sync_imports();
     repinfo().read_cache();
     levtr().clear_cache();
     station_data().clear_cache();
@@ -110,6 +205,7 @@ Transaction& Transaction::downcast(dballe::db::Transaction& transaction)
 
 void Transaction::remove_all()
 {
+    sync_imports();
     auto trc = db->trace->trace_remove_all();
     db->driver().remove_all_v7(); // TODO: pass trace step
     clear_cached_state();
@@ -117,6 +213,8 @@ void Transaction::remove_all()
 
 void Transaction::insert_station_data(dballe::Data& vals, const dballe::DBInsertOptions& opts)
 {
+    sync_imports();
+    db->driver().on_write();
     Tracer<> trc(this->trc ? this->trc->trace_insert_station_data() : nullptr);
     core::Data& data = core::Data::downcast(vals);
     batch::Station* st = batch.get_station(trc, data.station, opts.can_add_stations);
@@ -142,6 +240,8 @@ void Transaction::insert_station_data(dballe::Data& vals, const dballe::DBInsert
 
 void Transaction::insert_data(dballe::Data& vals, const dballe::DBInsertOptions& opts)
 {
+    sync_imports();
+    db->driver().on_write();
     core::Data& data = core::Data::downcast(vals);
     if (data.values.empty())
         throw error_notfound("no variables found in input record");
@@ -179,6 +279,8 @@ void Transaction::insert_data(dballe::Data& vals, const dballe::DBInsertOptions&
 
 void Transaction::remove_station_data(const Query& query)
 {
+    sync_imports();
+    db->driver().on_write();
     Tracer<> trc(this->trc ? this->trc->trace_remove_station_data(query) : nullptr);
     cursor::run_delete_query(trc, dynamic_pointer_cast<v7::Transaction>(shared_from_this()), core::Query::downcast(query), true, db->explain_queries);
     batch.clear();
@@ -186,6 +288,8 @@ void Transaction::remove_station_data(const Query& query)
 
 void Transaction::remove_data(const Query& query)
 {
+    sync_imports();
+    db->driver().on_write();
     Tracer<> trc(this->trc ? this->trc->trace_remove_data(query) : nullptr);
     cursor::run_delete_query(trc, dynamic_pointer_cast<v7::Transaction>(shared_from_this()), core::Query::downcast(query), false, db->explain_queries);
     batch.clear();
@@ -193,6 +297,8 @@ void Transaction::remove_data(const Query& query)
 
 void Transaction::remove_station_data_by_id(int id)
 {
+    sync_imports();
+    db->driver().on_write();
     Tracer<> trc(this->trc ? this->trc->trace_remove_station_data_by_id(id) : nullptr);
     station_data().remove_by_id(trc, id);
     batch.clear();
@@ -200,13 +306,24 @@ void Transaction::remove_station_data_by_id(int id)
 
 void Transaction::remove_data_by_id(int id)
 {
+    sync_imports();
+    db->driver().on_write();
     Tracer<> trc(this->trc ? this->trc->trace_remove_data_by_id(id) : nullptr);
     data().remove_by_id(trc, id);
     batch.clear();
 }
 
+void Transaction::drop_partition(int year, int month)
+{
+    sync_imports();
+    Tracer<> trc(this->trc ? this->trc->trace_func("drop_partition") : nullptr);
+    db->driver().drop_partition(year, month);
+    clear_cached_state();
+}
+
 std::unique_ptr<dballe::CursorStation> Transaction::query_stations(const Query& query)
 {
+    sync_imports();
     Tracer<> trc(this->trc ? this->trc->trace_query_stations(query) : nullptr);
     auto res = cursor::run_station_query(trc, dynamic_pointer_cast<v7::Transaction>(shared_from_this()), core::Query::downcast(query), db->explain_queries);
     return res;
@@ -214,6 +331,7 @@ std::unique_ptr<dballe::CursorStation> Transaction::query_stations(const Query&
 
 std::unique_ptr<dballe::CursorStationData> Transaction::query_station_data(const Query& query)
 {
+    sync_imports();
     Tracer<> trc(this->trc ? this->trc->trace_query_station_data(query) : nullptr);
     auto res = cursor::run_station_data_query(trc, dynamic_pointer_cast<v7::Transaction>(shared_from_this()), core::Query::downcast(query), db->explain_queries);
     return res;
@@ -221,6 +339,7 @@ std::unique_ptr<dballe::CursorStationData> Transaction::query_station_data(const
 
 std::unique_ptr<dballe::CursorData> Transaction::query_data(const Query& query)
 {
+    sync_imports();
     Tracer<> trc(this->trc ? this->trc->trace_query_data(query) : nullptr);
     auto res = cursor::run_data_query(trc, dynamic_pointer_cast<v7::Transaction>(shared_from_this()), core::Query::downcast(query), db->explain_queries);
     return res;
@@ -228,6 +347,7 @@ std::unique_ptr<dballe::CursorData> Transaction::query_data(const Query& query)
 
 std::unique_ptr<dballe::CursorSummary> Transaction::query_summary(const Query& query)
 {
+    sync_imports();
     Tracer<> trc(this->trc ? this->trc->trace_query_summary(query) : nullptr);
     auto res = cursor::run_summary_query(trc, dynamic_pointer_cast<v7::Transaction>(shared_from_this()), core::Query::downcast(query), db->explain_queries);
     return res;
@@ -235,6 +355,7 @@ std::unique_ptr<dballe::CursorSummary> Transaction::query_summary(const Query& q
 
 void Transaction::attr_query_station(int data_id, std::function<void(std::unique_ptr<wreport::Var>)> dest)
 {
+    sync_imports();
     Tracer<> trc(this->trc ? this->trc->trace_func("attr_query_station") : nullptr);
     // Create the query
     auto& d = station_data();
@@ -243,6 +364,7 @@ void Transaction::attr_query_station(int data_id, std::function<void(std::unique
 
 void Transaction::attr_query_data(int data_id, std::function<void(std::unique_ptr<wreport::Var>)> dest)
 {
+    sync_imports();
     Tracer<> trc(this->trc ? this->trc->trace_func("attr_query_data") : nullptr);
     // Create the query
     auto& d = data();
@@ -251,6 +373,7 @@ void Transaction::attr_query_data(int data_id, std::function<void(std::unique_pt
 
 void Transaction::attr_insert_station(int data_id, const Values& attrs)
 {
+    sync_imports();
     Tracer<> trc(this->trc ? this->trc->trace_func("attr_insert_station") : nullptr);
     auto& d = station_data();
     d.merge_attrs(trc, data_id, attrs);
@@ -258,6 +381,7 @@ void Transaction::attr_insert_station(int data_id, const Values& attrs)
 
 void Transaction::attr_insert_data(int data_id, const Values& attrs)
 {
+    sync_imports();
     Tracer<> trc(this->trc ? this->trc->trace_func("attr_insert_data") : nullptr);
     auto& d = data();
     d.merge_attrs(trc, data_id, attrs);
@@ -265,6 +389,7 @@ void Transaction::attr_insert_data(int data_id, const Values& attrs)
 
 void Transaction::attr_remove_station(int data_id, const db::AttrList& attrs)
 {
+    sync_imports();
     Tracer<> trc(this->trc ? this->trc->trace_func("attr_remove_station") : nullptr);
     if (attrs.empty())
     {
@@ -281,6 +406,7 @@ void Transaction::attr_remove_station(int data_id, const db::AttrList& attrs)
 
 void Transaction::attr_remove_data(int data_id, const db::AttrList& attrs)
 {
+    sync_imports();
     Tracer<> trc(this->trc ? this->trc->trace_func("attr_remove_data") : nullptr);
     if (attrs.empty())
     {
@@ -297,11 +423,13 @@ void Transaction::attr_remove_data(int data_id, const db::AttrList& attrs)
 
 void Transaction::update_repinfo(const char* repinfo_file, int* added, int* deleted, int* updated)
 { // TODO: tracing
+    sync_imports();
     repinfo().update(repinfo_file, added, deleted, updated);
 }
 
 void Transaction::dump(FILE* out)
 {
+    sync_imports();
     repinfo().dump(out);
     station().dump(out);
     levtr().dump(out);
@@ -7,10 +7,12 @@
 #include <dballe/db/v7/batch.h>
 #include <dballe/sql/fwd.h>
 #include <memory>
+#include <exception>
 
 namespace dballe {
 namespace db {
 namespace v7 {
+struct WriteBehind;
 
 struct Transaction : public dballe::db::Transaction
 {
@@ -25,9 +27,33 @@ protected:
     v7::StationData* m_station_data = nullptr;
     /// Variable data
     v7::Data* m_data = nullptr;
+    /// Thread writing the messages queued by import_messages(), if any
+    std::unique_ptr<WriteBehind> write_behind;
+    /**
+     * First error raised writing the queued messages: once set, the
+     * transaction can only be rolled back
+     */
+    std::exception_ptr write_behind_error;
+    /**
+     * Set by the write-behind thread when writing fails, to skip the messages
+     * queued after the failed ones. Only accessed by the write-behind thread.
+     */
+    bool write_behind_failed = false;
 
     void add_msg_to_batch(Tracer<>& trc, const Message& message, const dballe::DBImportOptions& opts);
 
+    /// Import messages in the calling thread
+    void import_messages_now(const std::vector<std::shared_ptr<Message>>& msgs, const dballe::DBImportOptions& opts);
+
+    /// Queue messages for import by the write-behind thread
+    void queue_import(const std::vector<std::shared_ptr<Message>>& msgs, const dballe::DBImportOptions& opts);
+
+    /**
+     * Wait for the oldest queued import to be written, stopping the
+     * write-behind thread and recording the error if it failed
+     */
+    void pop_import();
+
 public:
     typedef v7::DB DB;
 
@@ -64,6 +90,24 @@ public:
     void rollback_nothrow() noexcept override;
     void clear_cached_state() override;
 
+    /// Load the whole levtr table in the levtr cache
+    void preload_levtr();
+
+    /**
+     * Wait until all the messages queued by import_messages() have been
+     * written.
+     *
+     * Errors found while writing them are raised here. After an error, the
+     * messages queued after the failed ones are discarded, and the same error
+     * is raised again by this and by all the other methods of the
+     * transaction, including commit(), until it is rolled back.
+     *
+     * All the other methods of the transaction, and the cursors they return,
+     * call this before accessing the database, so that the write-behind
+     * thread is never using the connection and the caches at the same time.
+     */
+    void sync_imports();
+
     std::unique_ptr<dballe::CursorStation> query_stations(const Query& query);
     std::unique_ptr<dballe::CursorStationData> query_station_data(const Query& query) override;
     std::unique_ptr<dballe::CursorData> query_data(const Query& query);
@@ -80,6 +124,15 @@ public:
     void remove_data_by_id(int id);
     void remove_all() override;
 
+    /**
+     * Remove all the measured data of the given month, by dropping its
+     * partition.
+     *
+     * This only works on databases whose data table is split in monthly
+     * partitions.
+     */
+    void drop_partition(int year, int month);
+
     void attr_insert_station(int data_id, const Values& attrs) override;
     void attr_insert_data(int data_id, const Values& attrs) override;
     void attr_remove_station(int data_id, const db::AttrList& attrs) override;
@@ -22,12 +22,12 @@ std::unique_ptr<ExporterOptions> ExporterOptions::create()
 
 bool ExporterOptions::operator==(const ExporterOptions& o) const
 {
-    return std::tie(template_name, centre, subcentre, application) == std::tie(o.template_name, o.centre, o.subcentre, o.application);
+    return std::tie(template_name, centre, subcentre, application, compression) == std::tie(o.template_name, o.centre, o.subcentre, o.application, o.compression);
 }
 
 bool ExporterOptions::operator!=(const ExporterOptions& o) const
 {
-    return std::tie(template_name, centre, subcentre, application) != std::tie(o.template_name, o.centre, o.subcentre, o.application);
+    return std::tie(template_name, centre, subcentre, application, compression) != std::tie(o.template_name, o.centre, o.subcentre, o.application, o.compression);
 }
 
 void ExporterOptions::print(FILE* out)
@@ -65,6 +65,12 @@ std::string ExporterOptions::to_string() const
         res += buf;
     }
 
+    if (compression)
+    {
+        if (!res.empty()) res += ", ";
+        res += "compression";
+    }
+
     return res;
 }
 
@@ -32,7 +32,11 @@ public:
     int subcentre = MISSING_INT;
     /// Originating application ID
     int application = MISSING_INT;
-
+    /**
+     * Compress BUFR bulletins with more than one subset, when all the
+     * subsets contain the same sequence of variables
+     */
+    bool compression = false;
 
     bool operator==(const ExporterOptions&) const;
     bool operator!=(const ExporterOptions&) const;
@@ -50,6 +50,28 @@ struct API
     virtual int query_data() = 0;
     virtual wreport::Varcode next_data() = 0;
     virtual void insert_data() = 0;
+    /**
+     * Set \a count values from the \a codes and \a values arrays as if
+     * calling setd for each of them, then call insert_data.
+     *
+     * Values set to missing_double are unset.
+     */
+    virtual void insert_data_array(unsigned count, const wreport::Varcode* codes, const double* values) = 0;
+    /**
+     * Move forward in the results of query_data, returning at most \a max
+     * values that share the same station, datetime, level and time range.
+     *
+     * Varcodes and values are stored in the \a codes and \a values arrays,
+     * and unset values are returned as missing_double. After the call, the
+     * query functions refer to the last value returned.
+     *
+     * Returns the number of values read, or 0 at the end of the results.
+     *
+     * It stops before a string variable, leaving it to be read with
+     * next_data(). If the next value is a string variable, it raises an
+     * error without moving forward.
+     */
+    virtual unsigned next_data_array(unsigned max, wreport::Varcode* codes, double* values) = 0;
     virtual void remove_data() = 0;
     virtual int query_attributes() = 0;
     virtual const char* next_attribute() = 0;
@@ -43,6 +43,7 @@ Operation::~Operation() {}
 void Operation::set_varcode(wreport::Varcode varcode) {}
 bool Operation::next_station() { throw error_consistency("next_station called without a previous query_stations"); }
 wreport::Varcode Operation::next_data() { throw error_consistency("next_data called without a previous query_data"); }
+unsigned Operation::next_data_array(unsigned max, wreport::Varcode* codes, double* values) { throw error_consistency("next_data_array called without a previous query_data"); }
 
 signed char Operation::enqb(const char* param) const
 {
@@ -441,6 +442,26 @@ wreport::Varcode CommonAPIImplementation::next_data()
     return operation->next_data();
 }
 
+void CommonAPIImplementation::insert_data_array(unsigned count, const wreport::Varcode* codes, const double* values)
+{
+    for (unsigned i = 0; i < count; ++i)
+    {
+        if (values[i] == API::missing_double)
+            input_data.values.unset(codes[i]);
+        else
+            input_data.values.set(codes[i], values[i]);
+    }
+    insert_data();
+}
+
+unsigned CommonAPIImplementation::next_data_array(unsigned max, wreport::Varcode* codes, double* values)
+{
+    if (!operation) throw error_consistency("next_data_array called without a previous query_data");
+    if (max == 0) throw error_consistency("next_data_array called with an empty output array");
+    qcoutput.invalidate();
+    return operation->next_data_array(max, codes, values);
+}
+
 int CommonAPIImplementation::query_attributes()
 {
     // Query attributes
@@ -51,6 +51,7 @@ public:
     virtual void remove_attributes() = 0;
     virtual bool next_station();
     virtual wreport::Varcode next_data();
+    virtual unsigned next_data_array(unsigned max, wreport::Varcode* codes, double* values);
 
     virtual int enqi(const char* param) const = 0;
     virtual signed char enqb(const char* param) const;
@@ -254,6 +255,8 @@ public:
     const char* describe_var(const char* varcode, const char* value) override;
     void next_station() override;
     wreport::Varcode next_data() override;
+    void insert_data_array(unsigned count, const wreport::Varcode* codes, const double* values) override;
+    unsigned next_data_array(unsigned max, wreport::Varcode* codes, double* values) override;
     int query_attributes() override;
     const char* next_attribute() override;
     void insert_attributes() override;
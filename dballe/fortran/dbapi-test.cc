@@ -1005,6 +1005,57 @@ this->add_method("negative_values", [](Fixture& f) {
     }
 });
 
+this->add_method("data_array", [](Fixture& f) {
+    fortran::DbAPI api(f.tr, "write", "write", "write");
+    api.setd("lat", 44.5);
+    api.setd("lon", 11.5);
+    api.setc("rep_memo", "synop");
+    api.settimerange(254, 0, 0);
+    api.setdate(2013, 4, 25, 12, 0, 0);
+
+    // Missing values are skipped
+    api.setlevel(103, 2000, MISSING_INT, MISSING_INT);
+    wreport::Varcode codes1[] = { WR_VAR(0, 12, 101), WR_VAR(0, 12, 103), WR_VAR(0, 13, 3) };
+    double values1[] = { 21.5, 10.5, fortran::API::missing_double };
+    wassert(api.insert_data_array(3, codes1, values1));
+
+    api.setlevel(103, 10000, MISSING_INT, MISSING_INT);
+    wreport::Varcode codes2[] = { WR_VAR(0, 11, 1), WR_VAR(0, 11, 2) };
+    double values2[] = { 90, 2.4 };
+    wassert(api.insert_data_array(2, codes2, values2));
+
+    api.unsetall();
+    wassert(actual(api.query_data()) == 4);
+
+    wreport::Varcode codes[3];
+    double values[3];
+
+    // Reading stops at the end of the level
+    wassert(actual(api.next_data_array(3, codes, values)) == 2);
+    wassert(actual(codes[0]) == WR_VAR(0, 12, 101));
+    wassert(actual(values[0]) == 21.5);
+    wassert(actual(codes[1]) == WR_VAR(0, 12, 103));
+    wassert(actual(values[1]) == 10.5);
+    int ltype1, l1, ltype2, l2;
+    api.enqlevel(ltype1, l1, ltype2, l2);
+    wassert(actual(ltype1) == 103);
+    wassert(actual(l1) == 2000);
+
+    // Reading stops when the output arrays are full
+    wassert(actual(api.next_data_array(1, codes, values)) == 1);
+    wassert(actual(codes[0]) == WR_VAR(0, 11, 1));
+    wassert(actual(values[0]) == 90);
+
+    wassert(actual(api.next_data_array(3, codes, values)) == 1);
+    wassert(actual(codes[0]) == WR_VAR(0, 11, 2));
+    wassert(actual(values[0]) == 2.4);
+    wassert(actual(api.enqd("B11002")) == 2.4);
+    api.enqlevel(ltype1, l1, ltype2, l2);
+    wassert(actual(l1) == 10000);
+
+    wassert(actual(api.next_data_array(3, codes, values)) == 0);
+});
+
 }
 
 template<typename DB>
@@ -137,6 +137,10 @@ struct CursorTraits<db::v7::cursor::StationData>
     {
         tr.attr_remove_station(id, attrs);
     }
+    static inline bool same_context(const db::v7::cursor::StationDataRow& a, const db::v7::cursor::StationDataRow& b)
+    {
+        return a.station.id == b.station.id;
+    }
 };
 
 template<>
@@ -154,6 +158,10 @@ struct CursorTraits<db::v7::cursor::Data>
     {
         tr.attr_remove_data(id, attrs);
     }
+    static inline bool same_context(const db::v7::cursor::DataRow& a, const db::v7::cursor::DataRow& b)
+    {
+        return a.station.id == b.station.id && a.id_levtr == b.id_levtr && a.datetime == b.datetime;
+    }
 };
 
 template<typename Cursor>
@@ -187,6 +195,42 @@ struct VoglioquestoOperation : public CursorOperation<Cursor>
             return 0;
         }
     }
+    unsigned next_data_array(unsigned max, wreport::Varcode* codes, double* values) override
+    {
+        if (next_data_ended) return 0;
+
+        auto& rows = this->cursor->rows;
+        unsigned count = 0;
+        while (count < max)
+        {
+            const auto* next = rows.peek_next();
+
+            // Stop at the end of the current station/datetime/level/trange
+            if (count > 0 && (!next || !CursorTraits<Cursor>::same_context(*rows.cur, *next)))
+                break;
+
+            // Leave string variables in the cursor, to be read with next_data
+            if (next && next->var_without_attrs().info()->is_string())
+            {
+                if (count > 0)
+                    break;
+                error_consistency::throwf("next_data_array cannot return the string variable %01d%02d%03d: read it with next_data", WR_VAR_FXY(next->code()));
+            }
+
+            if (!this->cursor->next())
+            {
+                next_data_ended = true;
+                break;
+            }
+
+            const Var& var = rows->var_without_attrs();
+            codes[count] = var.code();
+            values[count] = var.isset() ? var.enqd() : API::missing_double;
+            ++count;
+        }
+        valid_cached_attrs = true;
+        return count;
+    }
     void query_attributes(Attributes& dest) override
     {
         if (next_data_ended) throw error_consistency("query_attributes called after next_data returned end of data");
@@ -116,6 +116,11 @@ struct VoglioquestoOperation : public CursorOperation<Cursor>
         }
     }
 
+    unsigned next_data_array(unsigned max, wreport::Varcode* codes, double* values) override
+    {
+        throw error_unimplemented("next_data_array is not supported when reading messages");
+    }
+
     void query_attributes(Attributes& dest) override
     {
         if (next_data_ended) throw error_consistency("query_attributes called after next_data returned end of data");
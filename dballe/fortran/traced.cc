@@ -528,6 +528,79 @@ void TracedAPI::insert_data()
     RUN(insert_data);
 }
 
+namespace {
+
+void print_varcode(FILE* out, wreport::Varcode code)
+{
+    fprintf(out, "WR_VAR(%d, %d, %d)", WR_VAR_FXY(code));
+}
+
+void print_double(FILE* out, double val)
+{
+    if (val == API::missing_double)
+        fputs("API::missing_double", out);
+    else
+        fprintf(out, "%f", val);
+}
+
+}
+
+void TracedAPI::insert_data_array(unsigned count, const wreport::Varcode* codes, const double* values)
+{
+    FILE*& out = tracer.trace_file;
+    fputs("{\n", out);
+    fputs("    wreport::Varcode codes[] = {", out);
+    for (unsigned i = 0; i < count; ++i)
+    {
+        fputs(i ? ", " : " ", out);
+        print_varcode(out, codes[i]);
+    }
+    fputs(" };\n", out);
+    fputs("    double values[] = {", out);
+    for (unsigned i = 0; i < count; ++i)
+    {
+        fputs(i ? ", " : " ", out);
+        print_double(out, values[i]);
+    }
+    fputs(" };\n", out);
+    try {
+        api->insert_data_array(count, codes, values);
+    } catch (std::exception& e) {
+        fprintf(out, "    wassert_throws(std::exception, %s.insert_data_array(%u, codes, values)); // %s\n", name.c_str(), count, e.what());
+        fputs("}\n", out);
+        throw;
+    }
+    fprintf(out, "    wassert(%s.insert_data_array(%u, codes, values));\n", name.c_str(), count);
+    fputs("}\n", out);
+}
+
+unsigned TracedAPI::next_data_array(unsigned max, wreport::Varcode* codes, double* values)
+{
+    FILE*& out = tracer.trace_file;
+    fputs("{\n", out);
+    fprintf(out, "    wreport::Varcode codes[%u];\n", max);
+    fprintf(out, "    double values[%u];\n", max);
+    unsigned count;
+    try {
+        count = api->next_data_array(max, codes, values);
+    } catch (std::exception& e) {
+        fprintf(out, "    wassert_throws(std::exception, %s.next_data_array(%u, codes, values)); // %s\n", name.c_str(), max, e.what());
+        fputs("}\n", out);
+        throw;
+    }
+    fprintf(out, "    wassert(actual(%s.next_data_array(%u, codes, values)) == %u);\n", name.c_str(), max, count);
+    for (unsigned i = 0; i < count; ++i)
+    {
+        fprintf(out, "    wassert(actual(codes[%u]) == ", i);
+        print_varcode(out, codes[i]);
+        fprintf(out, ");\n    wassert(actual(values[%u]) == ", i);
+        print_double(out, values[i]);
+        fputs(");\n", out);
+    }
+    fputs("}\n", out);
+    return count;
+}
+
 void TracedAPI::remove_data()
 {
     RUN(remove_data);
@@ -63,6 +63,8 @@ struct TracedAPI : public API
     int query_data() override;
     wreport::Varcode next_data() override;
     void insert_data() override;
+    void insert_data_array(unsigned count, const wreport::Varcode* codes, const double* values) override;
+    unsigned next_data_array(unsigned max, wreport::Varcode* codes, double* values) override;
     void remove_data() override;
     int query_attributes() override;
     const char* next_attribute() override;
@@ -1,4 +1,5 @@
 #include "core/tests.h"
+#include "msg/tests.h"
 #include "msg/msg.h"
 #include "importer.h"
 
@@ -27,6 +28,96 @@ add_method("options", []() {
     wassert(actual(impl::ImporterOptions("") == simplified).istrue());
     wassert(actual(impl::ImporterOptions("simplified") == simplified).istrue());
     wassert(actual(impl::ImporterOptions("accurate") == accurate).istrue());
+
+    impl::ImporterOptions threaded;
+    threaded.subset_threads = 4;
+    wassert(actual(threaded == simplified).isfalse());
+
+    impl::ImporterOptions projected;
+    projected.varcodes.push_back(WR_VAR(0, 12, 101));
+    wassert(actual(projected == simplified).isfalse());
+    projected.varcodes.clear();
+    projected.attributes = false;
+    wassert(actual(projected == simplified).isfalse());
+});
+
+add_method("subset_threads", []() {
+    // Interpreting subsets in parallel gives the same messages in the same order
+    impl::ImporterOptions threaded;
+    threaded.subset_threads = 4;
+    for (const char* fname: { "bufr/ed4-compr-string.bufr", "bufr/gts-acars2.bufr", "bufr/temp-gts1.bufr" })
+    {
+        impl::Messages msgs1 = read_msgs(fname, Encoding::BUFR);
+        impl::Messages msgs2 = read_msgs(fname, Encoding::BUFR, threaded);
+        wassert(actual(msgs2.size()) == msgs1.size());
+        wassert(actual(impl::msg::messages_diff(msgs1, msgs2)) == 0u);
+    }
+});
+
+add_method("projection", []() {
+    impl::ImporterOptions opts;
+    opts.varcodes = { WR_VAR(0, 12, 101), WR_VAR(0, 10, 4) };
+    opts.attributes = false;
+
+    for (const char* fname: { "bufr/synop-gtscosmo.bufr", "bufr/temp-gts1.bufr", "bufr/gts-acars2.bufr", "bufr/obs0-1.22.bufr" })
+    {
+        WREPORT_TEST_INFO(info);
+        info() << fname;
+
+        impl::Messages full = read_msgs(fname, Encoding::BUFR);
+        impl::Messages projected = read_msgs(fname, Encoding::BUFR, opts);
+        wassert(actual(projected.size()) == full.size());
+
+        for (unsigned i = 0; i < full.size(); ++i)
+        {
+            const impl::Message& f = impl::Message::downcast(*full[i]);
+            const impl::Message& p = impl::Message::downcast(*projected[i]);
+
+            // Station information is always imported
+            wassert(actual(p.station_data.size()) == f.station_data.size());
+            for (const auto& val: p.station_data)
+                wassert_false(val->next_attr());
+
+            // Only the selected values are imported, unchanged
+            unsigned selected = 0;
+            for (const auto& ctx: f.data)
+                for (const auto& val: ctx.values)
+                    if (val->code() == WR_VAR(0, 12, 101) || val->code() == WR_VAR(0, 10, 4))
+                    {
+                        const Var* var = p.get(ctx.level, ctx.trange, val->code());
+                        wassert_true(var);
+                        wassert_true(var->value_equals(*val));
+                        ++selected;
+                    }
+
+            unsigned imported = 0;
+            for (const auto& ctx: p.data)
+            {
+                wassert_false(ctx.values.empty());
+                for (const auto& val: ctx.values)
+                {
+                    wassert_false(val->next_attr());
+                    ++imported;
+                }
+            }
+            wassert(actual(imported) == selected);
+        }
+    }
+
+    // Select by level and time range
+    impl::ImporterOptions lt;
+    lt.levels.push_back(Level(103, 2000));
+    lt.tranges.push_back(Trange::instant());
+    impl::Messages projected = read_msgs("bufr/synop-gtscosmo.bufr", Encoding::BUFR, lt);
+    unsigned found = 0;
+    for (const auto& msg: projected)
+        for (const auto& ctx: impl::Message::downcast(*msg).data)
+        {
+            wassert(actual(ctx.level) == Level(103, 2000));
+            wassert(actual(ctx.trange) == Trange::instant());
+            ++found;
+        }
+    wassert(actual(found) > 0u);
 });
 
 }
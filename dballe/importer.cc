@@ -4,6 +4,7 @@
 #include "dballe/msg/json_codec.h"
 #include <wreport/error.h>
 #include <wreport/bulletin.h>
+#include <tuple>
 
 #include "config.h"
 
@@ -21,12 +22,14 @@ ImporterOptions::ImporterOptions(const std::string& s)
 
 bool ImporterOptions::operator==(const ImporterOptions& o) const
 {
-    return simplified == o.simplified;
+    return std::tie(simplified, subset_threads, varcodes, levels, tranges, attributes)
+        == std::tie(o.simplified, o.subset_threads, o.varcodes, o.levels, o.tranges, o.attributes);
 }
 
 bool ImporterOptions::operator!=(const ImporterOptions& o) const
 {
-    return simplified != o.simplified;
+    return std::tie(simplified, subset_threads, varcodes, levels, tranges, attributes)
+        != std::tie(o.simplified, o.subset_threads, o.varcodes, o.levels, o.tranges, o.attributes);
 }
 
 void ImporterOptions::print(FILE* out)
@@ -2,6 +2,7 @@
 #define DBALLE_IMPORTER_H
 
 #include <dballe/fwd.h>
+#include <dballe/types.h>
 #include <vector>
 #include <memory>
 #include <string>
@@ -26,6 +27,32 @@ class ImporterOptions
 public:
     bool simplified = true;
 
+    /**
+     * Number of threads used to interpret the subsets of multi-subset BUFR
+     * and CREX bulletins.
+     *
+     * With 0 or 1, subsets are interpreted sequentially in the calling
+     * thread. Messages are always passed to the caller in subset order.
+     */
+    unsigned subset_threads = 1;
+
+    /**
+     * If not empty, only import data values with these varcodes.
+     *
+     * Values are selected after interpretation, so the varcodes are the
+     * DB-All.e ones. Station information is always imported.
+     */
+    std::vector<wreport::Varcode> varcodes;
+
+    /// If not empty, only import data values with these levels
+    std::vector<Level> levels;
+
+    /// If not empty, only import data values with these time ranges
+    std::vector<Trange> tranges;
+
+    /// If false, do not import the attributes of variables
+    bool attributes = true;
+
     bool operator==(const ImporterOptions&) const;
     bool operator!=(const ImporterOptions&) const;
 
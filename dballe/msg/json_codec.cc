@@ -130,7 +130,15 @@ struct JSONMsgReader : public core::JSONReader
             switch (s) {
                 case MSG_DATA_LIST:
                     state.push(MSG_DATA_LIST_ITEM);
-                    ctx.reset(new impl::msg::Context(Level(), Trange()));
+                    // Reuse the same scratch context for all data items
+                    if (!ctx)
+                        ctx.reset(new impl::msg::Context(Level(), Trange()));
+                    else
+                    {
+                        ctx->level = Level();
+                        ctx->trange = Trange();
+                        ctx->values.clear();
+                    }
                     break;
                 case MSG_DATA_LIST_ITEM_VARS_MAPPING_VAR:
                     state.pop();
@@ -168,10 +176,10 @@ struct JSONMsgReader : public core::JSONReader
                 // msg.add_context(std::move(ctx));
                 if (ctx->level.is_missing() && ctx->trange.is_missing())
                 {
-                    msg->station_data.merge(ctx->values);
+                    msg->station_data.merge(std::move(ctx->values));
                 } else {
                     impl::msg::Context& ctx2 = msg->obtain_context(ctx->level, ctx->trange);
-                    ctx2.values.merge(ctx->values);
+                    ctx2.values.merge(std::move(ctx->values));
                 }
                 state.pop();
                 break;
@@ -79,6 +79,36 @@ add_method("ordering", []() {
     wassert(actual(msg.get(lev1, Trange(3, 3, 3), WR_VAR(0, 1, 1))) == (Var*)0);
 });
 
+add_method("build", []() {
+    // Test appending contexts unsorted and sorting them at the end
+    impl::Message msg;
+    Level lev1(1, 1, 1, 1);
+    Level lev2(2, 2, 2, 2);
+    Level lev3(3, 3, 3, 3);
+    Trange tr(1, 1, 1);
+
+    msg.data.begin_build();
+    wassert_true(msg.data.building());
+    msg.set(lev3, tr, newvar(WR_VAR(0, 1, 1), 1));
+    msg.set(lev3, tr, newvar(WR_VAR(0, 1, 2), 1));
+    msg.set(lev1, tr, newvar(WR_VAR(0, 1, 1), 2));
+    msg.set(lev3, tr, newvar(WR_VAR(0, 1, 1), 3));
+    msg.set(lev2, tr, newvar(WR_VAR(0, 1, 1), 4));
+    // lev3 is appended twice
+    wassert(actual(msg.data.size()) == 4);
+    // Lookups see the most recent value
+    wassert(actual(msg.get(lev3, tr, WR_VAR(0, 1, 1))->enqi()) == 3);
+    msg.data.finish_build();
+    wassert_false(msg.data.building());
+
+    wassert(actual(msg.data.size()) == 3);
+    wassert(msg_is_sorted(msg));
+    wassert(actual(msg.get(lev1, tr, WR_VAR(0, 1, 1))->enqi()) == 2);
+    wassert(actual(msg.get(lev2, tr, WR_VAR(0, 1, 1))->enqi()) == 4);
+    wassert(actual(msg.get(lev3, tr, WR_VAR(0, 1, 1))->enqi()) == 3);
+    wassert(actual(msg.get(lev3, tr, WR_VAR(0, 1, 2))->enqi()) == 1);
+});
+
 add_method("compose", []() {
     // Try to write a generic message from scratch
     auto msg = make_shared<impl::Message>();
@@ -601,6 +631,42 @@ add_method("msgs_csv", []() {
     wassert(actual(msg::messages_diff(msgs, msgs1)) == 0u);
 });
 
+add_method("msgs_csv_stream", []() {
+    // Test reading CSV one message at a time
+    impl::Messages msgs;
+    for (int hour = 0; hour < 3; ++hour)
+    {
+        auto msg = impl::Message::downcast(read_msgs("bufr/synop-evapo.bufr", Encoding::BUFR)[0]);
+        wassert(msg->set_rep_memo("synop"));
+        wassert(msg->set_datetime(Datetime(2020, 1, 1, hour)));
+        msgs.push_back(msg);
+    }
+
+    MemoryCSVWriter csv;
+    wassert(msg::messages_to_csv(msgs, csv));
+
+    csv.buf.seekg(0);
+    CSVReader in(csv.buf);
+    unsigned count = 0;
+    wassert_true(msg::messages_from_csv(in, [&](std::unique_ptr<impl::Message>&& msg) {
+        notes::Collect c(cerr);
+        wassert(actual(msgs[count]->diff(*msg)) == 0u);
+        ++count;
+        return true;
+    }));
+    wassert(actual(count) == 3u);
+
+    // Reading can be stopped early
+    csv.buf.clear();
+    csv.buf.seekg(0);
+    CSVReader in1(csv.buf);
+    count = 0;
+    wassert_false(msg::messages_from_csv(in1, [&](std::unique_ptr<impl::Message>&& msg) {
+        return ++count < 2;
+    }));
+    wassert(actual(count) == 2u);
+});
+
 add_method("msgs_copy", []() {
     Messages msgs = read_msgs("bufr/synop-evapo.bufr", Encoding::BUFR);
     Messages msgs1(msgs);
@@ -10,6 +10,7 @@
 #include <cstdlib>
 #include <cstring>
 #include <cctype>
+#include <algorithm>
 #include <sstream>
 #include <iomanip>
 #include <iostream>
@@ -24,6 +25,15 @@ namespace msg {
 
 Contexts::const_iterator Contexts::find(const Level& level, const Trange& trange) const
 {
+    if (m_building)
+    {
+        // Linear search from the end, to find the most recently added match
+        for (auto i = m_contexts.rbegin(); i != m_contexts.rend(); ++i)
+            if (i->compare(level, trange) == 0)
+                return (i + 1).base();
+        return m_contexts.end();
+    }
+
     /* Binary search */
     if (m_contexts.empty())
         return m_contexts.end();
@@ -45,6 +55,15 @@ Contexts::const_iterator Contexts::find(const Level& level, const Trange& trange
 
 Contexts::iterator Contexts::find(const Level& level, const Trange& trange)
 {
+    if (m_building)
+    {
+        // Linear search from the end, to find the most recently added match
+        for (auto i = m_contexts.rbegin(); i != m_contexts.rend(); ++i)
+            if (i->compare(level, trange) == 0)
+                return (i + 1).base();
+        return m_contexts.end();
+    }
+
     /* Binary search */
     if (m_contexts.empty())
         return m_contexts.end();
@@ -66,23 +85,37 @@ Contexts::iterator Contexts::find(const Level& level, const Trange& trange)
 
 Contexts::iterator Contexts::insert_new(const Level& level, const Trange& trange)
 {
-    // Enlarge the buffer
-    m_contexts.emplace_back(level, trange);
+    if (m_building)
+    {
+        m_contexts.emplace_back(level, trange);
+        return m_contexts.end() - 1;
+    }
 
-    // Insertionsort
-    iterator pos;
-    for (pos = m_contexts.end() - 1; pos > m_contexts.begin(); --pos)
+    // Binary search for the insertion point, then let the vector shift the
+    // following contexts in place
+    iterator low = m_contexts.begin(), high = m_contexts.end();
+    while (low < high)
     {
-        if ((pos - 1)->compare(*pos) > 0)
-            std::swap(*pos, *(pos - 1));
+        iterator middle = low + (high - low) / 2;
+        if (middle->compare(level, trange) < 0)
+            low = middle + 1;
         else
-            break;
+            high = middle;
     }
-    return pos;
+    return m_contexts.emplace(low, level, trange);
 }
 
 Contexts::iterator Contexts::obtain(const Level& level, const Trange& trange)
 {
+    if (m_building)
+    {
+        // While building, only look at the last context: importers tend to
+        // set all the values of a level before moving on to the next
+        if (!m_contexts.empty() && m_contexts.back().compare(level, trange) == 0)
+            return m_contexts.end() - 1;
+        return insert_new(level, trange);
+    }
+
     iterator pos = find(level, trange);
     if (pos != end())
         return pos;
@@ -91,6 +124,7 @@ Contexts::iterator Contexts::obtain(const Level& level, const Trange& trange)
 
 bool Contexts::drop(const Level& level, const Trange& trange)
 {
+    finish_build();
     iterator pos = find(level, trange);
     if (pos == end())
         return false;
@@ -98,6 +132,38 @@ bool Contexts::drop(const Level& level, const Trange& trange)
     return true;
 }
 
+void Contexts::begin_build()
+{
+    m_building = true;
+}
+
+void Contexts::finish_build()
+{
+    if (!m_building)
+        return;
+    m_building = false;
+
+    if (m_contexts.size() < 2)
+        return;
+
+    // Stable sort, so that duplicate contexts stay in insertion order
+    std::stable_sort(m_contexts.begin(), m_contexts.end(), [](const msg::Context& a, const msg::Context& b) {
+        return a.compare(b) < 0;
+    });
+
+    // Merge duplicate contexts into the first of each group, letting values
+    // set later replace values set earlier
+    iterator dst = m_contexts.begin();
+    for (iterator src = dst + 1; src != m_contexts.end(); ++src)
+    {
+        if (dst->compare(*src) == 0)
+            dst->values.merge(std::move(src->values));
+        else if (++dst != src)
+            *dst = std::move(*src);
+    }
+    m_contexts.erase(dst + 1, m_contexts.end());
+}
+
 
 Messages messages_from_csv(CSVReader& in)
 {
@@ -130,6 +196,18 @@ Messages messages_from_csv(CSVReader& in)
     return res;
 }
 
+bool messages_from_csv(CSVReader& in, std::function<bool(std::unique_ptr<Message>&&)> dest)
+{
+    while (true)
+    {
+        std::unique_ptr<Message> msg(new Message);
+        if (!msg->from_csv(in))
+            return true;
+        if (!dest(std::move(msg)))
+            return false;
+    }
+}
+
 void messages_to_csv(const Messages& msgs, CSVWriter& out)
 {
     for (const auto& i: msgs)
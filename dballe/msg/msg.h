@@ -13,6 +13,7 @@
 #include <stdio.h>
 #include <vector>
 #include <memory>
+#include <functional>
 #include <iosfwd>
 
 namespace dballe {
@@ -58,6 +59,18 @@ namespace msg {
  */
 Messages messages_from_csv(CSVReader& in);
 
+/**
+ * Read all the messages from a CSV input, passing each one to \a dest as soon
+ * as it has been read.
+ *
+ * Only one message at a time is kept in memory. Reading stops at the end of
+ * the input, or when \a dest returns false.
+ *
+ * @return false if \a dest returned false, true if the end of the input has
+ * been reached
+ */
+bool messages_from_csv(CSVReader& in, std::function<bool(std::unique_ptr<Message>&&)> dest);
+
 /**
  * Output in CSV format
  */
@@ -89,6 +102,9 @@ public:
 protected:
     std::vector<msg::Context> m_contexts;
 
+    /// True if contexts are being appended unsorted, see begin_build()
+    bool m_building = false;
+
     iterator insert_new(const Level& level, const Trange& trange);
 
 public:
@@ -113,9 +129,33 @@ public:
     iterator obtain(const Level& level, const Trange& trange);
     bool drop(const Level& level, const Trange& trange);
 
+    /**
+     * Start building the contexts in append mode.
+     *
+     * Until finish_build() is called, obtain() only looks at the last context
+     * and appends a new one if it does not match, without keeping the
+     * contexts sorted. This avoids quadratic insertion costs when importing
+     * long vertical soundings.
+     *
+     * While building, find() does a linear search and iteration happens in
+     * insertion order.
+     */
+    void begin_build();
+
+    /**
+     * Sort the contexts appended since begin_build() and merge the duplicate
+     * ones, with values set later replacing values set earlier.
+     *
+     * Does nothing if begin_build() has not been called.
+     */
+    void finish_build();
+
+    /// Check if the contexts are in append mode
+    bool building() const { return m_building; }
+
     size_t size() const { return m_contexts.size(); }
     bool empty() const { return m_contexts.empty(); }
-    void clear() { return m_contexts.clear(); }
+    void clear() { m_building = false; return m_contexts.clear(); }
     void reserve(typename std::vector<Value>::size_type size) { m_contexts.reserve(size); }
     iterator erase(iterator pos) { return m_contexts.erase(pos); }
     // iterator erase(const_iterator pos) { return m_contexts.erase(pos); }
@@ -4,8 +4,10 @@
 #include "context.h"
 #include "dballe/core/shortcuts.h"
 #include "wr_importers/base.h"
+#include "dballe/core/workers.h"
 #include <wreport/bulletin.h>
 #include <wreport/vartable.h>
+#include <algorithm>
 
 using namespace wreport;
 using namespace std;
@@ -14,6 +16,12 @@ namespace dballe {
 namespace impl {
 namespace msg {
 
+std::mutex& wreport_tables_mutex()
+{
+    static std::mutex mutex;
+    return mutex;
+}
+
 WRImporter::WRImporter(const dballe::ImporterOptions& opts)
     : BulletinImporter(opts) {}
 
@@ -23,7 +31,12 @@ BufrImporter::~BufrImporter() {}
 
 bool BufrImporter::foreach_decoded(const BinaryMessage& msg, std::function<bool(std::unique_ptr<dballe::Message>)> dest) const
 {
-    unique_ptr<BufrBulletin> bulletin(BufrBulletin::decode(msg.data));
+    unique_ptr<BufrBulletin> bulletin;
+    {
+        // Decoding looks up and loads tables in the wreport caches
+        std::lock_guard<std::mutex> lock(wreport_tables_mutex());
+        bulletin = BufrBulletin::decode(msg.data);
+    }
     return foreach_decoded_bulletin(*bulletin, dest);
 }
 
@@ -33,7 +46,12 @@ CrexImporter::~CrexImporter() {}
 
 bool CrexImporter::foreach_decoded(const BinaryMessage& msg, std::function<bool(std::unique_ptr<dballe::Message>)> dest) const
 {
-    unique_ptr<CrexBulletin> bulletin(CrexBulletin::decode(msg.data));
+    unique_ptr<CrexBulletin> bulletin;
+    {
+        // Decoding looks up and loads tables in the wreport caches
+        std::lock_guard<std::mutex> lock(wreport_tables_mutex());
+        bulletin = CrexBulletin::decode(msg.data);
+    }
     return foreach_decoded_bulletin(*bulletin, dest);
 }
 
@@ -44,62 +62,109 @@ Messages WRImporter::from_bulletin(const wreport::Bulletin& msg) const
     return res;
 }
 
-bool WRImporter::foreach_decoded_bulletin(const wreport::Bulletin& msg, std::function<bool(std::unique_ptr<dballe::Message>)> dest) const
+namespace {
+
+// Infer the right importer. See Common Code Table C-13
+std::unique_ptr<wr::Importer> create_importer(const wreport::Bulletin& msg, const dballe::ImporterOptions& opts)
 {
-    // Infer the right importer. See Common Code Table C-13
-    std::unique_ptr<wr::Importer> importer;
     switch (msg.data_category)
     {
         // Surface data - land
         case 0:
-            switch (msg.data_subcategory)
-            {
-                // Routine aeronautical observations (METAR)
-                case 10:
-                    importer = wr::Importer::createMetar(opts);
-                    break;
-                default:
-                    // Old ECMWF METAR type
-                    if (msg.data_subcategory_local == 140)
-                        importer = wr::Importer::createMetar(opts);
-                    else
-                        importer = wr::Importer::createSynop(opts);
-                    break;
-            }
-            break;
+            // Routine aeronautical observations (METAR)
+            if (msg.data_subcategory == 10)
+                return wr::Importer::createMetar(opts);
+            // Old ECMWF METAR type
+            if (msg.data_subcategory_local == 140)
+                return wr::Importer::createMetar(opts);
+            return wr::Importer::createSynop(opts);
         // Surface data - sea
-        case 1: importer = wr::Importer::createShip(opts); break;
+        case 1: return wr::Importer::createShip(opts);
         // Vertical soundings (other than satellite)
-        case 2: importer = wr::Importer::createTemp(opts); break;
+        case 2: return wr::Importer::createTemp(opts);
         // Vertical soundings (satellite)
-        case 3: importer = wr::Importer::createSat(opts); break;
+        case 3: return wr::Importer::createSat(opts);
         // Single level upper-air data (other than satellite)
-        case 4: importer = wr::Importer::createFlight(opts); break;
+        case 4: return wr::Importer::createFlight(opts);
         // Radar data
         case 6:
+            // Doppler wind profiles
             if (msg.data_subcategory == 1)
-                // Doppler wind profiles
-                importer = wr::Importer::createTemp(opts);
-            else
-                importer = wr::Importer::createGeneric(opts);
-            break;
+                return wr::Importer::createTemp(opts);
+            return wr::Importer::createGeneric(opts);
         // Physical/chemical constituents
-        case 8: importer = wr::Importer::createPollution(opts); break;
-        default: importer = wr::Importer::createGeneric(opts); break;
+        case 8: return wr::Importer::createPollution(opts);
+        default: return wr::Importer::createGeneric(opts);
     }
+}
+
+}
+
+bool WRImporter::foreach_decoded_bulletin(const wreport::Bulletin& msg, std::function<bool(std::unique_ptr<dballe::Message>)> dest) const
+{
+    if (opts.subset_threads > 1 && msg.subsets.size() > 1)
+        return foreach_decoded_bulletin_parallel(msg, dest);
+
+    std::unique_ptr<wr::Importer> importer = create_importer(msg, opts);
 
     MessageType type = importer->scanType(msg);
+    // Subsets of the same bulletin tend to have the same shape: use the size
+    // of the last interpreted message to presize the storage of the next one,
+    // to avoid regrowing and moving the contexts while importing
+    size_t station_hint = 0;
+    size_t contexts_hint = 0;
     for (unsigned i = 0; i < msg.subsets.size(); ++i)
     {
         std::unique_ptr<Message> newmsg(new Message);
         newmsg->type = type;
+        newmsg->station_data.reserve(station_hint);
+        newmsg->data.reserve(contexts_hint);
         importer->import(msg.subsets[i], *newmsg);
+        station_hint = newmsg->station_data.size();
+        contexts_hint = newmsg->data.size();
         if (!dest(move(newmsg)))
             return false;
     }
     return true;
 }
 
+bool WRImporter::foreach_decoded_bulletin_parallel(const wreport::Bulletin& msg, std::function<bool(std::unique_ptr<dballe::Message>)> dest) const
+{
+    unsigned nthreads = std::min((size_t)opts.subset_threads, msg.subsets.size());
+
+    // wr::Importer keeps state while importing: each worker gets its own
+    std::vector<std::unique_ptr<wr::Importer>> importers;
+    importers.reserve(nthreads);
+    for (unsigned i = 0; i < nthreads; ++i)
+        importers.emplace_back(create_importer(msg, opts));
+
+    MessageType type = importers[0]->scanType(msg);
+
+    // Make sure that the DB-All.e variable table is loaded before the
+    // workers start using it
+    varinfo(WR_VAR(0, 1, 1));
+
+    core::OrderedWorkers<unsigned, std::unique_ptr<Message>> workers(nthreads, 0,
+        [&](unsigned worker, unsigned& idx) {
+            std::unique_ptr<Message> newmsg(new Message);
+            newmsg->type = type;
+            importers[worker]->import(msg.subsets[idx], *newmsg);
+            return newmsg;
+        });
+
+    for (unsigned i = 0; i < msg.subsets.size(); ++i)
+    {
+        if (workers.full())
+            if (!dest(workers.pop()))
+                return false;
+        workers.submit(i);
+    }
+    while (!workers.empty())
+        if (!dest(workers.pop()))
+            return false;
+    return true;
+}
+
 
 WRExporter::WRExporter(const dballe::ExporterOptions& opts)
     : BulletinExporter(opts) {}
@@ -159,6 +224,12 @@ unique_ptr<wr::Template> WRExporter::infer_template(const Messages& msgs) const
     return fac.factory(opts, msgs);
 }
 
+std::string WRExporter::template_name(const std::shared_ptr<dballe::Message>& msg) const
+{
+    Messages msgs { msg };
+    return infer_template(msgs)->name();
+}
+
 unique_ptr<Bulletin> WRExporter::to_bulletin(const Messages& msgs) const
 {
     std::unique_ptr<wr::Template> encoder = infer_template(msgs);
@@ -179,12 +250,11 @@ extern void register_flight(TemplateRegistry&);
 extern void register_generic(TemplateRegistry&);
 extern void register_pollution(TemplateRegistry&);
 
-static TemplateRegistry* registry = NULL;
 const TemplateRegistry& TemplateRegistry::get()
 {
-    if (!registry)
-    {
-        registry = new TemplateRegistry;
+    // Initialized only once, also when first called by multiple threads
+    static TemplateRegistry* registry = [] {
+        TemplateRegistry* registry = new TemplateRegistry;
 
         registry->register_factory(MISSING_INT, "wmo", "WMO style templates (autodetect)",
                 [](const dballe::ExporterOptions& opts, const Messages& msgs) {
@@ -218,7 +288,8 @@ const TemplateRegistry& TemplateRegistry::get()
         // registry->insert("wmo-synop-high", ...)
         // registry->insert("ecmwf-synop", ...)
         // registry->insert("ecmwf-synop-high", ...)
-    }
+        return registry;
+    }();
     return *registry;
 }
 
@@ -240,15 +311,42 @@ void TemplateRegistry::register_factory(
     insert(make_pair(name, TemplateFactory(data_category, name, desc, fac)));
 }
 
+/// Check if all the subsets of a bulletin contain the same sequence of variables
+static bool subsets_have_same_structure(const wreport::Bulletin& bulletin)
+{
+    const Subset& first = bulletin.subsets[0];
+    for (unsigned i = 1; i < bulletin.subsets.size(); ++i)
+    {
+        const Subset& subset = bulletin.subsets[i];
+        if (subset.size() != first.size())
+            return false;
+        for (unsigned pos = 0; pos < subset.size(); ++pos)
+            if (subset[pos].code() != first[pos].code())
+                return false;
+    }
+    return true;
+}
+
 void Template::to_bulletin(wreport::Bulletin& bulletin)
 {
-    setupBulletin(bulletin);
+    {
+        // setupBulletin loads the wreport tables, and templates can be used
+        // by multiple threads
+        std::lock_guard<std::mutex> lock(wreport_tables_mutex());
+        setupBulletin(bulletin);
+    }
 
     for (unsigned i = 0; i < msgs.size(); ++i)
     {
         Subset& s = bulletin.obtain_subset(i);
         to_subset(Message::downcast(*msgs[i]), s);
     }
+
+    // Compressed BUFR can only encode subsets with the same expansion of the
+    // data descriptors
+    if (opts.compression && msgs.size() > 1)
+        if (BufrBulletin* b = dynamic_cast<BufrBulletin*>(&bulletin))
+            b->compression = subsets_have_same_structure(bulletin);
 }
 
 void Template::setupBulletin(wreport::Bulletin& bulletin)
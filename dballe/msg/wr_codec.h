@@ -10,6 +10,7 @@
 #include <map>
 #include <string>
 #include <functional>
+#include <mutex>
 
 namespace wreport {
 struct Bulletin;
@@ -20,6 +21,16 @@ namespace dballe {
 namespace impl {
 namespace msg {
 
+/**
+ * Lock serializing the loading of wreport tables.
+ *
+ * The wreport table cache is not thread safe: code that can load tables from
+ * multiple threads at the same time needs to hold this lock while doing it.
+ * BufrImporter and CrexImporter hold it while decoding bulletins, and
+ * Template::to_bulletin while loading the tables of a new bulletin.
+ */
+std::mutex& wreport_tables_mutex();
+
 class WRImporter : public BulletinImporter
 {
 public:
@@ -43,6 +54,13 @@ public:
      * @returns true if it got to the end of decoding, false if dest returned false.
      */
     bool foreach_decoded_bulletin(const wreport::Bulletin& msg, std::function<bool(std::unique_ptr<dballe::Message>)> dest) const;
+
+protected:
+    /**
+     * Implementation of foreach_decoded_bulletin that interprets subsets on
+     * ImporterOptions::subset_threads worker threads
+     */
+    bool foreach_decoded_bulletin_parallel(const wreport::Bulletin& msg, std::function<bool(std::unique_ptr<dballe::Message>)> dest) const;
 };
 
 class BufrImporter : public WRImporter
@@ -85,6 +103,14 @@ public:
      * Infer a template name from the message contents
      */
     std::unique_ptr<wr::Template> infer_template(const Messages& msgs) const;
+
+    /**
+     * Return the name of the template used to encode a bulletin whose first
+     * subset is \a msg.
+     *
+     * Messages can share a bulletin only if they use the same template.
+     */
+    std::string template_name(const std::shared_ptr<dballe::Message>& msg) const;
 };
 
 class BufrExporter : public WRExporter
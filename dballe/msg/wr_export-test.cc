@@ -167,6 +167,50 @@ class Tests : public TestCase
             }
         });
 
+        add_method("compression", []() {
+            impl::Messages synops = read_msgs("bufr/synop-gtscosmo.bufr", Encoding::BUFR);
+            wassert(actual(synops.size()) == 1u);
+            auto second = synops[0]->clone();
+            impl::Message::downcast(*second).station_data.set(WR_VAR(0, 5, 1), 45.0);
+            synops.emplace_back(move(second));
+
+            impl::ExporterOptions opts;
+            opts.compression = true;
+            auto exporter = get_exporter(Encoding::BUFR, opts);
+            auto plain_exporter = get_exporter(Encoding::BUFR);
+
+            // Subsets with the same structure are compressed
+            unique_ptr<Bulletin> bulletin = exporter->to_bulletin(synops);
+            wassert(actual(bulletin->subsets.size()) == 2u);
+            wassert_true(dynamic_cast<BufrBulletin*>(bulletin.get())->compression);
+
+            // Compression does not change the decoded data
+            auto importer = get_importer();
+            impl::Messages compressed = importer->from_binary(BinaryMessage(Encoding::BUFR, exporter->to_binary(synops)));
+            impl::Messages plain = importer->from_binary(BinaryMessage(Encoding::BUFR, plain_exporter->to_binary(synops)));
+            wassert(actual(compressed.size()) == 2u);
+            notes::Collect c(cerr);
+            wassert(actual(impl::msg::messages_diff(plain, compressed)) == 0);
+
+            // Soundings with a different number of levels cannot be compressed
+            impl::Messages temps = read_msgs("bufr/temp-gtscosmo.bufr", Encoding::BUFR);
+            wassert(actual(temps.size()) == 1u);
+            auto shorter = temps[0]->clone();
+            impl::Message& m = impl::Message::downcast(*shorter);
+            for (const auto& ctx: m.data)
+                if (ctx.level.ltype1 == 100)
+                {
+                    Level lev = ctx.level;
+                    Trange tr = ctx.trange;
+                    wassert_true(m.remove_context(lev, tr));
+                    break;
+                }
+            temps.emplace_back(move(shorter));
+            bulletin = exporter->to_bulletin(temps);
+            wassert(actual(bulletin->subsets.size()) == 2u);
+            wassert_false(dynamic_cast<BufrBulletin*>(bulletin.get())->compression);
+        });
+
         // Re-export tests for old style synops
         add_testcodec("obs0-1.22.bufr", [](TestCodec& test) {
             test.expected_min_vars = 34;
@@ -25,6 +25,13 @@ static const Trange tr_std_past_wtr6(205, 0, 21600);
 static const Level lev_std_wind(103, 10*1000);
 static const Trange tr_std_wind_max10m(205, 0, 600);
 
+Importer::Importer(const dballe::ImporterOptions& opts)
+    : opts(opts), varcodes(opts.varcodes),
+      projecting(!opts.varcodes.empty() || !opts.levels.empty() || !opts.tranges.empty())
+{
+    std::sort(varcodes.begin(), varcodes.end());
+}
+
 void Importer::init()
 {
 }
@@ -35,46 +42,159 @@ void Importer::import(const wreport::Subset& subset, Message& msg)
     this->msg = &msg;
     init();
     run();
+    if (projecting || !opts.attributes)
+        project();
+}
+
+bool Importer::wanted(wreport::Varcode code, const Level& level, const Trange& trange) const
+{
+    if (!projecting)
+        return true;
+    if (level.is_missing() && trange.is_missing())
+        return true;
+    if (!varcodes.empty() && !std::binary_search(varcodes.begin(), varcodes.end(), code))
+        return false;
+    if (!opts.levels.empty() && std::find(opts.levels.begin(), opts.levels.end(), level) == opts.levels.end())
+        return false;
+    if (!opts.tranges.empty() && std::find(opts.tranges.begin(), opts.tranges.end(), trange) == opts.tranges.end())
+        return false;
+    return true;
+}
+
+void Importer::project()
+{
+    if (!opts.attributes)
+        for (auto& val: msg->station_data)
+            val->clear_attrs();
+
+    std::vector<wreport::Varcode> unwanted;
+    for (auto ctx = msg->data.begin(); ctx != msg->data.end(); )
+    {
+        unwanted.clear();
+        for (auto& val: ctx->values)
+        {
+            if (!wanted(val->code(), ctx->level, ctx->trange))
+                unwanted.push_back(val->code());
+            else if (!opts.attributes)
+                val->clear_attrs();
+        }
+        for (auto code: unwanted)
+            ctx->values.unset(code);
+
+        if (ctx->values.empty())
+            ctx = msg->data.erase(ctx);
+        else
+            ++ctx;
+    }
 }
 
 void Importer::set(const wreport::Var& var, const Shortcut& shortcut)
 {
-    msg->set(shortcut, var);
+    if (!shortcut.station_data && !wanted(shortcut.code, shortcut.level, shortcut.trange))
+        return;
+    if (opts.attributes)
+        msg->set(shortcut, var);
+    else
+    {
+        // Copy only the value, without allocating the attributes
+        auto copy = newvar(shortcut.code);
+        copy->setval(var);
+        if (shortcut.station_data)
+            msg->station_data.set(std::move(copy));
+        else
+            msg->set(shortcut.level, shortcut.trange, std::move(copy));
+    }
 }
 
 void Importer::set(const wreport::Var& var, wreport::Varcode code, const Level& level, const Trange& trange)
 {
-    msg->set(level, trange, code, var);
+    if (!wanted(code, level, trange))
+        return;
+    if (opts.attributes)
+        msg->set(level, trange, code, var);
+    else
+    {
+        auto copy = newvar(code);
+        copy->setval(var);
+        msg->set(level, trange, std::move(copy));
+    }
 }
 
 std::unique_ptr<Importer> Importer::createSat(const dballe::ImporterOptions&) { throw error_unimplemented("WB sat Importers"); }
 
+namespace {
+
+/// General bulletin metadata, stored by WMOImporter::import_var
+const VarDispatch<const Shortcut*> wmo_vars {
+    { WR_VAR(0,  1,  1), &sc::block },
+    { WR_VAR(0,  1,  2), &sc::station },
+    { WR_VAR(0,  1,  5), &sc::ident },
+    { WR_VAR(0,  1,  6), &sc::ident },
+    { WR_VAR(0,  1, 11), &sc::ident },
+    { WR_VAR(0,  1, 12), &sc::st_dir },
+    { WR_VAR(0,  1, 13), &sc::st_speed },
+    { WR_VAR(0,  1, 63), &sc::st_name_icao },
+    { WR_VAR(0,  2,  1), &sc::st_type },
+    { WR_VAR(0,  1, 15), &sc::st_name },
+    { WR_VAR(0,  4,  1), &sc::year },
+    { WR_VAR(0,  4,  2), &sc::month },
+    { WR_VAR(0,  4,  3), &sc::day },
+    { WR_VAR(0,  4,  4), &sc::hour },
+    { WR_VAR(0,  4,  5), &sc::minute },
+    { WR_VAR(0,  4,  6), &sc::second },
+    { WR_VAR(0,  5,  1), &sc::latitude },
+    { WR_VAR(0,  5,  2), &sc::latitude },
+    { WR_VAR(0,  6,  1), &sc::longitude },
+    { WR_VAR(0,  6,  2), &sc::longitude },
+};
+
+}
+
 void WMOImporter::import_var(const Var& var)
 {
-    switch (var.code())
-    {
-        // General bulletin metadata
-        case WR_VAR(0,  1,  1): set(var, sc::block); break;
-        case WR_VAR(0,  1,  2): set(var, sc::station); break;
-        case WR_VAR(0,  1,  5):
-        case WR_VAR(0,  1,  6):
-        case WR_VAR(0,  1, 11): set(var, sc::ident); break;
-        case WR_VAR(0,  1, 12): set(var, sc::st_dir); break;
-        case WR_VAR(0,  1, 13): set(var, sc::st_speed); break;
-        case WR_VAR(0,  1, 63): set(var, sc::st_name_icao); break;
-        case WR_VAR(0,  2,  1): set(var, sc::st_type); break;
-        case WR_VAR(0,  1, 15): set(var, sc::st_name); break;
-        case WR_VAR(0,  4,  1): set(var, sc::year); break;
-        case WR_VAR(0,  4,  2): set(var, sc::month); break;
-        case WR_VAR(0,  4,  3): set(var, sc::day); break;
-        case WR_VAR(0,  4,  4): set(var, sc::hour); break;
-        case WR_VAR(0,  4,  5): set(var, sc::minute); break;
-        case WR_VAR(0,  4,  6): set(var, sc::second); break;
-        case WR_VAR(0,  5,  1):
-        case WR_VAR(0,  5,  2): set(var, sc::latitude); break;
-        case WR_VAR(0,  6,  1):
-        case WR_VAR(0,  6,  2): set(var, sc::longitude); break;
-    }
+    if (const Shortcut* shortcut = wmo_vars.get(var.code()))
+        set(var, *shortcut);
+}
+
+namespace {
+
+/// Context information carried by a variable, collected by the peek_var methods
+enum class ContextAction : uint8_t
+{
+    NONE,
+    // LevelContext
+    PRESS_STD,
+    HEIGHT_BARO,
+    HEIGHT_SENSOR,
+    GROUND_DEPTH,
+    SEA_DEPTH,
+    SWELL_WAVE_GROUP,
+    // TimerangeContext
+    HOUR,
+    PERIOD_HOURS,
+    PERIOD_MINUTES,
+    TIME_SIG,
+    // CloudContext
+    VSS,
+    // UnsupportedContext
+    B08023,
+};
+
+const VarDispatch<ContextAction> context_vars {
+    { WR_VAR(0,  7,  4), ContextAction::PRESS_STD },
+    { WR_VAR(0,  7, 31), ContextAction::HEIGHT_BARO },
+    { WR_VAR(0,  7, 32), ContextAction::HEIGHT_SENSOR },
+    { WR_VAR(0,  7, 61), ContextAction::GROUND_DEPTH },
+    { WR_VAR(0,  7, 63), ContextAction::SEA_DEPTH },
+    { WR_VAR(0, 22,  3), ContextAction::SWELL_WAVE_GROUP },
+    { WR_VAR(0,  4,  4), ContextAction::HOUR },
+    { WR_VAR(0,  4, 24), ContextAction::PERIOD_HOURS },
+    { WR_VAR(0,  4, 25), ContextAction::PERIOD_MINUTES },
+    { WR_VAR(0,  8, 21), ContextAction::TIME_SIG },
+    { WR_VAR(0,  8,  2), ContextAction::VSS },
+    { WR_VAR(0,  8, 23), ContextAction::B08023 },
+};
+
 }
 
 void LevelContext::init()
@@ -90,29 +210,29 @@ void LevelContext::init()
 
 void LevelContext::peek_var(const wreport::Var& var)
 {
-    switch (var.code())
+    switch (context_vars.get(var.code()))
     {
-        case WR_VAR(0,  7,  4):
+        case ContextAction::PRESS_STD:
             // Remember the standard level pressure to use later as layer for geopotential
             press_std = var.enq(MISSING_PRESS_STD);
             break;
-        case WR_VAR(0,  7, 31):
+        case ContextAction::HEIGHT_BARO:
             // Remember the height to use later as layer for pressure
             height_baro = var.enq(MISSING_BARO);
             break;
-        case WR_VAR(0,  7, 32):
+        case ContextAction::HEIGHT_SENSOR:
             // Height to use later as level for whatever needs it
             height_sensor = missing;
             height_sensor = var.enq(missing);
             height_sensor_seen = true;
             break;
-        case WR_VAR(0,  7, 61): ground_depth = var.enq(missing); break;
-        case WR_VAR(0,  7, 63): sea_depth = var.enq(missing); break;
-        case WR_VAR(0, 22,  3): swell_wave_group=true; break;
+        case ContextAction::GROUND_DEPTH: ground_depth = var.enq(missing); break;
+        case ContextAction::SEA_DEPTH: sea_depth = var.enq(missing); break;
+        case ContextAction::SWELL_WAVE_GROUP: swell_wave_group=true; break;
+        default: break;
     }
 }
 
-
 void TimerangeContext::init()
 {
     time_period = MISSING_INT;
@@ -127,10 +247,10 @@ void TimerangeContext::peek_var(const Var& var, unsigned pos)
 {
     if (var.isset())
     {
-        switch (var.code())
+        switch (context_vars.get(var.code()))
         {
-            case WR_VAR(0,  4,  4): hour = var.enqi(); break;
-            case WR_VAR(0,  4, 24):
+            case ContextAction::HOUR: hour = var.enqi(); break;
+            case ContextAction::PERIOD_HOURS:
                 // Time period in hours
                 if ((int)pos == last_B04024_pos + 1)
                 {
@@ -149,13 +269,13 @@ void TimerangeContext::peek_var(const Var& var, unsigned pos)
                 }
                 last_B04024_pos = pos;
                 break;
-            case WR_VAR(0,  4, 25):
+            case ContextAction::PERIOD_MINUTES:
                 // Time period in minutes
                 time_period = var.enqd() * 60;
                 time_period_seen = true;
                 time_period_offset = 0;
                 break;
-            case WR_VAR(0,  8, 21):
+            case ContextAction::TIME_SIG:
                 // Time significance
                 time_sig = var.enqi();
                 // If we get time significance 18 "Radiosonde launch time"
@@ -166,27 +286,29 @@ void TimerangeContext::peek_var(const Var& var, unsigned pos)
                 if (hour == MISSING_INT and time_sig == 18)
                     time_sig = MISSING_TIME_SIG;
                 break;
+            default: break;
         }
     } else {
-        switch (var.code())
+        switch (context_vars.get(var.code()))
         {
-            case WR_VAR(0,  4,  4): hour = MISSING_INT; break;
-            case WR_VAR(0,  4, 24):
+            case ContextAction::HOUR: hour = MISSING_INT; break;
+            case ContextAction::PERIOD_HOURS:
                 // Time period in hours
                 time_period = MISSING_INT;
                 time_period_offset = 0;
                 time_period_seen = true;
                 break;
-            case WR_VAR(0,  4, 25):
+            case ContextAction::PERIOD_MINUTES:
                 // Time period in minutes
                 time_period = MISSING_INT;
                 time_period_offset = 0;
                 time_period_seen = true;
                 break;
-            case WR_VAR(0,  8, 21):
+            case ContextAction::TIME_SIG:
                 // Time significance
                 time_sig = MISSING_TIME_SIG;
                 break;
+            default: break;
         }
     }
 }
@@ -291,15 +413,12 @@ bool UnsupportedContext::is_unsupported() const
 
 void UnsupportedContext::peek_var(const wreport::Var& var, unsigned pos)
 {
-    switch (var.code())
-    {
-        case WR_VAR(0, 8, 23):
-            if (var.isset())
-                B08023 = &var;
-            else
-                B08023 = nullptr;
-            break;
-    }
+    if (context_vars.get(var.code()) != ContextAction::B08023)
+        return;
+    if (var.isset())
+        B08023 = &var;
+    else
+        B08023 = nullptr;
 }
 
 
@@ -476,6 +595,10 @@ void SynopBaseImporter::set(const wreport::Var& var, wreport::Varcode code, cons
 
 void SynopBaseImporter::set(std::unique_ptr<Interpreted> val)
 {
+    if (!wanted(val->var->code(), val->level, val->trange))
+        return;
+    if (!opts.attributes)
+        val->var->clear_attrs();
     if (opts.simplified)
         queued.push_back(val.release());
     else
@@ -509,7 +632,7 @@ void SynopBaseImporter::run()
     {
         const Var& var = (*subset)[pos];
         if (WR_VAR_F(var.code()) != 0) continue;
-        if (WR_VAR_X(var.code()) < 10 || var.code() == WR_VAR(0, 22, 3)) peek_var(var);
+        peek_var(var);
         if (var.isset()) import_var(var);
     }
 
@@ -532,124 +655,180 @@ void SynopBaseImporter::run()
 
 void SynopBaseImporter::peek_var(const Var& var)
 {
-    unsupported.peek_var(var, pos);
-    level.peek_var(var);
-
-    switch (var.code())
+    switch (context_vars.get(var.code()))
     {
-        case WR_VAR(0,  4,  4):
-        case WR_VAR(0,  4, 24):
-        case WR_VAR(0,  4, 25):
-        case WR_VAR(0,  8, 21): trange.peek_var(var, pos); break;
-        case WR_VAR(0,  8,  2): clouds.on_vss(*subset, pos); break;
+        case ContextAction::NONE: break;
+        case ContextAction::PRESS_STD:
+        case ContextAction::HEIGHT_BARO:
+        case ContextAction::HEIGHT_SENSOR:
+        case ContextAction::GROUND_DEPTH:
+        case ContextAction::SEA_DEPTH:
+        case ContextAction::SWELL_WAVE_GROUP: level.peek_var(var); break;
+        case ContextAction::HOUR:
+        case ContextAction::PERIOD_HOURS:
+        case ContextAction::PERIOD_MINUTES:
+        case ContextAction::TIME_SIG: trange.peek_var(var, pos); break;
+        case ContextAction::VSS: clouds.on_vss(*subset, pos); break;
+        case ContextAction::B08023: unsupported.peek_var(var, pos); break;
     }
 }
 
+namespace {
+
+/// How SynopBaseImporter::import_var interprets a variable
+enum class SynopAction : uint8_t
+{
+    /// Not a synop variable: try the general bulletin metadata
+    WMO,
+    SET,
+    GEN_SENSOR,
+    BARO_SENSOR,
+    PAST_WEATHER,
+    WIND,
+    WIND_MAX,
+    PRESSURE,
+    VSS,
+    CLOUD_GROUP,
+    CLOUD_TYPE,
+    PRECIPITATION,
+    TEMP_MAX,
+    TEMP_MIN,
+    GROUND_TEMP,
+};
+
+struct SynopVar
+{
+    SynopAction action;
+    const Shortcut* shortcut;
+
+    SynopVar(SynopAction action=SynopAction::WMO, const Shortcut* shortcut=nullptr)
+        : action(action), shortcut(shortcut) {}
+};
+
+const VarDispatch<SynopVar> synop_vars {
+    // Store original VS value as a measured value
+    { WR_VAR(0,  8,  2), SynopVar(SynopAction::VSS) },
+
+    // Ship identification, movement, date/time, horizontal and vertical
+    // coordinates
+    { WR_VAR(0,  7,  1), SynopVar(SynopAction::SET, &sc::height_station) },
+    { WR_VAR(0,  7, 30), SynopVar(SynopAction::SET, &sc::height_station) },
+    // Store also in the ana level, so that if the pressure later is missing
+    // we still have access to the value
+    { WR_VAR(0,  7, 31), SynopVar(SynopAction::SET, &sc::height_baro) },
+
+    // Pressure data (complete)
+    { WR_VAR(0, 10,  4), SynopVar(SynopAction::BARO_SENSOR, &sc::press) },
+    { WR_VAR(0, 10, 51), SynopVar(SynopAction::BARO_SENSOR, &sc::press_msl) },
+    { WR_VAR(0, 10, 61), SynopVar(SynopAction::BARO_SENSOR, &sc::press_3h) },
+    { WR_VAR(0, 10, 62), SynopVar(SynopAction::BARO_SENSOR, &sc::press_24h) },
+    { WR_VAR(0, 10, 63), SynopVar(SynopAction::BARO_SENSOR, &sc::press_tend) },
+    { WR_VAR(0, 10,  3), SynopVar(SynopAction::PRESSURE) },
+    { WR_VAR(0, 10,  8), SynopVar(SynopAction::PRESSURE) },
+    { WR_VAR(0, 10,  9), SynopVar(SynopAction::PRESSURE) },
+
+    // Temperature and humidity data (complete)
+    { WR_VAR(0, 12,   4), SynopVar(SynopAction::GEN_SENSOR, &sc::temp_2m) },
+    { WR_VAR(0, 12, 101), SynopVar(SynopAction::GEN_SENSOR, &sc::temp_2m) },
+    { WR_VAR(0, 12,   6), SynopVar(SynopAction::GEN_SENSOR, &sc::dewpoint_2m) },
+    { WR_VAR(0, 12, 103), SynopVar(SynopAction::GEN_SENSOR, &sc::dewpoint_2m) },
+    { WR_VAR(0, 13,   3), SynopVar(SynopAction::GEN_SENSOR, &sc::humidity) },
+    { WR_VAR(0, 12,   2), SynopVar(SynopAction::GEN_SENSOR, &sc::wet_temp_2m) },
+    { WR_VAR(0, 12, 102), SynopVar(SynopAction::GEN_SENSOR, &sc::wet_temp_2m) },
+
+    // Visibility data (complete)
+    { WR_VAR(0, 20,  1), SynopVar(SynopAction::GEN_SENSOR, &sc::visibility) },
+
+    // Precipitation past 24h (complete)
+    { WR_VAR(0, 13, 19), SynopVar(SynopAction::GEN_SENSOR, &sc::tot_prec1) },
+    { WR_VAR(0, 13, 20), SynopVar(SynopAction::GEN_SENSOR, &sc::tot_prec3) },
+    { WR_VAR(0, 13, 21), SynopVar(SynopAction::GEN_SENSOR, &sc::tot_prec6) },
+    { WR_VAR(0, 13, 22), SynopVar(SynopAction::GEN_SENSOR, &sc::tot_prec12) },
+    { WR_VAR(0, 13, 23), SynopVar(SynopAction::GEN_SENSOR, &sc::tot_prec24) },
+
+    // Cloud data
+    { WR_VAR(0, 20, 10), SynopVar(SynopAction::SET, &sc::cloud_n) },
+
+    // Individual cloud layers or masses (complete)
+    // Clouds with bases below station level (complete)
+    // Direction of cloud drift (complete)
+    { WR_VAR(0, 20, 11), SynopVar(SynopAction::CLOUD_GROUP) },
+    { WR_VAR(0, 20, 13), SynopVar(SynopAction::CLOUD_GROUP) },
+    { WR_VAR(0, 20, 17), SynopVar(SynopAction::CLOUD_GROUP) },
+    { WR_VAR(0, 20, 54), SynopVar(SynopAction::CLOUD_GROUP) },
+    // CH CL CM
+    { WR_VAR(0, 20, 12), SynopVar(SynopAction::CLOUD_TYPE) },
+
+    // Present and past weather (complete)
+    { WR_VAR(0, 20,  3), SynopVar(SynopAction::SET, &sc::pres_wtr) },
+    { WR_VAR(0, 20,  4), SynopVar(SynopAction::PAST_WEATHER, &sc::past_wtr1_6h) },
+    { WR_VAR(0, 20,  5), SynopVar(SynopAction::PAST_WEATHER, &sc::past_wtr2_6h) },
+
+    // Precipitation measurement (complete)
+    { WR_VAR(0, 13, 11), SynopVar(SynopAction::PRECIPITATION) },
+
+    // Extreme temperature data
+    { WR_VAR(0, 12, 111), SynopVar(SynopAction::TEMP_MAX) },
+    { WR_VAR(0, 12, 112), SynopVar(SynopAction::TEMP_MIN) },
+
+    // Wind data (complete)
+    { WR_VAR(0,  2,  2), SynopVar(SynopAction::SET, &sc::wind_inst) },
+
+    /* Note B/C 1.10.5.3.2 Calm shall be reported by
+     * setting wind direction to 0 and wind speed to 0.
+     * Variable shall be reported by setting wind direction
+     * to 0 and wind speed to a positive value, not a
+     * missing value indicator.
+     */
+    { WR_VAR(0, 11,  1), SynopVar(SynopAction::WIND, &sc::wind_dir) },
+    { WR_VAR(0, 11, 11), SynopVar(SynopAction::WIND, &sc::wind_dir) },
+    { WR_VAR(0, 11,  2), SynopVar(SynopAction::WIND, &sc::wind_speed) },
+    { WR_VAR(0, 11, 12), SynopVar(SynopAction::WIND, &sc::wind_speed) },
+    { WR_VAR(0, 11, 43), SynopVar(SynopAction::WIND_MAX, &sc::wind_gust_max_dir) },
+    { WR_VAR(0, 11, 41), SynopVar(SynopAction::WIND_MAX, &sc::wind_gust_max_speed) },
+
+    { WR_VAR(0, 12,  5), SynopVar(SynopAction::SET, &sc::wet_temp_2m) },
+    { WR_VAR(0, 10,197), SynopVar(SynopAction::SET, &sc::height_anem) },
+
+    { WR_VAR(0, 12, 30), SynopVar(SynopAction::GROUND_TEMP) },
+};
+
+}
+
 void SynopBaseImporter::import_var(const Var& var)
 {
-    switch (var.code())
+    const SynopVar& handler = synop_vars.get(var.code());
+    switch (handler.action)
     {
-        case WR_VAR(0,  8,  2):
-            // Store original VS value as a measured value
+        case SynopAction::WMO: WMOImporter::import_var(var); break;
+        case SynopAction::SET: set(var, *handler.shortcut); break;
+        case SynopAction::GEN_SENSOR: set_gen_sensor(var, *handler.shortcut); break;
+        case SynopAction::BARO_SENSOR: set_baro_sensor(var, *handler.shortcut); break;
+        case SynopAction::PAST_WEATHER: set_past_weather(var, *handler.shortcut); break;
+        case SynopAction::WIND: set_wind(var, *handler.shortcut); break;
+        case SynopAction::WIND_MAX: set_wind_max(var, *handler.shortcut); break;
+        case SynopAction::PRESSURE: set_pressure(var); break;
+        case SynopAction::VSS:
             set(var, WR_VAR(0, 8, 2), clouds.level, Trange::instant());
             break;
-
-        // Ship identification, movement, date/time, horizontal and vertical
-        // coordinates
-        case WR_VAR(0,  7,  1):
-        case WR_VAR(0,  7, 30): set(var, sc::height_station); break;
-        case WR_VAR(0,  7, 31):
-            /* Store also in the ana level, so that if the
-             * pressure later is missing we still have
-             * access to the value */
-            set(var, sc::height_baro);
+        case SynopAction::CLOUD_GROUP:
+            set(var, var.code(), clouds.level, Trange::instant());
             break;
-
-        // Pressure data (complete)
-        case WR_VAR(0, 10,  4): set_baro_sensor(var, sc::press); break;
-        case WR_VAR(0, 10, 51): set_baro_sensor(var, sc::press_msl); break;
-        case WR_VAR(0, 10, 61): set_baro_sensor(var, sc::press_3h); break;
-        case WR_VAR(0, 10, 62): set_baro_sensor(var, sc::press_24h); break;
-        case WR_VAR(0, 10, 63): set_baro_sensor(var, sc::press_tend); break;
-        case WR_VAR(0, 10,  3):
-        case WR_VAR(0, 10,  8):
-        case WR_VAR(0, 10,  9): set_pressure(var); break;
-
-        // Ship “instantaneous” data
-
-        // Temperature and humidity data (complete)
-        case WR_VAR(0, 12,   4):
-        case WR_VAR(0, 12, 101): set_gen_sensor(var, sc::temp_2m); break;
-        case WR_VAR(0, 12,   6):
-        case WR_VAR(0, 12, 103): set_gen_sensor(var, sc::dewpoint_2m); break;
-        case WR_VAR(0, 13,   3): set_gen_sensor(var, sc::humidity); break;
-        case WR_VAR(0, 12,   2):
-        case WR_VAR(0, 12, 102): set_gen_sensor(var, sc::wet_temp_2m); break;
-
-        // Visibility data (complete)
-        case WR_VAR(0, 20,  1): set_gen_sensor(var, sc::visibility); break;
-
-        // Precipitation past 24h (complete)
-        case WR_VAR(0, 13, 19): set_gen_sensor(var, sc::tot_prec1); break;
-        case WR_VAR(0, 13, 20): set_gen_sensor(var, sc::tot_prec3); break;
-        case WR_VAR(0, 13, 21): set_gen_sensor(var, sc::tot_prec6); break;
-        case WR_VAR(0, 13, 22): set_gen_sensor(var, sc::tot_prec12); break;
-        case WR_VAR(0, 13, 23): set_gen_sensor(var, sc::tot_prec24); break;
-
-        // Cloud data
-        case WR_VAR(0, 20, 10): set(var, sc::cloud_n); break;
-
-        // Individual cloud layers or masses (complete)
-        // Clouds with bases below station level (complete)
-        // Direction of cloud drift (complete)
-        case WR_VAR(0, 20, 11):
-        case WR_VAR(0, 20, 13):
-        case WR_VAR(0, 20, 17):
-        case WR_VAR(0, 20, 54): set(var, var.code(), clouds.level, Trange::instant()); break;
-        case WR_VAR(0, 20, 12): // CH CL CM
+        case SynopAction::CLOUD_TYPE:
             set(var, WR_VAR(0, 20, 12), clouds.clcmch(), Trange::instant());
             break;
-
-        // Present and past weather (complete)
-        case WR_VAR(0, 20,  3): set(var, sc::pres_wtr); break;
-        case WR_VAR(0, 20,  4): set_past_weather(var, sc::past_wtr1_6h); break;
-        case WR_VAR(0, 20,  5): set_past_weather(var, sc::past_wtr2_6h); break;
-
-        // Precipitation measurement (complete)
-        case WR_VAR(0, 13, 11): set_gen_sensor(var, WR_VAR(0, 13, 11), Level(1), Trange(1, 0, abs(trange.time_period))); break;
-
-        // Extreme temperature data
-        case WR_VAR(0, 12, 111):
+        case SynopAction::PRECIPITATION:
+            set_gen_sensor(var, WR_VAR(0, 13, 11), Level(1), Trange(1, 0, abs(trange.time_period)));
+            break;
+        case SynopAction::TEMP_MAX:
             set_gen_sensor(var, WR_VAR(0, 12, 101), Level(1), Trange(2, -abs(trange.time_period_offset), abs(trange.time_period)));
             break;
-        case WR_VAR(0, 12, 112):
+        case SynopAction::TEMP_MIN:
             set_gen_sensor(var, WR_VAR(0, 12, 101), Level(1), Trange(3, -abs(trange.time_period_offset), abs(trange.time_period)));
             break;
-
-        // Wind data (complete)
-        case WR_VAR(0, 2, 2): set(var, sc::wind_inst); break;
-
-        /* Note B/C 1.10.5.3.2 Calm shall be reported by
-         * setting wind direction to 0 and wind speed to 0.
-         * Variable shall be reported by setting wind direction
-         * to 0 and wind speed to a positive value, not a
-         * missing value indicator.
-         */
-        case WR_VAR(0, 11,  1):
-        case WR_VAR(0, 11, 11): set_wind(var, sc::wind_dir); break;
-        case WR_VAR(0, 11,  2):
-        case WR_VAR(0, 11, 12): set_wind(var, sc::wind_speed); break;
-        case WR_VAR(0, 11, 43): set_wind_max(var, sc::wind_gust_max_dir); break;
-        case WR_VAR(0, 11, 41): set_wind_max(var, sc::wind_gust_max_speed); break;
-
-        case WR_VAR(0, 12,  5): set(var, sc::wet_temp_2m); break;
-        case WR_VAR(0, 10,197): set(var, sc::height_anem); break;
-
-        case WR_VAR(0, 12, 30):
+        case SynopAction::GROUND_TEMP:
             set(var, WR_VAR(0, 12, 30), Level(106, level.ground_depth == LevelContext::missing ? MISSING_INT : level.ground_depth * 1000), Trange::instant());
             break;
-
-        default: WMOImporter::import_var(var); break;
     }
 }
 
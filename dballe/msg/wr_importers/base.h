@@ -3,7 +3,14 @@
 
 #include <dballe/msg/wr_codec.h>
 #include <dballe/msg/fwd.h>
+#include <wreport/error.h>
+#include <wreport/varinfo.h>
+#include <algorithm>
+#include <initializer_list>
+#include <iterator>
 #include <limits>
+#include <utility>
+#include <vector>
 #include <cstdint>
 
 namespace wreport {
@@ -17,21 +24,85 @@ namespace impl {
 namespace msg {
 namespace wr {
 
+/**
+ * Dense lookup table from B table varcodes to handlers.
+ *
+ * Varcodes are looked up by their X and Y in a table of small handler ids,
+ * and the ids index the list of handlers. This replaces a switch on sparse
+ * varcodes, which compiles to a tree of comparisons, with two array lookups,
+ * and lets importers switch on a dense range of actions.
+ *
+ * Varcodes not in the table, and varcodes with F != 0, map to a default
+ * constructed Handler.
+ */
+template<typename Handler>
+class VarDispatch
+{
+protected:
+    /// Handler ids indexed by the X and Y of a varcode
+    uint8_t ids[1 << 14];
+    /// Handlers indexed by id, starting with the default one
+    std::vector<Handler> handlers;
+
+public:
+    VarDispatch(std::initializer_list<std::pair<wreport::Varcode, Handler>> entries)
+        : handlers(1)
+    {
+        std::fill(std::begin(ids), std::end(ids), 0);
+        for (const auto& e: entries)
+        {
+            if (handlers.size() > std::numeric_limits<uint8_t>::max())
+                throw wreport::error_consistency("too many varcodes in importer dispatch table");
+            ids[e.first & 0x3fff] = handlers.size();
+            handlers.push_back(e.second);
+        }
+    }
+
+    /// Return the handler for \a code
+    const Handler& get(wreport::Varcode code) const
+    {
+        if (WR_VAR_F(code) != 0)
+            return handlers[0];
+        return handlers[ids[code & 0x3fff]];
+    }
+};
+
 class Importer
 {
 protected:
     const dballe::ImporterOptions& opts;
+    /// Sorted copy of opts.varcodes
+    std::vector<wreport::Varcode> varcodes;
+    /// True if opts only selects some of the data values
+    bool projecting;
     const wreport::Subset* subset;
     impl::Message* msg;
 
     virtual void init();
     virtual void run() = 0;
 
+    /**
+     * Check if opts selects a value with the given varcode, level and time
+     * range.
+     *
+     * Station information is always selected.
+     */
+    bool wanted(wreport::Varcode code, const Level& level, const Trange& trange) const;
+
+    /**
+     * Remove from msg the values not selected by opts, and their attributes
+     * if opts.attributes is false.
+     *
+     * set() already skips unwanted values without copying them: this takes
+     * care of the values that importers add to msg directly.
+     */
+    void project();
+
     void set(const wreport::Var& var, const Shortcut& shortcut);
     void set(const wreport::Var& var, wreport::Varcode code, const Level& level, const Trange& trange);
 
 public:
-    Importer(const dballe::ImporterOptions& opts) : opts(opts) {}
+    Importer(const dballe::ImporterOptions& opts);
     virtual ~Importer() {}
 
     virtual MessageType scanType(const wreport::Bulletin& bulletin) const = 0;
@@ -205,7 +276,7 @@ protected:
     UnsupportedContext unsupported;
     std::vector<Interpreted*> queued;
 
-    virtual void peek_var(const wreport::Var& var);
+    void peek_var(const wreport::Var& var);
     virtual void import_var(const wreport::Var& var);
 
     void set_gen_sensor(const wreport::Var& var, wreport::Varcode code, const Level& defaultLevel, const Trange& trange);
@@ -89,6 +89,7 @@ public:
 
     void run() override
     {
+        msg->data.begin_build();
         for (pos = 0; pos < subset->size(); ++pos)
         {
             const Var& var = (*subset)[pos];
@@ -96,6 +97,7 @@ public:
             if (var.isset())
                 import_var(var);
         }
+        msg->data.finish_build();
         if (b01008)
         {
             msg->set_ident_var(*b01008);
@@ -141,34 +143,105 @@ std::unique_ptr<Importer> Importer::createFlight(const dballe::ImporterOptions&
     return unique_ptr<Importer>(new FlightImporter(opts));
 }
 
+namespace {
+
+/// How FlightImporter::import_var interprets a variable
+enum class FlightAction : uint8_t
+{
+    /// Not a flight variable: try the general bulletin metadata
+    WMO,
+    B01006,
+    B01008,
+    /// Store the variable at the current flight level
+    ACQUIRE,
+    /// Store the variable at the current flight level with another varcode
+    ACQUIRE_AS,
+    ALTITUDE,
+    ISOBARIC_SURFACE,
+    FLIGHT_LEVEL,
+};
+
+struct FlightVar
+{
+    FlightAction action;
+    Varcode code;
+
+    FlightVar(FlightAction action=FlightAction::WMO, Varcode code=0)
+        : action(action), code(code) {}
+};
+
+const VarDispatch<FlightVar> flight_vars {
+    { WR_VAR(0,  1,  6), FlightVar(FlightAction::B01006) },
+    { WR_VAR(0,  1,  8), FlightVar(FlightAction::B01008) },
+    { WR_VAR(0,  1, 23), FlightVar(FlightAction::ACQUIRE) },
+    { WR_VAR(0,  2,  1), FlightVar(FlightAction::ACQUIRE) },
+    { WR_VAR(0,  2,  2), FlightVar(FlightAction::ACQUIRE) },
+    { WR_VAR(0,  2,  5), FlightVar(FlightAction::ACQUIRE) },
+    { WR_VAR(0,  2, 61), FlightVar(FlightAction::ACQUIRE) },
+    { WR_VAR(0,  2, 62), FlightVar(FlightAction::ACQUIRE) },
+    { WR_VAR(0,  2, 63), FlightVar(FlightAction::ACQUIRE) },
+    { WR_VAR(0,  2, 64), FlightVar(FlightAction::ACQUIRE) },
+    { WR_VAR(0,  2, 70), FlightVar(FlightAction::ACQUIRE) },
+    // Specific Altitude Above Mean Sea Level in mm
+    { WR_VAR(0,  7,  2), FlightVar(FlightAction::ALTITUDE) },
+    // Isobaric Surface in Pa
+    { WR_VAR(0,  7,  4), FlightVar(FlightAction::ISOBARIC_SURFACE) },
+    // Flight level
+    { WR_VAR(0,  7, 10), FlightVar(FlightAction::FLIGHT_LEVEL) },
+    { WR_VAR(0,  8,  4), FlightVar(FlightAction::ACQUIRE) },
+    { WR_VAR(0,  8,  9), FlightVar(FlightAction::ACQUIRE) },
+    { WR_VAR(0,  8, 21), FlightVar(FlightAction::ACQUIRE) },
+    { WR_VAR(0, 11,  1), FlightVar(FlightAction::ACQUIRE) },
+    { WR_VAR(0, 11,  2), FlightVar(FlightAction::ACQUIRE) },
+    { WR_VAR(0, 11, 31), FlightVar(FlightAction::ACQUIRE) },
+    { WR_VAR(0, 11, 32), FlightVar(FlightAction::ACQUIRE) },
+    { WR_VAR(0, 11, 33), FlightVar(FlightAction::ACQUIRE) },
+    { WR_VAR(0, 11, 34), FlightVar(FlightAction::ACQUIRE) },
+    { WR_VAR(0, 11, 35), FlightVar(FlightAction::ACQUIRE) },
+    { WR_VAR(0, 11, 36), FlightVar(FlightAction::ACQUIRE) },
+    { WR_VAR(0, 11, 37), FlightVar(FlightAction::ACQUIRE) },
+    { WR_VAR(0, 11, 39), FlightVar(FlightAction::ACQUIRE) },
+    { WR_VAR(0, 11, 77), FlightVar(FlightAction::ACQUIRE) },
+    { WR_VAR(0, 12,  1), FlightVar(FlightAction::ACQUIRE_AS, WR_VAR(0, 12, 101)) },
+    { WR_VAR(0, 12,101), FlightVar(FlightAction::ACQUIRE) },
+    { WR_VAR(0, 12,  3), FlightVar(FlightAction::ACQUIRE_AS, WR_VAR(0, 12, 103)) },
+    { WR_VAR(0, 12,103), FlightVar(FlightAction::ACQUIRE) },
+    { WR_VAR(0, 13,  2), FlightVar(FlightAction::ACQUIRE) },
+    { WR_VAR(0, 13,  3), FlightVar(FlightAction::ACQUIRE) },
+    { WR_VAR(0, 20, 41), FlightVar(FlightAction::ACQUIRE) },
+    { WR_VAR(0, 20, 42), FlightVar(FlightAction::ACQUIRE) },
+    { WR_VAR(0, 20, 43), FlightVar(FlightAction::ACQUIRE) },
+    { WR_VAR(0, 20, 44), FlightVar(FlightAction::ACQUIRE) },
+    { WR_VAR(0, 20, 45), FlightVar(FlightAction::ACQUIRE) },
+    { WR_VAR(0, 33, 25), FlightVar(FlightAction::ACQUIRE) },
+// TODO: repeated 011075 MEAN TURBULENCE INTENSITY (EDDY DISSIPATION RATE)[M**(2/3)/S]
+// TODO: repeated 011076 PEAK TURBULENCE INTENSITY (EDDY DISSIPATION RATE)[M**(2/3)/S]
+};
+
+}
+
 void FlightImporter::import_var(const Var& var)
 {
-    switch (var.code())
+    const FlightVar& handler = flight_vars.get(var.code());
+    switch (handler.action)
     {
-        case WR_VAR(0,  1,  6): b01006 = &var; break;
-        case WR_VAR(0,  1,  8): b01008 = &var; break;
-        case WR_VAR(0,  1, 23): acquire(var); break;
-        case WR_VAR(0,  2,  1): acquire(var); break;
-        case WR_VAR(0,  2,  2): acquire(var); break;
-        case WR_VAR(0,  2,  5): acquire(var); break;
-        case WR_VAR(0,  2, 61): acquire(var); break;
-        case WR_VAR(0,  2, 62): acquire(var); break;
-        case WR_VAR(0,  2, 63): acquire(var); break;
-        case WR_VAR(0,  2, 64): acquire(var); break;
-        case WR_VAR(0,  2, 70): acquire(var); break;
-        case WR_VAR(0,  7,  2):
+        case FlightAction::WMO: WMOImporter::import_var(var); break;
+        case FlightAction::B01006: b01006 = &var; break;
+        case FlightAction::B01008: b01008 = &var; break;
+        case FlightAction::ACQUIRE: acquire(var); break;
+        case FlightAction::ACQUIRE_AS: acquire(var, handler.code); break;
+        case FlightAction::ALTITUDE:
             // Specific Altitude Above Mean Sea Level in mm
             set_level(Level(102, var.enqd() * 1000));
             acquire(var, WR_VAR(0,  7, 30));
             break;
-        case WR_VAR(0,  7,  4):
+        case FlightAction::ISOBARIC_SURFACE:
             // Isobaric Surface in Pa
             if (lev.ltype1 == MISSING_INT)
                 set_level(Level(100, var.enqd()));
             acquire(var, WR_VAR(0, 10,  4));
             break;
-        case WR_VAR(0,  7,  10):
-            // Flight level
+        case FlightAction::FLIGHT_LEVEL:
             if (opts.simplified)
             {
                 // Convert to pressure using formula from
@@ -181,37 +254,6 @@ void FlightImporter::import_var(const Var& var)
                 set_level(Level(102, var.enqd() * 1000));
             acquire(var, WR_VAR(0, 7, 30));
             break;
-        case WR_VAR(0,  8,  4): acquire(var); break;
-        case WR_VAR(0,  8,  9): acquire(var); break;
-        case WR_VAR(0,  8, 21): acquire(var); break;
-        case WR_VAR(0, 11,  1): acquire(var); break;
-        case WR_VAR(0, 11,  2): acquire(var); break;
-        case WR_VAR(0, 11, 31): acquire(var); break;
-        case WR_VAR(0, 11, 32): acquire(var); break;
-        case WR_VAR(0, 11, 33): acquire(var); break;
-        case WR_VAR(0, 11, 34): acquire(var); break;
-        case WR_VAR(0, 11, 35): acquire(var); break;
-        case WR_VAR(0, 11, 36): acquire(var); break;
-        case WR_VAR(0, 11, 37): acquire(var); break;
-        case WR_VAR(0, 11, 39): acquire(var); break;
-        case WR_VAR(0, 11, 77): acquire(var); break;
-        case WR_VAR(0, 12,  1): acquire(var, WR_VAR(0, 12, 101)); break;
-        case WR_VAR(0, 12,101): acquire(var); break;
-        case WR_VAR(0, 12,  3): acquire(var, WR_VAR(0, 12, 103)); break;
-        case WR_VAR(0, 12,103): acquire(var); break;
-        case WR_VAR(0, 13,  2): acquire(var); break;
-        case WR_VAR(0, 13,  3): acquire(var); break;
-        case WR_VAR(0, 20, 41): acquire(var); break;
-        case WR_VAR(0, 20, 42): acquire(var); break;
-        case WR_VAR(0, 20, 43): acquire(var); break;
-        case WR_VAR(0, 20, 44): acquire(var); break;
-        case WR_VAR(0, 20, 45): acquire(var); break;
-        case WR_VAR(0, 33, 25): acquire(var); break;
-// TODO: repeated 011075 MEAN TURBULENCE INTENSITY (EDDY DISSIPATION RATE)[M**(2/3)/S]
-// TODO: repeated 011076 PEAK TURBULENCE INTENSITY (EDDY DISSIPATION RATE)[M**(2/3)/S]
-        default:
-            WMOImporter::import_var(var);
-            break;
     }
 }
 
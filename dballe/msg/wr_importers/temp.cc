@@ -6,6 +6,7 @@
 #include <wreport/notes.h>
 #include "dballe/msg/msg.h"
 #include "dballe/msg/context.h"
+#include "dballe/core/shortcuts.h"
 #include <cmath>
 #include <ostream>
 
@@ -126,6 +127,9 @@ public:
 
     virtual void run()
     {
+        // Soundings can have thousands of levels: append contexts unsorted and
+        // sort them all at the end
+        msg->data.begin_build();
         for (pos = 0; pos < subset->size(); )
         {
             const Var& var = (*subset)[pos];
@@ -146,6 +150,7 @@ public:
                 ++pos;
             }
         }
+        msg->data.finish_build();
 
         /* Extract surface data from the surface level */
         if (surface_press != -1)
@@ -222,33 +227,179 @@ std::unique_ptr<Importer> Importer::createTemp(const dballe::ImporterOptions& op
     return unique_ptr<Importer>(new TempImporter(opts));
 }
 
-void TempImporter::import_var(const Var& var)
+namespace {
+
+/// How TempImporter::import_var interprets a variable
+enum class TempAction : uint8_t
 {
-    switch (var.code())
-    {
+    /// Not a temp variable: try the general bulletin metadata
+    WMO,
+    /// Store using the shortcut
+    SET,
+    /// Store at the current pressure level, as the given varcode
+    PRESS_LEVEL,
+    TIME_SIG,
+    CLOUD_VSS,
+    CLOUD_TYPE,
+    /// Extended vertical sounding significance
+    EXT_VSS,
+    PRESSURE,
+    /// Vertical sounding significance
+    VSS,
+};
+
+struct TempVar
+{
+    TempAction action;
+    const Shortcut* shortcut;
+    Varcode code;
+
+    TempVar(TempAction action=TempAction::WMO, const Shortcut* shortcut=nullptr)
+        : action(action), shortcut(shortcut), code(0) {}
+    TempVar(TempAction action, Varcode code)
+        : action(action), shortcut(nullptr), code(code) {}
+};
+
+const VarDispatch<TempVar> temp_vars {
 /* Identification of launch site and instrumentation */
-        case WR_VAR(0,  2,  3): msg->set_meas_equip_type_var(var); break;
-        case WR_VAR(0,  2, 11): msg->set_sonde_type_var(var); break;
-        case WR_VAR(0,  2, 12): msg->set_sonde_method_var(var); break;
-        case WR_VAR(0,  2, 13): msg->set_sonde_correction_var(var); break;
-        case WR_VAR(0,  2, 14): msg->set_sonde_tracking_var(var); break;
+    { WR_VAR(0,  2,  3), TempVar(TempAction::SET, &sc::meas_equip_type) },
+    { WR_VAR(0,  2, 11), TempVar(TempAction::SET, &sc::sonde_type) },
+    { WR_VAR(0,  2, 12), TempVar(TempAction::SET, &sc::sonde_method) },
+    { WR_VAR(0,  2, 13), TempVar(TempAction::SET, &sc::sonde_correction) },
+    { WR_VAR(0,  2, 14), TempVar(TempAction::SET, &sc::sonde_tracking) },
 /* Date/time of launch */
-        case WR_VAR(0,  8, 21):
+    { WR_VAR(0,  8, 21), TempVar(TempAction::TIME_SIG) },
+/* Horizontal and vertical coordinates of launch site */
+    { WR_VAR(0,  7,  1), TempVar(TempAction::SET, &sc::height_station) },
+    { WR_VAR(0,  7, 30), TempVar(TempAction::SET, &sc::height_station) },
+    { WR_VAR(0,  7, 31), TempVar(TempAction::SET, &sc::height_baro) },
+    { WR_VAR(0,  7,  7), TempVar(TempAction::SET, &sc::height_release) },
+    { WR_VAR(0, 33, 24), TempVar(TempAction::SET, &sc::station_height_quality) },
+/* Cloud information reported with vertical soundings */
+    { WR_VAR(0,  8,  2), TempVar(TempAction::CLOUD_VSS) },
+    { WR_VAR(0, 20, 10), TempVar(TempAction::SET, &sc::cloud_n) },
+    { WR_VAR(0, 20, 11), TempVar(TempAction::SET, &sc::cloud_nh) },
+    { WR_VAR(0, 20, 13), TempVar(TempAction::SET, &sc::cloud_hh) },
+    // CH CL CM
+    { WR_VAR(0, 20, 12), TempVar(TempAction::CLOUD_TYPE) },
+    { WR_VAR(0, 22, 43), TempVar(TempAction::SET, &sc::water_temp) },
+/* Temperature, dew-point and wind data at pressure levels */
+    // Long time period or displacement (since launch time)
+    { WR_VAR(0,  4, 16), TempVar(TempAction::PRESS_LEVEL, WR_VAR(0,  4, 86)) },
+    { WR_VAR(0,  4, 86), TempVar(TempAction::PRESS_LEVEL, WR_VAR(0,  4, 86)) },
+    { WR_VAR(0,  8, 42), TempVar(TempAction::EXT_VSS) },
+    { WR_VAR(0,  7,  4), TempVar(TempAction::PRESSURE) },
+    { WR_VAR(0,  8,  1), TempVar(TempAction::VSS) },
+    // Geopotential
+    { WR_VAR(0, 10,  3), TempVar(TempAction::PRESS_LEVEL, WR_VAR(0, 10,  8)) },
+    { WR_VAR(0, 10,  8), TempVar(TempAction::PRESS_LEVEL, WR_VAR(0, 10,  8)) },
+    { WR_VAR(0, 10,  9), TempVar(TempAction::PRESS_LEVEL, WR_VAR(0, 10,  8)) },
+    // Latitude displacement
+    { WR_VAR(0,  5, 15), TempVar(TempAction::PRESS_LEVEL, WR_VAR(0,  5, 15)) },
+    // Longitude displacement
+    { WR_VAR(0,  6, 15), TempVar(TempAction::PRESS_LEVEL, WR_VAR(0,  6, 15)) },
+    // Dry bulb temperature
+    { WR_VAR(0, 12,  1), TempVar(TempAction::PRESS_LEVEL, WR_VAR(0, 12, 101)) },
+    { WR_VAR(0, 12, 101), TempVar(TempAction::PRESS_LEVEL, WR_VAR(0, 12, 101)) },
+    // Wet bulb temperature
+    { WR_VAR(0, 12,  2), TempVar(TempAction::PRESS_LEVEL, WR_VAR(0, 12,  2)) },
+    // Dew point temperature
+    { WR_VAR(0, 12,  3), TempVar(TempAction::PRESS_LEVEL, WR_VAR(0, 12, 103)) },
+    { WR_VAR(0, 12, 103), TempVar(TempAction::PRESS_LEVEL, WR_VAR(0, 12, 103)) },
+    // Wind direction
+    { WR_VAR(0, 11,  1), TempVar(TempAction::PRESS_LEVEL, WR_VAR(0, 11,  1)) },
+    // Wind speed
+    { WR_VAR(0, 11,  2), TempVar(TempAction::PRESS_LEVEL, WR_VAR(0, 11,  2)) },
+/* Wind shear data at a pressure level */
+    { WR_VAR(0, 11, 61), TempVar(TempAction::PRESS_LEVEL, WR_VAR(0, 11, 61)) },
+    { WR_VAR(0, 11, 62), TempVar(TempAction::PRESS_LEVEL, WR_VAR(0, 11, 62)) },
+};
+
+/// How a variable in a sounding group defines the level of the group
+enum class GroupLevel : uint8_t
+{
+    NONE,
+    /// Height level
+    HEIGHT,
+    /// Height level converted in mm
+    HEIGHT_MM,
+    /// Pressure level
+    PRESSURE,
+    /// Geopotential, converted to height
+    GEOPOTENTIAL,
+};
+
+/// How TempImporter::import_group imports a variable
+enum class GroupAction : uint8_t
+{
+    SKIP,
+    /// Store as the given varcode
+    SET,
+    /// Vertical sounding significance, converted to B08042
+    VSS,
+    /// Extended vertical sounding significance
+    EXT_VSS,
+    /// Quality information for the previous variable
+    QUALITY,
+};
+
+struct TempGroupVar
+{
+    GroupLevel level;
+    GroupAction action;
+    Varcode code;
+
+    TempGroupVar(GroupAction action=GroupAction::SKIP, Varcode code=0, GroupLevel level=GroupLevel::NONE)
+        : level(level), action(action), code(code) {}
+};
+
+const VarDispatch<TempGroupVar> temp_group_vars {
+    // Geopotential height, for pilots (FIXME: above ground or above msl?)
+    { WR_VAR(0,  7,  2), TempGroupVar(GroupAction::SKIP, 0, GroupLevel::HEIGHT) },
+    { WR_VAR(0,  7,  9), TempGroupVar(GroupAction::SKIP, 0, GroupLevel::HEIGHT) },
+    { WR_VAR(0,  7,  7), TempGroupVar(GroupAction::SKIP, 0, GroupLevel::HEIGHT_MM) },
+    { WR_VAR(0,  7,  4), TempGroupVar(GroupAction::SET, WR_VAR(0, 10,  4), GroupLevel::PRESSURE) },
+    { WR_VAR(0, 10,  3), TempGroupVar(GroupAction::SET, WR_VAR(0, 10,  8), GroupLevel::GEOPOTENTIAL) },
+    { WR_VAR(0,  4, 16), TempGroupVar(GroupAction::SET, WR_VAR(0,  4, 86)) },
+    { WR_VAR(0,  4, 86), TempGroupVar(GroupAction::SET, WR_VAR(0,  4, 86)) },
+    { WR_VAR(0,  5,  1), TempGroupVar(GroupAction::SET, WR_VAR(0,  5,  1)) },
+    { WR_VAR(0,  5,  2), TempGroupVar(GroupAction::SET, WR_VAR(0,  5,  1)) },
+    { WR_VAR(0,  5, 15), TempGroupVar(GroupAction::SET, WR_VAR(0,  5, 15)) },
+    { WR_VAR(0,  6,  1), TempGroupVar(GroupAction::SET, WR_VAR(0,  6,  1)) },
+    { WR_VAR(0,  6,  2), TempGroupVar(GroupAction::SET, WR_VAR(0,  6,  1)) },
+    { WR_VAR(0,  6, 15), TempGroupVar(GroupAction::SET, WR_VAR(0,  6, 15)) },
+    { WR_VAR(0,  8,  1), TempGroupVar(GroupAction::VSS) },
+    { WR_VAR(0,  8, 42), TempGroupVar(GroupAction::EXT_VSS) },
+    { WR_VAR(0, 10,  9), TempGroupVar(GroupAction::SET, WR_VAR(0, 10,  8)) },
+    { WR_VAR(0, 12,  1), TempGroupVar(GroupAction::SET, WR_VAR(0, 12, 101)) },
+    { WR_VAR(0, 12, 101), TempGroupVar(GroupAction::SET, WR_VAR(0, 12, 101)) },
+    { WR_VAR(0, 12,  3), TempGroupVar(GroupAction::SET, WR_VAR(0, 12, 103)) },
+    { WR_VAR(0, 12, 103), TempGroupVar(GroupAction::SET, WR_VAR(0, 12, 103)) },
+    { WR_VAR(0, 10,  4), TempGroupVar(GroupAction::SET, WR_VAR(0, 10,  4)) },
+    { WR_VAR(0, 11,  1), TempGroupVar(GroupAction::SET, WR_VAR(0, 11,  1)) },
+    { WR_VAR(0, 11,  2), TempGroupVar(GroupAction::SET, WR_VAR(0, 11,  2)) },
+    // Variables from Radar doppler wind profiles
+    { WR_VAR(0, 11,  6), TempGroupVar(GroupAction::SET, WR_VAR(0, 11,  6)) },
+    { WR_VAR(0, 11, 50), TempGroupVar(GroupAction::SET, WR_VAR(0, 11, 50)) },
+    { WR_VAR(0, 33,  2), TempGroupVar(GroupAction::QUALITY) },
+};
+
+}
+
+void TempImporter::import_var(const Var& var)
+{
+    const TempVar& handler = temp_vars.get(var.code());
+    switch (handler.action)
+    {
+        case TempAction::WMO: WMOImporter::import_var(var); break;
+        case TempAction::SET: msg->set(*handler.shortcut, var); break;
+        case TempAction::PRESS_LEVEL: msg->set(Level(100, press), Trange::instant(), handler.code, var); break;
+        case TempAction::TIME_SIG:
             if (var.enqi() != 18)
                 notes::log() << "TEMP time significance is " << var.enqi() << " instead of 18" << endl;
             break;
-/* Horizontal and vertical coordinates of launch site */
-        case WR_VAR(0,  7,  1):
-        case WR_VAR(0,  7, 30): msg->set_height_station_var(var); break;
-        case WR_VAR(0,  7, 31): msg->set_height_baro_var(var); break;
-        case WR_VAR(0,  7,  7): msg->set_height_release_var(var); break;
-        case WR_VAR(0, 33, 24): msg->set_station_height_quality_var(var); break;
-/* Cloud information reported with vertical soundings */
-        case WR_VAR(0,  8,  2): msg->set(Level::cloud(258, 0), Trange::instant(), WR_VAR(0, 8, 2), var); break;
-        case WR_VAR(0, 20, 10): msg->set_cloud_n_var(var); break;
-        case WR_VAR(0, 20, 11): msg->set_cloud_nh_var(var); break;
-        case WR_VAR(0, 20, 13): msg->set_cloud_hh_var(var); break;
-        case WR_VAR(0, 20, 12): { // CH CL CM
+        case TempAction::CLOUD_VSS: msg->set(Level::cloud(258, 0), Trange::instant(), WR_VAR(0, 8, 2), var); break;
+        case TempAction::CLOUD_TYPE: {
             int l2 = 1;
             if (pos > 0 && (*subset)[pos - 1].code() == WR_VAR(0, 20, 12))
             {
@@ -259,34 +410,25 @@ void TempImporter::import_var(const Var& var)
             msg->set(Level::cloud(258, l2), Trange::instant(), WR_VAR(0, 20, 12), var);
             break;
         }
-        case WR_VAR(0, 22, 43): msg->set_water_temp_var(var); break;
-/* Temperature, dew-point and wind data at pressure levels */
-        // Long time period or displacement (since launch time)
-        case WR_VAR(0,  4, 16):
-        case WR_VAR(0,  4, 86): msg->set(Level(100, press), Trange::instant(), WR_VAR(0, 4, 86), var); break;
-        // Extended vertical sounding significance
-        case WR_VAR(0,  8, 42): {
-                if (pos == subset->size() - 1) throw error_consistency("B08042 found at end of message");
-                if ((*subset)[pos + 1].code() == WR_VAR(0, 7, 4))
-                {
-                    // Pressure is reported later, we need to look ahead to compute the right level
-                    press_var = &((*subset)[pos + 1]);
-                    if (press_var->isset())
-                        press = press_var->enqd();
-                    else
-                        press = MISSING_INT;
-                }
-                msg->set(Level(100, press), Trange::instant(), WR_VAR(0, 8, 42), var);
-                break;
-        }
-        // Pressure
-        case WR_VAR(0,  7,  4):
-                press = var.enqd();
-                press_var = &var;
-                msg->set(Level(100, press), Trange::instant(), WR_VAR(0, 10, 4), var);
-                break;
-        // Vertical sounding significance
-        case WR_VAR(0,  8,  1):
+        case TempAction::EXT_VSS:
+            if (pos == subset->size() - 1) throw error_consistency("B08042 found at end of message");
+            if ((*subset)[pos + 1].code() == WR_VAR(0, 7, 4))
+            {
+                // Pressure is reported later, we need to look ahead to compute the right level
+                press_var = &((*subset)[pos + 1]);
+                if (press_var->isset())
+                    press = press_var->enqd();
+                else
+                    press = MISSING_INT;
+            }
+            msg->set(Level(100, press), Trange::instant(), WR_VAR(0, 8, 42), var);
+            break;
+        case TempAction::PRESSURE:
+            press = var.enqd();
+            press_var = &var;
+            msg->set(Level(100, press), Trange::instant(), WR_VAR(0, 10, 4), var);
+            break;
+        case TempAction::VSS:
             {
                 // This account for weird data that has '1' for VSS
                 unsigned val = convert_BUFR08001_to_BUFR08042(var.enqi());
@@ -303,32 +445,6 @@ void TempImporter::import_var(const Var& var)
                 surface_press_var = press_var;
             }
             break;
-        // Geopotential
-        case WR_VAR(0, 10,  3): msg->set(Level(100, press), Trange::instant(), WR_VAR(0, 10, 8), var); break;
-        case WR_VAR(0, 10,  8): msg->set(Level(100, press), Trange::instant(), WR_VAR(0, 10, 8), var); break;
-        case WR_VAR(0, 10,  9): msg->set(Level(100, press), Trange::instant(), WR_VAR(0, 10, 8), var); break;
-        // Latitude displacement
-        case WR_VAR(0,  5, 15): msg->set(Level(100, press), Trange::instant(), WR_VAR(0, 5, 15), var); break;
-        // Longitude displacement
-        case WR_VAR(0,  6, 15): msg->set(Level(100, press), Trange::instant(), WR_VAR(0, 6, 15), var); break;
-        // Dry bulb temperature
-        case WR_VAR(0, 12,  1): msg->set(Level(100, press), Trange::instant(), WR_VAR(0, 12, 101), var); break;
-        case WR_VAR(0, 12, 101): msg->set(Level(100, press), Trange::instant(), WR_VAR(0, 12, 101), var); break;
-        // Wet bulb temperature
-        case WR_VAR(0, 12,  2): msg->set(Level(100, press), Trange::instant(), WR_VAR(0, 12, 2), var); break;
-        // Dew point temperature
-        case WR_VAR(0, 12,  3): msg->set(Level(100, press), Trange::instant(), WR_VAR(0, 12, 103), var); break;
-        case WR_VAR(0, 12, 103): msg->set(Level(100, press), Trange::instant(), WR_VAR(0, 12, 103), var); break;
-        // Wind direction
-        case WR_VAR(0, 11,  1): msg->set(Level(100, press), Trange::instant(), WR_VAR(0, 11, 1), var); break;
-        // Wind speed
-        case WR_VAR(0, 11,  2): msg->set(Level(100, press), Trange::instant(), WR_VAR(0, 11, 2), var); break;
-/* Wind shear data at a pressure level */
-        case WR_VAR(0, 11, 61): msg->set(Level(100, press), Trange::instant(), WR_VAR(0, 11, 61), var); break;
-        case WR_VAR(0, 11, 62): msg->set(Level(100, press), Trange::instant(), WR_VAR(0, 11, 62), var); break;
-        default:
-                WMOImporter::import_var(var);
-                break;
     }
 }
 
@@ -339,29 +455,15 @@ void TempImporter::import_group(unsigned start, unsigned length)
     for (unsigned i = 0; i < length && lev.ltype1 == MISSING_INT; ++i)
     {
         const Var& var = (*subset)[start + i];
-        switch (var.code())
+        if (!var.isset()) continue;
+        switch (temp_group_vars.get(var.code()).level)
         {
-            // Height level
-            case WR_VAR(0, 7, 2):
-            case WR_VAR(0, 7, 9): // Geopotential height, for pilots (FIXME: above ground or above msl?)
-                if (var.isset())
-                    lev = Level(102, var.enqd());
-                break;
-            // Height level converted in mm
-            case WR_VAR(0, 7, 7):
-                if (var.isset())
-                    lev = Level(102, var.enqd() * 1000);
-                break;
-            // Pressure level
-            case WR_VAR(0, 7, 4):
-                if (var.isset())
-                    lev = Level(100, var.enqd());
-                break;
-            case WR_VAR(0, 10, 3):
-                // Convert geopotential to height
-                if (var.isset())
-                    lev = Level(102, lround(var.enqd() / 9.80665));
-                break;
+            case GroupLevel::NONE: break;
+            case GroupLevel::HEIGHT: lev = Level(102, var.enqd()); break;
+            case GroupLevel::HEIGHT_MM: lev = Level(102, var.enqd() * 1000); break;
+            case GroupLevel::PRESSURE: lev = Level(100, var.enqd()); break;
+            // Convert geopotential to height
+            case GroupLevel::GEOPOTENTIAL: lev = Level(102, lround(var.enqd() / 9.80665)); break;
         }
     }
     if (lev.ltype1 == MISSING_INT)
@@ -372,30 +474,20 @@ void TempImporter::import_group(unsigned start, unsigned length)
     for (unsigned i = 0; i < length; ++i)
     {
         const Var& var = (*subset)[start + i];
+        const TempGroupVar& handler = temp_group_vars.get(var.code());
         if (!var.isset())
         {
-            switch (var.code())
-            {
-                case WR_VAR(0,  8,  1):
-                case WR_VAR(0,  8, 42):
-                    // Preserve missing VSS with only the one missing bit set,
-                    // to act as a sounding context marker
-                    msg->set(lev, Trange::instant(), newvar(WR_VAR(0,  8,  42), (int)BUFR08042::MISSING));
-                    break;
-            }
+            if (handler.action == GroupAction::VSS || handler.action == GroupAction::EXT_VSS)
+                // Preserve missing VSS with only the one missing bit set,
+                // to act as a sounding context marker
+                msg->set(lev, Trange::instant(), newvar(WR_VAR(0,  8,  42), (int)BUFR08042::MISSING));
             continue;
         }
-        switch (var.code())
+        switch (handler.action)
         {
-            case WR_VAR(0,  4, 16):
-            case WR_VAR(0,  4, 86): msg->set(lev, Trange::instant(), WR_VAR(0,  4,  86), var); break;
-            case WR_VAR(0,  5,  1):
-            case WR_VAR(0,  5,  2): msg->set(lev, Trange::instant(), WR_VAR(0,  5,   1), var); break;
-            case WR_VAR(0,  5, 15): msg->set(lev, Trange::instant(), WR_VAR(0,  5,  15), var); break;
-            case WR_VAR(0,  6,  1):
-            case WR_VAR(0,  6,  2): msg->set(lev, Trange::instant(), WR_VAR(0,  6,   1), var); break;
-            case WR_VAR(0,  6, 15): msg->set(lev, Trange::instant(), WR_VAR(0,  6,  15), var); break;
-            case WR_VAR(0,  8,  1):
+            case GroupAction::SKIP: break;
+            case GroupAction::SET: msg->set(lev, Trange::instant(), handler.code, var); break;
+            case GroupAction::VSS:
                 {
                     // This accounts for weird data that has '1' for VSS
                     unsigned val = convert_BUFR08001_to_BUFR08042(var.enqi());
@@ -409,23 +501,8 @@ void TempImporter::import_group(unsigned start, unsigned length)
                     }
                 }
                 break;
-            case WR_VAR(0,  8, 42): msg->set(lev, Trange::instant(), WR_VAR(0,  8,  42), var); break;
-            case WR_VAR(0, 10,  3): msg->set(lev, Trange::instant(), WR_VAR(0, 10,   8), var); break;
-            case WR_VAR(0, 10,  9): msg->set(lev, Trange::instant(), WR_VAR(0, 10,   8), var); break;
-            case WR_VAR(0, 12,  1):
-            case WR_VAR(0, 12, 101): msg->set(lev, Trange::instant(), WR_VAR(0, 12, 101), var); break;
-            case WR_VAR(0, 12,  3):
-            case WR_VAR(0, 12, 103): msg->set(lev, Trange::instant(), WR_VAR(0, 12, 103), var); break;
-            case WR_VAR(0,  7,  4):
-            case WR_VAR(0, 10,  4): msg->set(lev, Trange::instant(), WR_VAR(0, 10,   4), var); break;
-            case WR_VAR(0, 11,  1):
-            case WR_VAR(0, 11,  2):
-                msg->set(lev, Trange::instant(), var.code(), var);
-                break;
-            // Variables from Radar doppler wind profiles
-            case WR_VAR(0, 11,  6): msg->set(lev, Trange::instant(), var.code(), var); break;
-            case WR_VAR(0, 11, 50): msg->set(lev, Trange::instant(), var.code(), var); break;
-            case WR_VAR(0, 33,  2):
+            case GroupAction::EXT_VSS: msg->set(lev, Trange::instant(), WR_VAR(0,  8,  42), var); break;
+            case GroupAction::QUALITY:
                 // Doppler wind profiles transmit quality information inline,
                 // following the variable they refer to.
                 if (i > 0)
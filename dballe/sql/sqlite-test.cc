@@ -1,6 +1,7 @@
 #include "dballe/core/tests.h"
 #include "dballe/db.h"
 #include "sqlite.h"
+#include "querybuf.h"
 
 using namespace std;
 using namespace dballe;
@@ -23,6 +24,7 @@ struct SQLiteFixture : Fixture
     void test_setup()
     {
         Fixture::test_setup();
+        conn->integer_datetimes = false;
         conn->drop_table_if_exists("dballe_test");
         conn->exec("CREATE TABLE dballe_test (val INTEGER NOT NULL)");
     }
@@ -180,6 +182,43 @@ add_method("auto_increment", [](Fixture& f) {
     wassert(actual(f.conn->get_last_insert_id()) == 2);
 });
 
+add_method("integer_datetimes", [](Fixture& f) {
+    wassert(actual(SQLiteConnection::datetime_to_seconds(Datetime(1970, 1, 1))) == 0);
+    wassert(actual(SQLiteConnection::datetime_to_seconds(Datetime(1969, 12, 31, 23, 59, 59))) == -1);
+    wassert(actual(SQLiteConnection::datetime_from_seconds(-1)) == Datetime(1969, 12, 31, 23, 59, 59));
+
+    // Conversions agree with SQLite's date functions, used by
+    // convert-datetimes
+    auto s = f.conn->sqlitestatement("SELECT CAST(strftime('%s', ?) AS INTEGER)");
+    for (const auto& dt: { Datetime(1000, 1, 1), Datetime(1900, 2, 28, 12, 30, 1), Datetime(2000, 2, 29, 23, 59, 59), Datetime(2038, 1, 19, 3, 14, 8) })
+    {
+        s->bind_val(1, dt);
+        int64_t val = 0;
+        s->execute_one([&]() { val = s->column_int64(0); });
+        wassert(actual(SQLiteConnection::datetime_to_seconds(dt)) == val);
+        wassert(actual(SQLiteConnection::datetime_from_seconds(val)) == dt);
+    }
+
+    f.conn->exec("CREATE TABLE dballe_testdt (dt INTEGER NOT NULL)");
+    f.conn->integer_datetimes = true;
+    auto i = f.conn->sqlitestatement("INSERT INTO dballe_testdt (dt) VALUES (?)");
+    i->bind_val(1, Datetime(2016, 3, 4, 5, 6, 7));
+    i->execute();
+    wassert_throws(wreport::error_consistency, i->bind_val(1, Datetime(2016, 12, 31, 23, 59, 60)));
+
+    Querybuf q;
+    q.append("SELECT dt FROM dballe_testdt WHERE dt=");
+    f.conn->add_datetime(q, Datetime(2016, 3, 4, 5, 6, 7));
+    auto sel = f.conn->sqlitestatement(q);
+    unsigned count = 0;
+    sel->execute([&]() {
+        wassert(actual(sel->column_datetime(0)) == Datetime(2016, 3, 4, 5, 6, 7));
+        ++count;
+    });
+    wassert(actual(count) == 1u);
+    f.conn->integer_datetimes = false;
+});
+
 add_method("connect", [](Fixture& f) {
     auto conn = Connection::create(*DBConnectOptions::create("sqlite:test.sqlite"));
     wassert_true(conn->server_type == sql::ServerType::SQLITE);
@@ -191,6 +230,52 @@ add_method("connect", [](Fixture& f) {
     wassert_true(conn->server_type == sql::ServerType::SQLITE);
 });
 
+add_method("profile", [](Fixture& f) {
+    auto pragma = [](SQLiteConnection& conn, const char* name) {
+        auto s = conn.sqlitestatement(string("PRAGMA ") + name);
+        string res;
+        s->execute_one([&]() { res = s->column_string(0); });
+        return res;
+    };
+
+    auto conn = SQLiteConnection::create();
+    conn->open_file("test.sqlite");
+    wassert(actual(conn->profile) == "");
+    wassert(actual(pragma(*conn, "journal_mode")) == "memory");
+
+    conn = SQLiteConnection::create();
+    conn->open_file("test.sqlite?profile=bulk");
+    wassert(actual(conn->profile) == "bulk");
+    wassert(actual(pragma(*conn, "journal_mode")) == "wal");
+    wassert(actual(pragma(*conn, "synchronous")) == "1");
+    wassert(actual(pragma(*conn, "temp_store")) == "2");
+    wassert(actual(pragma(*conn, "cache_size")) == "-262144");
+    {
+        auto t = conn->transaction();
+        wassert(actual(pragma(*conn, "defer_foreign_keys")) == "1");
+        t->rollback();
+    }
+
+    conn = SQLiteConnection::create();
+    conn->open_file("test.sqlite?profile=reader");
+    wassert(actual(conn->profile) == "reader");
+    wassert(actual(pragma(*conn, "journal_mode")) == "wal");
+    wassert(actual(pragma(*conn, "temp_store")) == "2");
+
+    conn = SQLiteConnection::create();
+    conn->open_file("test.sqlite?profile=safe");
+    wassert(actual(conn->profile) == "safe");
+    wassert(actual(pragma(*conn, "synchronous")) == "2");
+    {
+        auto t = conn->transaction();
+        wassert(actual(pragma(*conn, "defer_foreign_keys")) == "0");
+        t->rollback();
+    }
+
+    conn = SQLiteConnection::create();
+    wassert_throws(wreport::error_consistency, conn->open_file("test.sqlite?profile=fast"));
+});
+
 }
 
 }
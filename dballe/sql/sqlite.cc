@@ -1,6 +1,7 @@
 #include "sqlite.h"
 #include "querybuf.h"
 #include "dballe/types.h"
+#include "dballe/core/string.h"
 #include <cstdarg>
 #include <cstdio>
 #include <cstdlib>
@@ -97,6 +98,18 @@ void SQLiteConnection::reopen()
     }
 
     size_t qs_begin = pathname.find('?');
+
+    if (qs_begin != string::npos)
+    {
+        string url(pathname);
+        string val;
+        if (url_pop_query_string(url, "profile", val))
+        {
+            if (val != "bulk" && val != "reader" && val != "safe")
+                error_consistency::throwf("unsupported SQLite profile '%s': valid profiles are bulk, reader and safe", val.c_str());
+            profile = val;
+        }
+    }
     int res;
     if (qs_begin == string::npos)
         res = sqlite3_open_v2(pathname.c_str(), &db, flags, nullptr);
@@ -170,9 +183,31 @@ void SQLiteConnection::init_after_connect()
     // set_autocommit(false);
 
     exec("PRAGMA foreign_keys = ON");
-    exec("PRAGMA journal_mode = MEMORY");
     exec("PRAGMA legacy_file_format = 0");
 
+    if (profile == "bulk")
+    {
+        // Trade durability for write throughput: the database stays
+        // consistent, but the last transactions may be lost on power failure.
+        // page_size only has effect on new databases, before WAL is enabled
+        exec("PRAGMA page_size = 8192");
+        exec("PRAGMA journal_mode = WAL");
+        exec("PRAGMA synchronous = NORMAL");
+        exec("PRAGMA cache_size = -262144");
+        exec("PRAGMA temp_store = MEMORY");
+        exec("PRAGMA mmap_size = 1073741824");
+    } else if (profile == "reader") {
+        // WAL allows reading while another connection is writing
+        exec("PRAGMA journal_mode = WAL");
+        exec("PRAGMA cache_size = -262144");
+        exec("PRAGMA temp_store = MEMORY");
+        exec("PRAGMA mmap_size = 1073741824");
+    } else if (profile == "safe") {
+        exec("PRAGMA journal_mode = WAL");
+        exec("PRAGMA synchronous = FULL");
+    } else
+        exec("PRAGMA journal_mode = MEMORY");
+
     if (getenv("DBA_INSECURE_SQLITE") != NULL)
         exec("PRAGMA synchronous = OFF");
 
@@ -280,6 +315,10 @@ std::unique_ptr<Transaction> SQLiteConnection::transaction(bool readonly)
 {
     // readonly is currently ignored on sqlite
     exec("BEGIN");
+    // Foreign key checks are deferred to commit time; the setting is reset at
+    // the end of each transaction
+    if (profile == "bulk")
+        exec("PRAGMA defer_foreign_keys = ON");
     return unique_ptr<Transaction>(new SQLiteTransaction(*this));
 }
 
@@ -348,6 +387,34 @@ void SQLiteConnection::drop_settings()
     drop_table_if_exists("dballe_settings");
 }
 
+void SQLiteConnection::add_datetime(Querybuf& qb, const Datetime& dt) const
+{
+    if (!integer_datetimes)
+        return Connection::add_datetime(qb, dt);
+    qb.appendf("%lld", (long long)datetime_to_seconds(dt));
+}
+
+int64_t SQLiteConnection::datetime_to_seconds(const Datetime& dt)
+{
+    static const int epoch = Date::calendar_to_julian(1970, 1, 1);
+    int64_t days = dt.to_julian() - epoch;
+    return days * 86400 + dt.hour * 3600 + dt.minute * 60 + dt.second;
+}
+
+Datetime SQLiteConnection::datetime_from_seconds(int64_t val)
+{
+    static const int epoch = Date::calendar_to_julian(1970, 1, 1);
+    // Round towards negative infinity, to handle datetimes before 1970
+    int64_t days = val / 86400;
+    int64_t secs = val % 86400;
+    if (secs < 0)
+    {
+        --days;
+        secs += 86400;
+    }
+    return Datetime::from_julian(epoch + days, secs / 3600, (secs / 60) % 60, secs % 60);
+}
+
 int SQLiteConnection::changes()
 {
     return sqlite3_changes(db);
@@ -384,6 +451,9 @@ SQLiteStatement::~SQLiteStatement()
 
 Datetime SQLiteStatement::column_datetime(int col)
 {
+    if (conn.integer_datetimes)
+        return SQLiteConnection::datetime_from_seconds(column_int64(col));
+
     Datetime res;
     string dt = column_string(col);
     sscanf(dt.c_str(), "%04hu-%02hhu-%02hhu %02hhu:%02hhu:%02hhu",
@@ -488,6 +558,17 @@ void SQLiteStatement::bind_val(int idx, unsigned short val)
 
 void SQLiteStatement::bind_val(int idx, const Datetime& val)
 {
+    if (conn.integer_datetimes)
+    {
+        // 23:59:60 would be stored as the first second of the next day
+        if (val.second == 60)
+            error_consistency::throwf("cannot store leap second %04d-%02d-%02d %02d:%02d:60 in a database with integer datetimes",
+                    val.year, val.month, val.day, val.hour, val.minute);
+        if (sqlite3_bind_int64(stm, idx, SQLiteConnection::datetime_to_seconds(val)) != SQLITE_OK)
+            throw error_sqlite(conn, "cannot bind an int64 (from Datetime) input column");
+        return;
+    }
+
     char* buf;
     int size = asprintf(&buf, "%04d-%02d-%02d %02d:%02d:%02d",
             val.year, val.month, val.day,
@@ -8,6 +8,7 @@
 #include <dballe/sql/sql.h>
 #include <sqlite3.h>
 #include <vector>
+#include <cstdint>
 #include <functional>
 
 namespace dballe {
@@ -57,6 +58,21 @@ protected:
     void reopen();
 
 public:
+    /**
+     * Store datetimes as integer seconds since 1970-01-01 00:00:00 instead
+     * of as text.
+     *
+     * This reflects how the open database stores datetimes, and affects how
+     * Datetime values are bound, read and added to queries.
+     */
+    bool integer_datetimes = false;
+
+    /**
+     * Tuning profile selected with the profile= URL option: empty for the
+     * default settings, or one of "bulk", "reader" or "safe".
+     */
+    std::string profile;
+
     SQLiteConnection(const SQLiteConnection&) = delete;
     SQLiteConnection(const SQLiteConnection&&) = delete;
     ~SQLiteConnection();
@@ -78,6 +94,7 @@ public:
     std::string get_setting(const std::string& key) override;
     void set_setting(const std::string& key, const std::string& value) override;
     void drop_settings() override;
+    void add_datetime(Querybuf& qb, const Datetime& dt) const override;
     void execute(const std::string& query) override;
     void explain(const std::string& query, FILE* out) override;
 
@@ -101,6 +118,12 @@ public:
     void exec(const std::string& query);
     void exec_nothrow(const std::string& query) noexcept;
 
+    /// Convert a Datetime to seconds since 1970-01-01 00:00:00
+    static int64_t datetime_to_seconds(const Datetime& dt);
+
+    /// Convert seconds since 1970-01-01 00:00:00 to a Datetime
+    static Datetime datetime_from_seconds(int64_t val);
+
 #if SQLITE_VERSION_NUMBER >= 3014000
     /**
      * Enable/change/disable SQLite tracing.
@@ -181,7 +204,10 @@ struct SQLiteStatement
         return std::vector<uint8_t>(val, val + size);
     }
 
-    /// Read the string value of a column and parse it as a Datetime
+    /**
+     * Read a datetime column, as text or as integer seconds according to
+     * SQLiteConnection::integer_datetimes
+     */
     Datetime column_datetime(int col);
 
     /// Check if a column has a NULL value (0-based)
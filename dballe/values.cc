@@ -140,8 +140,10 @@ void ValuesBase<Value>::merge(ValuesBase<Value>&& vals)
         operator=(std::move(vals));
     else
     {
-        for (const auto& vi: vals)
-            set(std::move(*vi));
+        // Move the Value objects, to hand over the Var pointers instead of
+        // copying the variables
+        for (auto& vi: vals.m_values)
+            set(std::move(vi));
         vals.clear();
     }
 }
@@ -6,6 +6,7 @@
 #include "dballe/db/db.h"
 
 #include <cstring>  // memset
+#include <vector>
 #include <limits.h>
 #include <float.h>
 #include "handles.h"
@@ -44,6 +45,14 @@ static inline int fromfortran(int val)
     return val == MISSING_INT ? fortran::API::missing_int : val;
 }
 
+/// Parse a varcode from a space padded Fortran string
+static Varcode varcode_fromfortran(const char* str, int len)
+{
+    while (len > 0 && (str[len - 1] == ' ' || str[len - 1] == 0))
+        --len;
+    return resolve_varcode(std::string(str, len));
+}
+
 /** @file
  * @ingroup fortran
  * Simplified interface for Dballe.
@@ -1098,6 +1107,56 @@ int idba_next_data(int handle, char* parameter, int parameter_len)
     }
 }
 
+/**
+ * Retrieve many values at once from the result of idba_query_data().
+ *
+ * This reads values like repeated calls to idba_next_data() and idba_enqd(),
+ * stopping when the station, date, level or time range change, or when \a max
+ * values have been read.
+ *
+ * After the call, idba_enq* functions and idba_query_attributes() refer to
+ * the last value that was read.
+ *
+ * Values of string variables cannot be read with this function.
+ *
+ * @param handle
+ *   Handle to a DB-All.e session
+ * @param max
+ *   Size of the \a varcodes and \a values arrays
+ * @retval varcodes
+ *   Array of strings that will contain the variable codes of the values
+ *   retrieved
+ * @param varcodes_len
+ *   Length of each string in \a varcodes
+ * @retval values
+ *   Array that will contain the values retrieved
+ * @retval count
+ *   Number of values retrieved, or 0 if there are no more results
+ * @return
+ *   The error indicator for the function
+ */
+int idba_next_data_array(int handle, int max, char* varcodes, int varcodes_len, double* values, int* count)
+{
+    try {
+        HSimple& h = hsimp.get(handle);
+        if (max <= 0)
+            error_consistency::throwf("next_data_array called with %d as the size of the output arrays", max);
+        std::vector<Varcode> codes(max);
+        *count = h.api->next_data_array(max, codes.data(), values);
+        char buf[8];
+        for (int i = 0; i < *count; ++i)
+        {
+            format_bcode(codes[i], buf);
+            fortran::API::to_fortran(buf, varcodes + i * varcodes_len, varcodes_len);
+            if (values[i] == fortran::API::missing_double)
+                values[i] = MISSING_DOUBLE;
+        }
+        return fortran::success();
+    } catch (error& e) {
+        return fortran::error(e);
+    }
+}
+
 /**
  * Insert a new value in the database.
  *
@@ -1127,6 +1186,48 @@ int idba_insert_data(int handle)
     }
 }
 
+/**
+ * Insert many values at once in the database.
+ *
+ * This works like calling idba_setd() for each value and then
+ * idba_insert_data(), with the overhead of a single function call.
+ *
+ * @param handle
+ *   Handle to a DB-All.e session
+ * @param count
+ *   Number of values to insert
+ * @param varcodes
+ *   Array of \a count variable codes, like \c "B12101"
+ * @param varcodes_len
+ *   Length of each string in \a varcodes
+ * @param values
+ *   Array of \a count values. A missing value unsets the corresponding
+ *   variable.
+ * @return
+ *   The error indicator for the function
+ */
+int idba_insert_data_array(int handle, int count, const char* varcodes, int varcodes_len, const double* values)
+{
+    try {
+        HSimple& h = hsimp.get(handle);
+        if (count < 0)
+            error_consistency::throwf("insert_data_array called with %d values", count);
+        std::vector<Varcode> codes;
+        std::vector<double> vals;
+        codes.reserve(count);
+        vals.reserve(count);
+        for (int i = 0; i < count; ++i)
+        {
+            codes.push_back(varcode_fromfortran(varcodes + i * varcodes_len, varcodes_len));
+            vals.push_back(values[i] == MISSING_DOUBLE ? fortran::API::missing_double : values[i]);
+        }
+        h.api->insert_data_array(count, codes.data(), vals.data());
+        return fortran::success();
+    } catch (error& e) {
+        return fortran::error(e);
+    }
+}
+
 /**
  * Remove from the database all values that match the query.
  *
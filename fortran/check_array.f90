@@ -0,0 +1,96 @@
+      program check_array
+
+! *****************************************
+! * Test suite for DBALLE Fortran bindings
+! *****************************************
+
+      use dbtest
+      use dballef
+
+      integer :: handle,idbhandle,ierr,count
+      character(len=6) :: varcodes(3)
+      real*8 :: values(3)
+      character(len=10) :: param, cval
+
+!     Database login
+      call dbinit(idbhandle)
+
+!     Open a session
+      ierr = idba_preparati(idbhandle,handle,"write","write","write")
+      call ensure_no_error("preparati")
+
+!     Clear the database
+      ierr = idba_scopa(handle, "")
+      call ensure_no_error("scopa")
+
+!     Insert three values, one of which is missing
+      ierr = idba_unsetall (handle)
+      ierr = idba_set (handle,"lat",44.5)
+      ierr = idba_set (handle,"lon",11.5)
+      ierr = idba_set (handle,"rep_memo","synop")
+      ierr = idba_setlevel (handle,103,2000,dba_mvi,dba_mvi)
+      ierr = idba_settimerange (handle,254,0,0)
+      ierr = idba_setdate (handle,2013,4,25,12,0,0)
+      call ensure_no_error("set context")
+
+      varcodes(1) = "B12101"
+      values(1) = 21.5D0
+      varcodes(2) = "B12103"
+      values(2) = 10.5D0
+      varcodes(3) = "B13003"
+      values(3) = DBA_MVD
+      ierr = idba_insert_data_array(handle, 3, varcodes, values)
+      call ensure_no_error("insert_data_array")
+
+!     Add a string variable with the same context
+      ierr = idba_unsetall (handle)
+      ierr = idba_set (handle,"lat",44.5)
+      ierr = idba_set (handle,"lon",11.5)
+      ierr = idba_set (handle,"rep_memo","synop")
+      ierr = idba_setlevel (handle,103,2000,dba_mvi,dba_mvi)
+      ierr = idba_settimerange (handle,254,0,0)
+      ierr = idba_setdate (handle,2013,4,25,12,0,0)
+      ierr = idba_setc (handle,"B20019","RA")
+      ierr = idba_insert_data(handle)
+      call ensure_no_error("insert_data string")
+
+!     Read them back
+      ierr = idba_unsetall (handle)
+      ierr = idba_query_data (handle, count)
+      call ensure_no_error("query_data")
+      call ensure("query_data count", count == 3)
+
+!     next_data_array stops before the string variable
+      ierr = idba_next_data_array(handle, 3, varcodes, values, count)
+      call ensure_no_error("next_data_array")
+      call ensure("next_data_array count", count == 2)
+      call ensure("next_data_array varcode 1", varcodes(1) == "B12101")
+      call ensure("next_data_array value 1", values(1) == 21.5D0)
+      call ensure("next_data_array varcode 2", varcodes(2) == "B12103")
+      call ensure("next_data_array value 2", values(2) == 10.5D0)
+
+!     and fails without skipping it, so it can be read with next_data
+      ierr = idba_next_data_array(handle, 3, varcodes, values, count)
+      call ensure("next_data_array on string fails", idba_error_code() /= 0)
+      ierr = idba_next_data(handle, param)
+      call ensure_no_error("next_data string")
+      call ensure("next_data string varcode", param == "B20019")
+      ierr = idba_enqc(handle, param, cval)
+      call ensure_no_error("enqc string")
+      call ensure("enqc string value", cval == "RA")
+
+      ierr = idba_next_data_array(handle, 3, varcodes, values, count)
+      call ensure_no_error("next_data_array at end")
+      call ensure("next_data_array count at end", count == 0)
+
+      ierr = idba_fatto(handle)
+      call ensure_no_error("fatto")
+
+      ierr = idba_arrivederci(idbhandle)
+      call ensure_no_error("arrivederci")
+
+      call exit (0)
+
+end program check_array
+
+include "check-utils.h"
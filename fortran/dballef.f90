@@ -438,6 +438,19 @@ INTERFACE
   END FUNCTION idba_next_data_orig
 END INTERFACE
 
+INTERFACE
+  FUNCTION idba_next_data_array_orig(handle, max, varcodes, varcodes_len, values, count) BIND(C,name='idba_next_data_array')
+  IMPORT
+  INTEGER(kind=c_int),VALUE :: handle
+  INTEGER(kind=c_int),VALUE :: max
+  CHARACTER(kind=c_char) :: varcodes(*)
+  INTEGER(kind=c_int),VALUE :: varcodes_len
+  REAL(kind=c_double) :: values(*)
+  INTEGER(kind=c_int) :: count
+  INTEGER(kind=c_int) :: idba_next_data_array_orig
+  END FUNCTION idba_next_data_array_orig
+END INTERFACE
+
 INTERFACE
   FUNCTION idba_insert_data(handle) BIND(C,name='idba_insert_data')
   IMPORT
@@ -446,6 +459,18 @@ INTERFACE
   END FUNCTION idba_insert_data
 END INTERFACE
 
+INTERFACE
+  FUNCTION idba_insert_data_array_orig(handle, count, varcodes, varcodes_len, values) BIND(C,name='idba_insert_data_array')
+  IMPORT
+  INTEGER(kind=c_int),VALUE :: handle
+  INTEGER(kind=c_int),VALUE :: count
+  CHARACTER(kind=c_char) :: varcodes(*)
+  INTEGER(kind=c_int),VALUE :: varcodes_len
+  REAL(kind=c_double) :: values(*)
+  INTEGER(kind=c_int) :: idba_insert_data_array_orig
+  END FUNCTION idba_insert_data_array_orig
+END INTERFACE
+
 INTERFACE
   FUNCTION idba_prendilo(handle) BIND(C,name='idba_prendilo')
   IMPORT
@@ -911,6 +936,29 @@ idba_dammelo = idba_next_data_orig(handle, param, LEN(param))
 
 END FUNCTION idba_dammelo
 
+FUNCTION idba_next_data_array(handle, max, varcodes, values, count)
+INTEGER(kind=c_int) :: handle
+INTEGER(kind=c_int) :: max
+CHARACTER(kind=c_char,len=*) :: varcodes(*)
+REAL(kind=c_double) :: values(*)
+INTEGER(kind=c_int) :: count
+INTEGER(kind=c_int) :: idba_next_data_array
+
+idba_next_data_array = idba_next_data_array_orig(handle, max, varcodes, LEN(varcodes), values, count)
+
+END FUNCTION idba_next_data_array
+
+FUNCTION idba_insert_data_array(handle, count, varcodes, values)
+INTEGER(kind=c_int) :: handle
+INTEGER(kind=c_int) :: count
+CHARACTER(kind=c_char,len=*) :: varcodes(*)
+REAL(kind=c_double) :: values(*)
+INTEGER(kind=c_int) :: idba_insert_data_array
+
+idba_insert_data_array = idba_insert_data_array_orig(handle, count, varcodes, LEN(varcodes), values)
+
+END FUNCTION idba_insert_data_array
+
 FUNCTION idba_next_attribute(handle, param)
 INTEGER(kind=c_int) :: handle
 CHARACTER(kind=c_char,len=*) :: param
@@ -13,6 +13,8 @@
 #include "dballe/msg/msg.h"
 #include "dballe/db/defs.h"
 #include "dballe/db/v7/cursor.h"
+#include "dballe/core/workers.h"
+#include "dballe/var.h"
 #include <algorithm>
 #include <wreport/bulletin.h>
 #include "utils/type.h"
@@ -807,11 +809,83 @@ struct export_to_file : MethKwargs<export_to_file<Impl>, Impl>
 };
 
 
+/**
+ * Decode all the messages of an ImporterFile and pass them to \a import.
+ *
+ * It must be called with the GIL released, and with the file of the
+ * ImporterFile marked as busy, so that other Python threads cannot use or
+ * close it meanwhile. Decoding takes wreport_tables_mutex(), like all other
+ * decoding done by the Python bindings. If decode_thread is true, messages
+ * are decoded in a separate thread, while the previous ones are imported.
+ */
+static void importer_file_foreach(dballe::File& file, const Importer& importer, bool decode_thread, std::function<void(const impl::Messages&)> import)
+{
+    if (!decode_thread)
+    {
+        while (auto binmsg = file.read())
+            import(importer.from_binary(binmsg));
+        return;
+    }
+
+    // Make sure that the variable table is loaded before the decoding thread
+    // and the database both start using it
+    varinfo(WR_VAR(0, 1, 1));
+    core::OrderedWorkers<BinaryMessage, impl::Messages> decoder(1, 0, [&](unsigned, BinaryMessage& binmsg) {
+        return importer.from_binary(binmsg);
+    });
+    while (auto binmsg = file.read())
+    {
+        if (decoder.full())
+            import(decoder.pop());
+        decoder.submit(std::move(binmsg));
+    }
+    while (!decoder.empty())
+        import(decoder.pop());
+}
+
+/**
+ * Import an ImporterFile into a DB, with a single transaction, or committing
+ * every \a commit_every bulletins.
+ */
+static void import_importer_file(dpy_DB* self, dpy_ImporterFile* impf, const DBImportOptions& opts, unsigned commit_every, bool decode_thread)
+{
+    dballe::File& file = impf->file->file->file();
+    FileBusy busy(*impf->file->file);
+    ReleaseGIL gil;
+    auto tr = self->db->transaction();
+    unsigned count = 0;
+    importer_file_foreach(file, *impf->importer->importer, decode_thread, [&](const impl::Messages& messages) {
+        tr->import_messages(messages, opts);
+        if (commit_every && ++count % commit_every == 0)
+        {
+            tr->commit();
+            tr = self->db->transaction();
+        }
+    });
+    tr->commit();
+}
+
+/// Import an ImporterFile into a Transaction
+static void import_importer_file(dpy_Transaction* self, dpy_ImporterFile* impf, const DBImportOptions& opts, unsigned commit_every, bool decode_thread)
+{
+    if (commit_every)
+    {
+        PyErr_SetString(PyExc_ValueError, "commit_every can only be used when importing into a DB, since transactions are committed by the caller");
+        throw PythonException();
+    }
+    dballe::File& file = impf->file->file->file();
+    FileBusy busy(*impf->file->file);
+    ReleaseGIL gil;
+    importer_file_foreach(file, *impf->importer->importer, decode_thread, [&](const impl::Messages& messages) {
+        self->db->import_messages(messages, opts);
+    });
+}
+
 template<typename Impl>
 struct import_messages : MethKwargs<import_messages<Impl>, Impl>
 {
     constexpr static const char* name = "import_messages";
-    constexpr static const char* signature = "messages: Union[dballe.Message, Sequence[dballe.Message], Iterable[dballe.Message], dballe.ImporterFile], report: str=None, import_attributes: bool=False, update_station: bool=False, overwrite: bool=False";
+    constexpr static const char* signature = "messages: Union[dballe.Message, Sequence[dballe.Message], Iterable[dballe.Message], dballe.ImporterFile], report: str=None, import_attributes: bool=False, update_station: bool=False, overwrite: bool=False, varlist: str=None, commit_every: int=0, decode_thread: bool=False";
     constexpr static const char* summary = "Import one or more Messages into the database.";
     constexpr static const char* doc = R"(
 :arg messages:
@@ -832,6 +906,18 @@ struct import_messages : MethKwargs<import_messages<Impl>, Impl>
                 database causes the import to fail.
 :arg varlist: if set to a string in the same format as the `varlist` query
               parameter, only imports data whose varcode is in the list.
+:arg commit_every: when importing a :class:`dballe.ImporterFile` into a
+                   :class:`dballe.DB`, commit every this number of bulletins.
+                   If 0 (default), all the file is imported in a single
+                   transaction.
+:arg decode_thread: when importing a :class:`dballe.ImporterFile`, decode
+                    bulletins in a separate thread while the previous ones are
+                    written to the database.
+
+A :class:`dballe.ImporterFile` is read, decoded and imported without holding
+the Python global interpreter lock: other threads can keep running, but any
+attempt to use or close the underlying :class:`dballe.File` while it is being
+imported raises RuntimeError.
 )";
 
     [[noreturn]] static void throw_typeerror()
@@ -842,15 +928,22 @@ struct import_messages : MethKwargs<import_messages<Impl>, Impl>
 
     static PyObject* run(Impl* self, PyObject* args, PyObject* kw)
     {
-        static const char* kwlist[] = {"messages", "report", "import_attributes", "update_station", "overwrite", "varlist", nullptr};
+        static const char* kwlist[] = {"messages", "report", "import_attributes", "update_station", "overwrite", "varlist", "commit_every", "decode_thread", nullptr};
         PyObject* obj = nullptr;
         const char* report = nullptr;
         int import_attributes = 0;
         int update_station = 0;
         int overwrite = 0;
         const char* varlist = nullptr;
-        if (!PyArg_ParseTupleAndKeywords(args, kw, "O|sppps", const_cast<char**>(kwlist), &obj, &report, &import_attributes, &update_station, &overwrite, &varlist))
+        int commit_every = 0;
+        int decode_thread = 0;
+        if (!PyArg_ParseTupleAndKeywords(args, kw, "O|spppsip", const_cast<char**>(kwlist), &obj, &report, &import_attributes, &update_station, &overwrite, &varlist, &commit_every, &decode_thread))
+            return nullptr;
+        if (commit_every < 0)
+        {
+            PyErr_SetString(PyExc_ValueError, "commit_every must be 0 or positive");
             return nullptr;
+        }
 
         try {
             auto opts = DBImportOptions::create();
@@ -869,12 +962,7 @@ struct import_messages : MethKwargs<import_messages<Impl>, Impl>
 
             if (dpy_ImporterFile_Check(obj))
             {
-                dpy_ImporterFile* impf = (dpy_ImporterFile*)obj;
-                while (auto binmsg = impf->file->file->file().read())
-                {
-                    auto messages = impf->importer->importer->from_binary(binmsg);
-                    self->db->import_messages(messages, *opts);
-                }
+                import_importer_file(self, (dpy_ImporterFile*)obj, *opts, commit_every, decode_thread);
                 Py_RETURN_NONE;
             }
 
@@ -83,6 +83,13 @@ Message exporter.
 
 This is the engine that can reconstruct a standard BUFR or CREX message from
 the contents of a :class:`dballe.Message`.
+
+Constructor: Exporter(encoding: str, template_name: str=None, centre: int=None,
+subcentre: int=None, application: int=None, compression: bool=False)
+
+:arg compression: use BUFR compression when exporting more than one message
+                  to a bulletin, if all their subsets contain the same sequence
+                  of variables
 )";
 
     GetSetters<> getsetters;
@@ -96,13 +103,14 @@ the contents of a :class:`dballe.Message`.
 
     static int _init(Impl* self, PyObject* args, PyObject* kw)
     {
-        static const char* kwlist[] = { "encoding", "template_name", "centre", "subcentre", "application", nullptr };
+        static const char* kwlist[] = { "encoding", "template_name", "centre", "subcentre", "application", "compression", nullptr };
         const char* encoding = nullptr;
         const char* template_name = nullptr;
         int centre = -1;
         int subcentre = -1;
         int application = -1;
-        if (!PyArg_ParseTupleAndKeywords(args, kw, "s|siii", const_cast<char**>(kwlist), &encoding, &template_name, &centre, &subcentre, &application))
+        int compression = 0;
+        if (!PyArg_ParseTupleAndKeywords(args, kw, "s|siiip", const_cast<char**>(kwlist), &encoding, &template_name, &centre, &subcentre, &application, &compression))
             return -1;
 
         try {
@@ -111,6 +119,7 @@ the contents of a :class:`dballe.Message`.
             if (centre != -1) opts.centre = centre;
             if (subcentre != -1) opts.subcentre = subcentre;
             if (application != -1) opts.application = application;
+            opts.compression = compression;
             self->exporter = Exporter::create(File::parse_encoding(encoding), opts).release();
         } DBALLE_CATCH_RETURN_INT
         return 0;
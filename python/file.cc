@@ -17,13 +17,21 @@ namespace python {
 
 FileWrapper::~FileWrapper() {}
 
+void FileWrapper::check_not_busy() const
+{
+    if (!busy) return;
+    PyErr_SetString(PyExc_RuntimeError, "the file is being read by another thread");
+    throw PythonException();
+}
+
 struct NamedFileWrapper : public FileWrapper
 {
     std::unique_ptr<dballe::File> m_file;
-    dballe::File& file() override { return *m_file; }
+    dballe::File& file() override { check_not_busy(); return *m_file; }
 
     void close() override
     {
+        check_not_busy();
         m_file->close();
     }
 
@@ -47,7 +55,7 @@ struct BaseFileObjFileWrapper : public FileWrapper
     std::unique_ptr<dballe::File> m_file;
     std::string filename;
 
-    dballe::File& file() override { return *m_file; }
+    dballe::File& file() override { check_not_busy(); return *m_file; }
 
     /**
      * Try to access the filename from the file object.
@@ -89,6 +97,7 @@ struct MemoryInFileWrapper : public BaseFileObjFileWrapper
 
     void close() override
     {
+        check_not_busy();
         m_file->close();
         data.clear();
     }
@@ -139,6 +148,7 @@ struct DupInFileWrapper : public BaseFileObjFileWrapper
 {
     void close() override
     {
+        check_not_busy();
         m_file->close();
     }
 
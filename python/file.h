@@ -20,8 +20,38 @@ public:
     FileWrapper& operator=(const FileWrapper&) = delete;
     FileWrapper& operator=(FileWrapper&&) = delete;
 
+    /**
+     * True while the file is being read with the GIL released.
+     *
+     * It is only accessed with the GIL held.
+     */
+    bool busy = false;
+
     virtual void close() = 0;
     virtual dballe::File& file() = 0;
+
+    /// Raise a Python exception if the file is being read by another thread
+    void check_not_busy() const;
+};
+
+/**
+ * Mark a FileWrapper as busy for the lifetime of this object.
+ *
+ * Create it with the GIL held, before releasing the GIL, so that it is
+ * destroyed after the GIL is acquired again.
+ */
+struct FileBusy
+{
+    FileWrapper& wrapper;
+
+    FileBusy(FileWrapper& wrapper) : wrapper(wrapper)
+    {
+        wrapper.check_not_busy();
+        wrapper.busy = true;
+    }
+    FileBusy(const FileBusy&) = delete;
+    FileBusy& operator=(const FileBusy&) = delete;
+    ~FileBusy() { wrapper.busy = false; }
 };
 
 }
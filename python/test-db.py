@@ -1,6 +1,7 @@
 #!/usr/bin/env python3
 import dballe
 import io
+import threading
 import datetime
 import unittest
 import warnings
@@ -615,6 +616,39 @@ class CommonDBTestMixin(DballeDBMixin):
         with self.deprecated_on_db():
             self.assertEqual(self.db.query_data({}).remaining, 371)
 
+    def test_import_importerfile_decode_thread(self):
+        importer = dballe.Importer("BUFR")
+        with dballe.File(test_pathname("bufr/vad.bufr")) as fp:
+            self.db.import_messages(importer.from_file(fp), decode_thread=True)
+        with self.deprecated_on_db():
+            self.assertEqual(self.db.query_data({}).remaining, 371)
+
+    def test_import_importerfile_concurrent_decode(self):
+        # Other Python threads can decode messages while an ImporterFile is
+        # being imported with the GIL released
+        expected = []
+        importer = dballe.Importer("BUFR")
+        with dballe.File(test_pathname("bufr/gts-acars2.bufr")) as fp:
+            for binmsg in fp:
+                expected.extend(importer.from_binary(binmsg))
+
+        decoded = []
+
+        def decode():
+            importer = dballe.Importer("BUFR")
+            with dballe.File(test_pathname("bufr/gts-acars2.bufr")) as fp:
+                for binmsg in fp:
+                    decoded.extend(importer.from_binary(binmsg))
+
+        thread = threading.Thread(target=decode)
+        with dballe.File(test_pathname("bufr/vad.bufr")) as fp:
+            thread.start()
+            self.db.import_messages(dballe.Importer("BUFR").from_file(fp), decode_thread=True)
+        thread.join()
+        self.assertEqual(len(decoded), len(expected))
+        with self.deprecated_on_db():
+            self.assertEqual(self.db.query_data({}).remaining, 371)
+
     def test_import_varlist(self):
         with self.transaction() as tr:
             tr.remove_all()
@@ -640,6 +674,13 @@ class CommonDBTestMixin(DballeDBMixin):
                     self.assertEqual(row["variable"].code, "B01011")
                     self.assertCountEqual((repr(x) for x in row["attrs"]), ["Var('B33007', 50)", "Var('B33036', 75)"])
 
+        with self.transaction() as tr:
+            for row in tr.query_data({"var": "B01011", "query": "attrs"}):
+                # Looking up the variable by code gives it with its
+                # attributes, also before "variable" or "attrs" are accessed
+                self.assertCountEqual(
+                        (repr(x) for x in row["B01011"].get_attrs()), ["Var('B33007', 50)", "Var('B33036', 75)"])
+
     def test_delete_by_context_id(self):
         # See issue #140
         records_to_del = []
@@ -904,6 +945,17 @@ class FullDBTestMixin(CommonDBTestMixin):
         with self.deprecated_on_db():
             self.assertEqual(len(list(self.db.query_data({"rep_memo": "synop"}))), 3)
 
+    def test_import_importerfile_commit_every(self):
+        importer = dballe.Importer("BUFR")
+        with dballe.File(test_pathname("bufr/vad.bufr")) as fp:
+            self.db.import_messages(importer.from_file(fp), commit_every=1, decode_thread=True)
+        with self.deprecated_on_db():
+            self.assertEqual(self.db.query_data({}).remaining, 371)
+
+        with self.assertRaises(ValueError):
+            with dballe.File(test_pathname("bufr/vad.bufr")) as fp:
+                self.db.import_messages(importer.from_file(fp), commit_every=-1)
+
     def test_transaction_creation_error(self):
         self.db.disappear()
         with self.assertRaisesRegex(OSError, r"^cannot compile query"):
@@ -957,6 +1009,13 @@ class TransactionTestMixin(object):
     def transaction(self):
         yield self.db
 
+    def test_import_importerfile_commit_every(self):
+        # Transactions are committed by the caller
+        importer = dballe.Importer("BUFR")
+        with dballe.File(test_pathname("bufr/vad.bufr")) as fp:
+            with self.assertRaises(ValueError):
+                self.db.import_messages(importer.from_file(fp), commit_every=10)
+
 #    def testConcurrentWrites(self):
 # This deadlocks
 #         insert_ids = self.db.insert_data({
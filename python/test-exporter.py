@@ -26,6 +26,18 @@ class TestExporter(MessageTestMixin, unittest.TestCase):
         with self.assertRaises(ValueError):
             exporter.to_binary([])
 
+    def test_compression(self):
+        msg = self.make_gts_acars_uk1_message()
+
+        exporter = dballe.Exporter("BUFR", compression=True)
+        binmsg = exporter.to_binary((msg, msg))
+        self.assertEqual(binmsg[:4], b"BUFR")
+        self.assertNotEqual(binmsg, dballe.Exporter("BUFR").to_binary((msg, msg)))
+
+        importer = dballe.Importer("BUFR")
+        msgs = importer.from_binary(dballe.BinaryMessage(binmsg, "BUFR"))
+        self.assertEqual(len(msgs), 2)
+
 
 if __name__ == "__main__":
     from testlib import main
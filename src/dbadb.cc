@@ -5,6 +5,10 @@
 #include <dballe/message.h>
 #include <dballe/msg/msg.h>
 #include <dballe/db/db.h>
+#include <dballe/db/v7/db.h>
+#include <dballe/db/v7/transaction.h>
+#include <dballe/db/v7/sqlite/driver.h>
+#include <dballe/sql/sql.h>
 #include <wreport/error.h>
 #include <wreport/utils/string.h>
 
@@ -34,6 +38,10 @@ int op_full_pseudoana = 0;
 int op_verbose = 0;
 int op_precise_import = 0;
 int op_wipe_disappear = 0;
+int op_jobs = 1;
+int op_subsets = 1;
+const char* op_commit_every = "";
+const char* op_checkpoint = "";
 
 
 struct poptOption grepTable[] = {
@@ -47,6 +55,9 @@ struct poptOption grepTable[] = {
         "match only messages that can be parsed", 0 },
     { "index", 0, POPT_ARG_STRING, &readeropts.index_filter, 0,
         "match messages with the index in the given range (ex.: 1-5,9,22-30)", "expr" },
+    { "header-datetime", 0, 0, &readeropts.header_datetime, 0,
+        "match the date and time of BUFR and CREX messages using the reference time in their header, without decoding them: "
+        "this is faster, but only correct if the reference time is the time of the observations", 0 },
     POPT_TABLEEND
 };
 
@@ -287,6 +298,14 @@ struct ImportCmd : public DatabaseCmd
             "import messages using precise contexts instead of standard ones", 0 });
         opts.push_back({ "varlist", 0, POPT_ARG_STRING, &op_varlist, 0,
             "only import variables with the given varcode(s)", "varlist" });
+        opts.push_back({ "jobs", 'j', POPT_ARG_INT, &op_jobs, 0,
+            "number of threads to use to decode messages (default: 1)", "num" });
+        opts.push_back({ "commit-every", 0, POPT_ARG_STRING, &op_commit_every, 0,
+            "commit the import every this many messages, or every this many seconds"
+            " if followed by 's' (default: only at the end)", "num[s]" });
+        opts.push_back({ "checkpoint", 0, POPT_ARG_STRING, &op_checkpoint, 0,
+            "after each commit, record in this file the position reached, and"
+            " resume from it if the file exists when starting", "fname" });
         opts.push_back({ NULL, 0, POPT_ARG_INCLUDE_TABLE, &grepTable, 0,
             "Options used to filter messages", 0 });
     }
@@ -297,6 +316,9 @@ struct ImportCmd : public DatabaseCmd
         poptGetArg(optCon);
         cmdline::Reader reader(readeropts);
         reader.verbose = op_verbose;
+        if (op_jobs < 1)
+            throw error_consistency("--jobs must be at least 1");
+        reader.jobs = op_jobs;
 
         // Configure the reader
         core::Query query;
@@ -317,12 +339,29 @@ struct ImportCmd : public DatabaseCmd
         if (op_varlist[0])
             resolve_varlist(op_varlist, [&](wreport::Varcode code) { opts->varlist.push_back(code); });
 
+        // Skip what would not be imported already while interpreting the
+        // input messages
+        reader.import_opts.varcodes = opts->varlist;
+        reader.import_opts.attributes = opts->import_attributes;
+
         auto db = connect();
 
         if (strcmp(op_report, "") != 0)
             opts->report = op_report;
 
         Dbadb dbadb(*db);
+        if (op_commit_every[0])
+        {
+            char* end;
+            unsigned long val = strtoul(op_commit_every, &end, 10);
+            if (end == op_commit_every || op_commit_every[0] == '-' || (*end && strcmp(end, "s") != 0))
+                error_consistency::throwf("cannot parse --commit-every=%s: expected a number of messages, or a number of seconds followed by 's'", op_commit_every);
+            if (*end)
+                dbadb.commit_seconds = val;
+            else
+                dbadb.commit_every = val;
+        }
+        dbadb.checkpoint = op_checkpoint;
         return dbadb.do_import(get_filenames(optCon), reader, *opts);
     }
 };
@@ -353,6 +392,11 @@ struct ExportCmd : public DatabaseCmd
             "template of the data in output (autoselect if not specified, 'list' gives a list)", "name" });
         opts.push_back({ "dump", 0, POPT_ARG_NONE, &op_dump, 0,
             "dump data to be encoded instead of encoding it", 0 });
+        opts.push_back({ "jobs", 'j', POPT_ARG_INT, &op_jobs, 0,
+            "number of threads to use to encode messages (default: 1)", "num" });
+        opts.push_back({ "subsets", 0, POPT_ARG_INT, &op_subsets, 0,
+            "encode up to this many consecutive messages using the same template as"
+            " subsets of one bulletin, compressed when possible (default: 1)", "num" });
     }
 
     int main(poptContext optCon) override
@@ -383,7 +427,12 @@ struct ExportCmd : public DatabaseCmd
         } else {
             Encoding type = File::parse_encoding(op_output_type);
             auto file = File::create(type, stdout, false, "w");
-            return dbadb.do_export(query, *file, op_output_template, forced_repmemo);
+            if (op_jobs < 1)
+                throw error_consistency("--jobs must be at least 1");
+            if (op_subsets < 1)
+                throw error_consistency("--subsets must be at least 1");
+            dbadb.subsets = op_subsets;
+            return dbadb.do_export(query, *file, op_output_template, forced_repmemo, op_jobs);
         }
     }
 };
@@ -420,6 +469,88 @@ struct DeleteCmd : public DatabaseCmd
     }
 };
 
+/// Change how a SQLite database stores datetimes
+struct ConvertDatetimesCmd : public DatabaseCmd
+{
+    ConvertDatetimesCmd()
+    {
+        names.push_back("convert-datetimes");
+        usage = "convert-datetimes [options] integer|text";
+        desc = "Change how a SQLite database stores datetimes";
+        longdesc =
+            "Rebuild the data table of a SQLite database storing datetimes "
+            "as integer seconds since the epoch, or as text. Nothing is done "
+            "if the database already uses the requested format.";
+    }
+
+    int main(poptContext optCon) override
+    {
+        // Throw away the command name
+        poptGetArg(optCon);
+
+        const char* format = poptGetArg(optCon);
+        if (!format)
+            dba_cmdline_error(optCon, "please specify integer or text");
+        bool integer;
+        if (strcmp(format, "integer") == 0)
+            integer = true;
+        else if (strcmp(format, "text") == 0)
+            integer = false;
+        else
+            dba_cmdline_error(optCon, "unsupported datetime format '%s': please specify integer or text", format);
+
+        auto db = connect();
+        auto v7db = dynamic_pointer_cast<db::v7::DB>(db);
+        auto driver = v7db ? dynamic_cast<db::v7::sqlite::Driver*>(&v7db->driver()) : nullptr;
+        if (!driver)
+            dba_cmdline_error(optCon, "datetimes can only be converted on SQLite databases");
+
+        auto t = v7db->conn->transaction();
+        driver->convert_datetimes(integer);
+        t->commit();
+        return 0;
+    }
+};
+
+/// Remove all the data of a month from a partitioned database
+struct DropPartitionCmd : public DatabaseCmd
+{
+    DropPartitionCmd()
+    {
+        names.push_back("drop-partition");
+        usage = "drop-partition [options] YYYY-MM";
+        desc = "Remove all the measured data of a month";
+        longdesc =
+            "Drop the partition holding the measured data of the given month. "
+            "This only works on databases created with ?partition_data=yes, "
+            "and takes the same time regardless of the amount of data "
+            "removed. Stations left without data can be removed with "
+            "dbadb cleanup.";
+    }
+
+    int main(poptContext optCon) override
+    {
+        // Throw away the command name
+        poptGetArg(optCon);
+
+        const char* month_str = poptGetArg(optCon);
+        if (!month_str)
+            dba_cmdline_error(optCon, "please specify the month to remove, as YYYY-MM");
+        int year, month;
+        char extra;
+        if (sscanf(month_str, "%d-%d%c", &year, &month, &extra) != 2 || month < 1 || month > 12)
+            dba_cmdline_error(optCon, "invalid month '%s': please use YYYY-MM", month_str);
+
+        auto db = connect();
+        auto tr = dynamic_pointer_cast<db::v7::Transaction>(db->transaction());
+        if (!tr)
+            dba_cmdline_error(optCon, "partitions are not supported on this database");
+        tr->drop_partition(year, month);
+        tr->commit();
+        return 0;
+    }
+};
+
 struct InfoCmd : public DatabaseCmd
 {
     InfoCmd()
@@ -462,6 +593,8 @@ int main (int argc, const char* argv[])
     dbadb.add_subcommand(new ImportCmd);
     dbadb.add_subcommand(new ExportCmd);
     dbadb.add_subcommand(new DeleteCmd);
+    dbadb.add_subcommand(new ConvertDatetimesCmd);
+    dbadb.add_subcommand(new DropPartitionCmd);
     dbadb.add_subcommand(new InfoCmd);
 
     return dbadb.main(argc, argv);
@@ -65,6 +65,9 @@ struct poptOption grepTable[] = {
         "match only messages that can be parsed", 0 },
     { "index", 0, POPT_ARG_STRING, &readeropts.index_filter, 0,
         "match messages with the index in the given range (ex.: 1-5,9,22-30)", "expr" },
+    { "header-datetime", 0, 0, &readeropts.header_datetime, 0,
+        "match the date and time of BUFR and CREX messages using the reference time in their header, without decoding them: "
+        "this is faster, but only correct if the reference time is the time of the observations", 0 },
     POPT_TABLEEND
 };
 